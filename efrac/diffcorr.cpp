@@ -1,4 +1,5 @@
 #include "diffcorr.h"
+#include "profiler.h"
 
 extern "C"
 {
@@ -171,6 +172,7 @@ void diff_corr_kernel(mpfr::mpreal &delta, std::vector<mpfr::mpreal> &num,
         return;
     }
 
+    Profiler::instance().count("lp_solves");
     rval = QSexact_solver(p, nullptr, nullptr, nullptr, DUAL_SIMPLEX, &status);
 
     if (rval)
@@ -378,6 +380,7 @@ void diff_corr_kernel(mpfr::mpreal &delta, std::vector<mpfr::mpreal> &num,
         return;
     }
 
+    Profiler::instance().count("lp_solves");
     rval = QSexact_solver(p, nullptr, nullptr, nullptr, DUAL_SIMPLEX, &status);
 
     if (rval)
@@ -436,6 +439,7 @@ void diff_corr(std::vector<mpfr::mpreal> &num, std::vector<mpfr::mpreal> &den,
                std::function<mpfr::mpreal(mpfr::mpreal)> &w,
                mpfr::mpreal const &d1, mpfr::mpreal const &d2)
 {
+    ProfileScope profile("diff_corr");
     if (num.empty() && den.empty())
     {
         for (int i{0}; i < type.first; ++i)
@@ -524,6 +528,7 @@ void diff_corr(std::vector<mpfr::mpreal> &num, std::vector<mpfr::mpreal> &den,
                std::function<mpfr::mpreal(mpfr::mpreal)> &f,
                std::function<mpfr::mpreal(mpfr::mpreal)> &w)
 {
+    ProfileScope profile("diff_corr");
     if (num.empty() && den.empty())
     {
         for (int i{0}; i < type.first; ++i)
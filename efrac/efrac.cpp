@@ -1,4 +1,5 @@
 #include "efrac.h"
+#include "profiler.h"
 
 
 void applyRemez(std::vector<mpfr::mpreal> &num,
@@ -52,8 +53,10 @@ bool efrac(mpfr::mpreal & error,
            mpfr::mpreal &d2,
            std::pair<int, int> &type,
            std::pair<mpfr::mpreal, mpfr::mpreal> &dom,
-           mpfr::mpreal &scalingFactor)
+           mpfr::mpreal &scalingFactor,
+           mpfr::mpreal *errorArgMax)
 {
+    ProfileScope profile("efrac");
     // diffcor + remez
     bool valid = true;
     eremez(num, den, dom, type, f, w, d1, d2);
@@ -296,6 +299,9 @@ bool efrac(mpfr::mpreal & error,
     infnorm(erHNorm, erH, dom);
     std::cout << "Lattice-based error estimation  = " << erHNorm.second << std::endl;
     error = erHNorm.second;
+    // the point where the error is the largest, worth testing in hardware
+    if (errorArgMax)
+        *errorArgMax = erHNorm.first;
 
     // plotFunc(testFile2, erH, dom.first, dom.second);
     return valid;
@@ -39,4 +39,5 @@ bool efrac(mpfr::mpreal &error,
             mpfr::mpreal &d2,
             std::pair<int, int> &type,
             std::pair<mpfr::mpreal, mpfr::mpreal> &dom,
-            mpfr::mpreal &scalingFactor);
+            mpfr::mpreal &scalingFactor,
+            mpfr::mpreal *errorArgMax = nullptr);
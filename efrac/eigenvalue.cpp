@@ -3,6 +3,7 @@
 //
 
 #include "eigenvalue.h"
+#include "profiler.h"
 #include <algorithm>
 
 void balance(MatrixXq &A)
@@ -97,6 +98,7 @@ void generateColleagueMatrix1stKind(MatrixXq &C, std::vector<mpfr::mpreal> &a,
 
 void determineEigenvalues(VectorXcq &eigenvalues, MatrixXq &C)
 {
+    Profiler::instance().count("eigen_solves");
     Eigen::EigenSolver<MatrixXq> es(C);
     eigenvalues = es.eigenvalues();
 }
@@ -277,6 +279,7 @@ void generateColleagueMatrix2ndKind(MatrixXd &C,
 void determineEigenvalues(VectorXcd &eigenvalues,
                           MatrixXd &C)
 {
+    Profiler::instance().count("eigen_solves");
     Eigen::EigenSolver<MatrixXd> es(C);
     eigenvalues = es.eigenvalues();
 }
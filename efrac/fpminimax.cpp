@@ -1,4 +1,5 @@
 #include "fpminimax.h"
+#include "profiler.h"
 #include <gmpxx.h>
 #include <fstream>
 #include <sstream>
@@ -180,6 +181,7 @@ void fpminimaxKernel(std::vector<mpfr::mpreal> &lllCoeffs,
                      std::vector<std::function<mpfr::mpreal(mpfr::mpreal)>> &basisFuncs,
                      mp_prec_t prec)
 {
+    ProfileScope profile("fpminimaxKernel");
     using mpfr::mpreal;
     mp_prec_t prevPrec = mpreal::get_default_prec();
     mpreal::set_default_prec(prec);
@@ -199,6 +201,7 @@ void fpminimaxKernel(std::vector<mpfr::mpreal> &lllCoeffs,
     applyKannanEmbedding(B, t);
 
     fplll::ZZ_mat<mpz_t> U(B.get_rows(), B.get_cols());
+    Profiler::instance().count("lll_calls");
     fplll::lll_reduction(B, U, 0.99, 0.51);
     //fplll::bkzReduction(B, U, 8);
     int xdp1 = (int)mpz_get_si(U(U.get_rows() - 1,
@@ -0,0 +1,242 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Hierarchical timers and event counters for the whole generator
+ * (efrac, FloPoCo and the emethodHW driver).
+ *
+ * The implementation is in this header only, so that FloPoCo can use it
+ * without linking against efrac: the registry is a function-local static of
+ * an inline function, of which there is a single instance in the program.
+ *
+ * Profiling is off by default; when it is off, the scopes and the counters
+ * only test a flag.
+ */
+class Profiler
+{
+public:
+    static Profiler &instance()
+    {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    void enable(bool e = true) { enabled = e; }
+    bool isEnabled() const { return enabled; }
+
+    // add increment to the counter called name
+    void count(std::string const &name, std::int64_t increment = 1)
+    {
+        if (!enabled)
+            return;
+        std::lock_guard<std::mutex> lock(mtx);
+        counters[name] += increment;
+    }
+
+    // record a measured quantity (an error, an area estimate...), replacing its previous value
+    void setValue(std::string const &name, double value)
+    {
+        if (!enabled)
+            return;
+        std::lock_guard<std::mutex> lock(mtx);
+        values[name] = value;
+    }
+
+    // open a timer, nested in the timer currently open in this thread
+    void begin(std::string const &name)
+    {
+        if (!enabled)
+            return;
+        std::vector<Frame> &s = stack();
+        Frame frame;
+        frame.path = s.empty() ? name : s.back().path + "/" + name;
+        frame.name = name;
+        frame.start = now();
+        s.push_back(frame);
+    }
+
+    // close the timer opened last in this thread
+    void end()
+    {
+        std::vector<Frame> &s = stack();
+        if (s.empty())
+            return;
+        std::int64_t stop = now();
+        Frame frame = s.back();
+        s.pop_back();
+
+        std::lock_guard<std::mutex> lock(mtx);
+        Timer &timer = timers[frame.path];
+        timer.calls++;
+        timer.totalNs += stop - frame.start;
+        if (events.size() < maxEvents)
+        {
+            Event event;
+            event.name = frame.name;
+            event.path = frame.path;
+            event.tid = threadNumber();
+            event.start = frame.start;
+            event.duration = stop - frame.start;
+            events.push_back(event);
+        }
+        else
+            droppedEvents++;
+    }
+
+    // the timers, as {"path": {"calls": , "total_ms": }}, the counters and the values
+    void writeJSONReport(std::string const &filename)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::ofstream out(filename.c_str());
+        out << "{\n  \"timers\": {";
+        bool first = true;
+        for (auto const &it : timers)
+        {
+            out << (first ? "\n" : ",\n") << "    \"" << escape(it.first)
+                << "\": {\"calls\": " << it.second.calls
+                << ", \"total_ms\": " << it.second.totalNs / 1e6 << "}";
+            first = false;
+        }
+        out << "\n  },\n  \"counters\": {";
+        first = true;
+        for (auto const &it : counters)
+        {
+            out << (first ? "\n" : ",\n") << "    \"" << escape(it.first)
+                << "\": " << it.second;
+            first = false;
+        }
+        out << "\n  },\n  \"values\": {";
+        first = true;
+        for (auto const &it : values)
+        {
+            out << (first ? "\n" : ",\n") << "    \"" << escape(it.first)
+                << "\": " << it.second;
+            first = false;
+        }
+        out << "\n  },\n  \"dropped_trace_events\": " << droppedEvents << "\n}\n";
+    }
+
+    // the closed timers, in the Trace Event Format of chrome://tracing
+    void writeChromeTrace(std::string const &filename)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::ofstream out(filename.c_str());
+        out << "{\"traceEvents\": [";
+        for (std::size_t i{0u}; i < events.size(); ++i)
+        {
+            Event const &e = events[i];
+            out << (i == 0u ? "\n" : ",\n")
+                << "{\"name\": \"" << escape(e.name) << "\", \"cat\": \"generator\", \"ph\": \"X\""
+                << ", \"ts\": " << (e.start - origin) / 1e3 << ", \"dur\": " << e.duration / 1e3
+                << ", \"pid\": 1, \"tid\": " << e.tid
+                << ", \"args\": {\"path\": \"" << escape(e.path) << "\"}}";
+        }
+        out << "\n],\n\"displayTimeUnit\": \"ms\"}\n";
+    }
+
+private:
+    struct Frame
+    {
+        std::string path;
+        std::string name;
+        std::int64_t start;
+    };
+
+    struct Timer
+    {
+        Timer() : calls(0), totalNs(0) {}
+        std::int64_t calls;
+        std::int64_t totalNs;
+    };
+
+    struct Event
+    {
+        std::string name;
+        std::string path;
+        int tid;
+        std::int64_t start;
+        std::int64_t duration;
+    };
+
+    Profiler() : enabled(false), droppedEvents(0), origin(now()) {}
+
+    static std::int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    static std::vector<Frame> &stack()
+    {
+        static thread_local std::vector<Frame> s;
+        return s;
+    }
+
+    // small thread numbers, in order of appearance; mtx must be held
+    int threadNumber()
+    {
+        std::thread::id id = std::this_thread::get_id();
+        auto it = threadNumbers.find(id);
+        if (it != threadNumbers.end())
+            return it->second;
+        int n = (int)threadNumbers.size() + 1;
+        threadNumbers[id] = n;
+        return n;
+    }
+
+    static std::string escape(std::string const &s)
+    {
+        std::string r;
+        for (char c : s)
+        {
+            if (c == '"' || c == '\\')
+                r += '\\';
+            r += c;
+        }
+        return r;
+    }
+
+    // the trace keeps the first events only, the timers count them all
+    static const std::size_t maxEvents = 1000000u;
+
+    bool enabled;
+    std::mutex mtx;
+    std::map<std::string, Timer> timers;
+    std::map<std::string, std::int64_t> counters;
+    std::map<std::string, double> values;
+    std::vector<Event> events;
+    std::size_t droppedEvents;
+    std::map<std::thread::id, int> threadNumbers;
+    std::int64_t origin;
+};
+
+// times the enclosing block under the given name
+class ProfileScope
+{
+public:
+    explicit ProfileScope(std::string const &name) : active(Profiler::instance().isEnabled())
+    {
+        if (active)
+            Profiler::instance().begin(name);
+    }
+    ~ProfileScope()
+    {
+        if (active)
+            Profiler::instance().end();
+    }
+
+private:
+    bool active;
+};
+
+#endif
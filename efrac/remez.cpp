@@ -2,6 +2,7 @@
 #include "diffcorr.h"
 #include "cheby.h"
 #include "eigenvalue.h"
+#include "profiler.h"
 
 void domSplit(std::vector<std::pair<mpfr::mpreal, mpfr::mpreal>> &doms,
               std::pair<mpfr::mpreal, mpfr::mpreal> const &dom, std::size_t N)
@@ -19,6 +20,7 @@ void infnorm(std::pair<mpfr::mpreal, mpfr::mpreal> &norm,
              std::function<mpfr::mpreal(mpfr::mpreal)> &f,
              std::pair<mpfr::mpreal, mpfr::mpreal> const &dom)
 {
+    ProfileScope profile("infnorm");
     mpfr::mpreal ia = -1;
     mpfr::mpreal ib = 1;
     std::size_t maxDegree = 8u;
@@ -71,6 +73,7 @@ void eremez(std::vector<mpfr::mpreal> &num, std::vector<mpfr::mpreal> &den,
             std::function<mpfr::mpreal(mpfr::mpreal)> &w,
             mpfr::mpreal const &d1, mpfr::mpreal const &d2)
 {
+    ProfileScope profile("eremez");
     std::vector<mpfr::mpreal> x;
     generateChebyshevPoints(x, type.first + type.second + 2);
     changeOfVariable(x, x, dom);
@@ -142,6 +145,7 @@ void remez(std::vector<mpfr::mpreal> &num, std::vector<mpfr::mpreal> &den,
             std::function<mpfr::mpreal(mpfr::mpreal)> &f,
             std::function<mpfr::mpreal(mpfr::mpreal)> &w)
 {
+    ProfileScope profile("remez");
     std::vector<mpfr::mpreal> x;
     generateChebyshevPoints(x, type.first + type.second + 2);
     changeOfVariable(x, x, dom);
@@ -3,6 +3,7 @@
 //
 
 #include "shuntingyard.h"
+#include "profiler.h"
 #include <stack>
 #include <queue>
 #include <iostream>
@@ -39,6 +40,7 @@ shuntingyard::shuntingyard()
 mpfr::mpreal shuntingyard::evaluate(std::vector<std::string> &tokens,
                                     mpfr::mpreal x) const
 {
+    Profiler::instance().count("function_evaluations");
 
     std::stack<std::pair<std::string, int>> operatorStack;
     std::stack<mpfr::mpreal> operandStack;
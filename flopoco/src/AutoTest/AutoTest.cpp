@@ -1,11 +1,18 @@
 #include "AutoTest.hpp"
 #include "../UserInterface.hpp"
+#include "../TestBenches/CoSimulation.hpp"
 
 #include <vector>
 #include <map>
 #include <set>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
 
 namespace flopoco
 {
@@ -14,10 +21,14 @@ namespace flopoco
 	{
 		string opName;
 		bool testDependences;
+		bool inProcess;
+		string report;
 		UserInterface::parseBoolean(args, "Dependences", &testDependences);
 		UserInterface::parseString(args, "Operator", &opName);
+		UserInterface::parseBoolean(args, "InProcess", &inProcess);
+		UserInterface::parseString(args, "Report", &report);
 
-		AutoTest AutoTest(opName,testDependences);
+		AutoTest AutoTest(opName,testDependences,inProcess,target,report);
 
 		return nullptr;
 	}
@@ -29,15 +40,18 @@ namespace flopoco
 			"AutoTest",
 			"", //seeAlso
 			"Operator(string): name of the operator to test, All if we need to test all the operators;\
-			Dependences(bool)=false: test the operator's dependences;",
-			"",
+			Dependences(bool)=false: test the operator's dependences;\
+			InProcess(bool)=false: build the operators in this process, and check them with their bit-accurate model instead of an HDL simulator;\
+			Report(string)=none: with InProcess, the report file, in JSON if its name ends with .json, in JUnit XML otherwise;",
+			"With InProcess=true, the co-simulations run on the threads given by the threads option. The operators without a bit-accurate model (see Operator::simulateBitAccurate) are only built, and reported as skipped.",
 			AutoTest::parseArguments
 			) ;
 	}
 
-	AutoTest::AutoTest(string opName, bool testDependences)
+	AutoTest::AutoTest(string opName, bool testDependences, bool inProcess, Target* target, string report)
 	{
-		system("src/AutoTest/initTests.sh");
+		if(!inProcess)
+			system("src/AutoTest/initTests.sh");
 
 		OperatorFactoryPtr opFact;	
 		string commandLine;
@@ -147,6 +161,12 @@ namespace flopoco
 		}
 
 
+		if(inProcess)
+		{
+			int failures = runInProcess(target, testedOperator, doUnitTest, doRandomTest, report);
+			cout << "Tests are finished" << endl;
+			exit(failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+		}
 
 		// For each tested Operator, we run a number of tests defined in the Operator's unitTest method
 		for(itOperator = testedOperator.begin(); itOperator != testedOperator.end(); ++itOperator)
@@ -332,4 +352,277 @@ namespace flopoco
 
 		return testBench;
 	}
+
+	int AutoTest::runInProcess(Target* target, set<string> &testedOperator, bool doUnitTest, bool doRandomTest, string report)
+	{
+		vector<TestResult> results;
+		vector<CoSimulation*> cosims;
+		OperatorFactoryPtr opFact;
+		TestList unitTestList;
+
+		if(target == NULL)
+			throw(string("AutoTest: the in-process tests need a target"));
+
+		// First build the operators and their test cases, one at a time
+		for(auto itOperator = testedOperator.begin(); itOperator != testedOperator.end(); ++itOperator)
+		{
+			opFact = UserInterface::getFactoryByName(*itOperator);
+
+			unitTestList.clear();
+			if(doUnitTest)
+				unitTestList = opFact->unitTestGenerator(-1);
+			if(doRandomTest)
+			{
+				TestList randomTestList = opFact->unitTestGenerator(0);
+				unitTestList.insert(unitTestList.end(), randomTestList.begin(), randomTestList.end());
+			}
+			if(unitTestList.size() == 0)
+			{
+				cout << "No unitTest method defined for " << *itOperator << endl;
+				continue;
+			}
+
+			for(auto itUnitTestList = unitTestList.begin(); itUnitTestList != unitTestList.end(); ++itUnitTestList)
+			{
+				TestResult result;
+				vector<string> args;
+				// the exhaustive tests (n=-2) of the scripts are replaced by random ones
+				int n = 1000;
+				// the pipeline option, which is a generic one, is applied to the target for this test only
+				bool pipelined = target->isPipelined();
+
+				args.push_back(*itOperator);
+				for(auto itUnitTest = (*itUnitTestList).begin(); itUnitTest != (*itUnitTestList).end(); ++itUnitTest)
+				{
+					if((*itUnitTest).first == "TestBench n=")
+						n = stoi((*itUnitTest).second);
+					else if((*itUnitTest).first == "pipeline")
+						target->setPipelined((*itUnitTest).second == "true" || (*itUnitTest).second == "1");
+					if((*itUnitTest).first != "TestBench n=")
+						args.push_back((*itUnitTest).first + "=" + (*itUnitTest).second);
+				}
+				if(n <= 0)
+					n = 1000;
+
+				result.opName = *itOperator;
+				for(unsigned i=1; i<args.size(); i++)
+					result.parameters += (i > 1 ? " " : "") + args[i];
+				result.nbTestCases = 0;
+				result.mismatches = 0;
+
+				chrono::steady_clock::time_point start = chrono::steady_clock::now();
+				CoSimulation* cosim = NULL;
+				try
+				{
+					OperatorPtr op = opFact->parseArguments(target, args);
+					if(op == NULL)
+					{
+						result.status = "skipped";
+						result.message = "the factory creates no operator";
+					}
+					else if(!op->hasBitAccurateModel())
+					{
+						result.status = "skipped";
+						result.message = "built, but no bit-accurate model: it needs an HDL simulator";
+					}
+					else
+					{
+						cosim = new CoSimulation(op, n);
+						result.status = "passed";
+					}
+				}
+				catch(std::string &s)
+				{
+					result.status = "error";
+					result.message = s;
+				}
+				catch(std::exception &s)
+				{
+					result.status = "error";
+					result.message = s.what();
+				}
+				result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+				target->setPipelined(pipelined);
+
+				results.push_back(result);
+				cosims.push_back(cosim);
+			}
+		}
+
+		// Then run the co-simulations on several threads, one test at a time per thread
+		int nbThreads = UserInterface::getNumberOfThreads();
+		atomic<unsigned> nextTest(0);
+		mutex m;
+
+		auto worker = [&]() {
+			while(true) {
+				unsigned i = nextTest++;
+				if(i >= results.size())
+					break;
+				if(cosims[i] == NULL)
+					continue;
+				chrono::steady_clock::time_point start = chrono::steady_clock::now();
+				TestResult result = results[i];
+				try
+				{
+					result.mismatches = cosims[i]->run(1);
+					result.nbTestCases = cosims[i]->getNumberOfTestCases();
+					result.unchecked = cosims[i]->getUncheckedOutputs();
+					if(result.mismatches > 0)
+					{
+						result.status = "failed";
+						result.message = to_string(result.mismatches) + " mismatching test case(s)";
+					}
+				}
+				catch(std::string &s)
+				{
+					result.status = "error";
+					result.message = s;
+				}
+				catch(std::exception &s)
+				{
+					result.status = "error";
+					result.message = s.what();
+				}
+				catch(...)
+				{
+					result.status = "error";
+					result.message = "unknown exception";
+				}
+				result.seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+				delete cosims[i];
+				lock_guard<mutex> lock(m);
+				results[i] = result;
+			}
+		};
+
+		vector<thread> workers;
+		for(int t = 0; t < (nbThreads < 1 ? 1 : nbThreads); t++)
+			workers.push_back(thread(worker));
+		for(auto& w: workers)
+			w.join();
+
+		// Summary and report
+		int failures = 0, skipped = 0;
+		for(auto& result: results)
+		{
+			if((result.status == "failed") || (result.status == "error"))
+			{
+				failures++;
+				cout << result.status << ": " << result.opName << " " << result.parameters << ": " << result.message << endl;
+			}
+			else if(result.status == "skipped")
+				skipped++;
+		}
+		cout << results.size() << " test(s): " << results.size()-failures-skipped << " passed, "
+				 << failures << " failed, " << skipped << " skipped" << endl;
+		int partial = 0;
+		for(auto& result: results)
+			partial += (result.unchecked != "");
+		if(partial > 0)
+			cout << partial << " test(s) with outputs not checked, emulate() giving no expected value for them (see the report)" << endl;
+
+		if(report != "none")
+		{
+			if((report.size() >= 5) && (report.substr(report.size()-5) == ".json"))
+				writeJSONReport(report, results);
+			else
+				writeJUnitReport(report, results);
+			cout << "Test report written to " << report << endl;
+		}
+
+		return failures;
+	}
+
+	// the special characters of XML and JSON strings
+	static string escapeXML(string s)
+	{
+		string r;
+		for(char c : s)
+		{
+			if(c == '&') r += "&amp;";
+			else if(c == '<') r += "&lt;";
+			else if(c == '>') r += "&gt;";
+			else if(c == '"') r += "&quot;";
+			else r += c;
+		}
+		return r;
+	}
+
+	static string escapeJSON(string s)
+	{
+		string r;
+		for(char c : s)
+		{
+			if(c == '"' || c == '\\') r += '\\';
+			if(c == '\n') r += "\\n";
+			else r += c;
+		}
+		return r;
+	}
+
+	void AutoTest::writeJUnitReport(string fileName, vector<TestResult> &results)
+	{
+		// one testsuite per operator, the results being grouped by operator
+		map<string, vector<TestResult*>> suites;
+		for(auto& result: results)
+			suites[result.opName].push_back(&result);
+
+		ofstream file(fileName.c_str(), ios::out);
+		file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << endl;
+		file << "<testsuites name=\"FloPoCo AutoTest\" tests=\"" << results.size() << "\">" << endl;
+		for(auto& suite: suites)
+		{
+			int failures = 0, errors = 0, skipped = 0;
+			double seconds = 0;
+			for(auto result: suite.second)
+			{
+				failures += (result->status == "failed");
+				errors += (result->status == "error");
+				skipped += (result->status == "skipped");
+				seconds += result->seconds;
+			}
+			file << "  <testsuite name=\"" << escapeXML(suite.first) << "\" tests=\"" << suite.second.size()
+					 << "\" failures=\"" << failures << "\" errors=\"" << errors << "\" skipped=\"" << skipped
+					 << "\" time=\"" << seconds << "\">" << endl;
+			for(auto result: suite.second)
+			{
+				file << "    <testcase classname=\"" << escapeXML(suite.first) << "\" name=\"" << escapeXML(result->parameters)
+						 << "\" time=\"" << result->seconds << "\">";
+				if(result->status == "failed")
+					file << "<failure message=\"" << escapeXML(result->message) << "\"/>";
+				else if(result->status == "error")
+					file << "<error message=\"" << escapeXML(result->message) << "\"/>";
+				else if(result->status == "skipped")
+					file << "<skipped message=\"" << escapeXML(result->message) << "\"/>";
+				if(result->unchecked != "")
+					file << "<system-out>outputs not checked: " << escapeXML(result->unchecked) << "</system-out>";
+				file << "</testcase>" << endl;
+			}
+			file << "  </testsuite>" << endl;
+		}
+		file << "</testsuites>" << endl;
+		file.close();
+	}
+
+	void AutoTest::writeJSONReport(string fileName, vector<TestResult> &results)
+	{
+		ofstream file(fileName.c_str(), ios::out);
+		file << "[";
+		for(unsigned i=0; i<results.size(); i++)
+		{
+			TestResult &result = results[i];
+			file << (i == 0 ? "\n" : ",\n")
+					 << "  {\"operator\": \"" << escapeJSON(result.opName) << "\""
+					 << ", \"parameters\": \"" << escapeJSON(result.parameters) << "\""
+					 << ", \"status\": \"" << result.status << "\""
+					 << ", \"message\": \"" << escapeJSON(result.message) << "\""
+					 << ", \"test_cases\": " << result.nbTestCases
+					 << ", \"mismatches\": " << result.mismatches
+					 << ", \"unchecked_outputs\": \"" << escapeJSON(result.unchecked) << "\""
+					 << ", \"time_s\": " << result.seconds << "}";
+		}
+		file << "\n]" << endl;
+		file.close();
+	}
 };
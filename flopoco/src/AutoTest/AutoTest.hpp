@@ -18,12 +18,48 @@ namespace flopoco{
 
 		static void registerFactory();
 
-		AutoTest(string opName, bool testDependences = false);
+		/**
+		 * Runs the tests of the operator(s), then exits
+		 * @param opName the operator to test, or All, AllUnitTest, AllRandomTest
+		 * @param testDependences also test the operators it depends on
+		 * @param inProcess build the operators through their factories in this process, and check them
+		 *        with their bit-accurate model (see CoSimulation) on several threads, instead of calling the scripts
+		 * @param target the target of the operators built in process
+		 * @param report the file of the report of the in-process tests: JSON if its name ends with .json, JUnit XML otherwise
+		 *        (none for no report)
+		 */
+		AutoTest(string opName, bool testDependences = false, bool inProcess = false, Target* target = NULL, string report = "none");
 
 	private:
 
+		/** The result of a test run in process */
+		struct TestResult {
+			string opName;          /**< the name of the operator */
+			string parameters;      /**< the parameters of the test, as on the command line */
+			string status;          /**< passed, failed, error (the operator or its model threw) or skipped */
+			string message;         /**< the reason of the failure, error or skip */
+			int nbTestCases;        /**< the number of test cases run through the model */
+			int mismatches;         /**< the number of test cases where the model disagrees with emulate() */
+			string unchecked;       /**< the outputs of the model without expected values, hence not checked */
+			double seconds;         /**< the time of the construction and of the check */
+		};
+
 		string defaultTestBenchSize(map<string,string> * unitTestParam);
 
+		/**
+		 * Builds and checks the tests of the operators in process.
+		 * The operators and their test cases are built one at a time (the factories share global state, e.g. Sollya),
+		 * then the co-simulations run on the threads given by the threads option.
+		 * @return the number of tests that failed or could not be built
+		 */
+		int runInProcess(Target* target, set<string> &testedOperator, bool doUnitTest, bool doRandomTest, string report);
+
+		/** Writes the results in the JUnit XML format, one testsuite per operator */
+		void writeJUnitReport(string fileName, vector<TestResult> &results);
+
+		/** Writes the results as a JSON list */
+		void writeJSONReport(string fileName, vector<TestResult> &results);
+
 	};
 };
 #endif
@@ -0,0 +1,106 @@
+/*
+  A compact column of weighted bits, used by the bit heaps of FloPoCo
+
+  This file is part of the FloPoCo project
+  developed by the Arenaire team at Ecole Normale Superieure de Lyon
+
+  Initial software.
+  Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
+  2012.
+  All rights reserved.
+
+*/
+#ifndef __BITCOLUMN_HPP
+#define __BITCOLUMN_HPP
+#include <vector>
+#include <algorithm>
+
+#include "WeightedBit.hpp"
+
+
+using namespace std;
+
+namespace flopoco{
+
+	/**
+	 * A column of a bit heap: the bits are kept in a contiguous vector, sorted by
+	 * availability time (lexicographic order on (cycle, cp)).
+	 * The compressors always consume the earliest bits of a column, so removing a
+	 * bit from the front only advances a head index; the consumed slots are
+	 * reclaimed lazily, the next time a bit is inserted.
+	 * The column does not own its bits: they live in the arena of the bit heap.
+	 */
+	class BitColumn
+	{
+	public:
+		typedef vector<WeightedBit*>::iterator iterator;
+		typedef vector<WeightedBit*>::const_iterator const_iterator;
+
+		BitColumn() : head(0) {}
+
+		iterator begin()             { return bits.begin() + head; }
+		iterator end()               { return bits.end(); }
+		const_iterator begin() const { return bits.begin() + head; }
+		const_iterator end() const   { return bits.end(); }
+
+		size_t size() const          { return bits.size() - head; }
+		bool empty() const           { return head == bits.size(); }
+
+		WeightedBit* front()         { return bits[head]; }
+		WeightedBit* back()          { return bits.back(); }
+
+		/** @brief insert a bit after all the bits that are strictly earlier than it, keeping the column sorted */
+		void insertSorted(WeightedBit* bit)
+		{
+			compact();
+			bits.insert(lower_bound(begin(), end(), bit, earlier), bit);
+		}
+
+		/** @brief remove the earliest bit of the column */
+		void pop_front()
+		{
+			head++;
+			if(head == bits.size())
+				clear();
+		}
+
+		/** @brief remove the latest bit of the column */
+		void pop_back()
+		{
+			bits.pop_back();
+			if(head == bits.size())
+				clear();
+		}
+
+		/** @brief append a bit, which should not be earlier than the last bit of the column */
+		void push_back(WeightedBit* bit)
+		{
+			compact();
+			bits.push_back(bit);
+		}
+
+		void clear()
+		{
+			bits.clear();
+			head = 0;
+		}
+
+	private:
+		/** @brief reclaim the slots of the removed bits, once they make up half of the storage */
+		void compact()
+		{
+			if((head > 0) && (2*head >= bits.size()))
+			{
+				bits.erase(bits.begin(), bits.begin() + head);
+				head = 0;
+			}
+		}
+
+		static bool earlier(WeightedBit* b1, WeightedBit* b2) { return (*b1 < *b2); }
+
+		vector<WeightedBit*> bits;               /**< the bits of the column, sorted by availability time, starting at index head */
+		size_t head;                             /**< the index of the earliest bit still in the column */
+	};
+
+}
+#endif
@@ -22,6 +22,7 @@
 #include <math.h>
 #include <string>
 #include "utils.hpp"
+#include "profiler.h"
 #include <vector>
 #include <list>
 
@@ -36,10 +37,12 @@ namespace flopoco
 			int maxWeight,
 			bool enableSuperTiles,
 			string name,
-			int compressionType
+			int compressionType,
+			int compressionPlanner
 		) :
 			op(op),
 			compressionType(compressionType),
+			compressionPlanner(compressionPlanner),
 			maxWeight(maxWeight),
 			enableSuperTiles(enableSuperTiles)
 	{
@@ -60,9 +63,10 @@ namespace flopoco
 			usedCompressors[i]=false;
 		for (int i=0; i< maxWeight; i++) {
 			uid.push_back(0);
-			list<WeightedBit*> t;
-			bits.push_back(t);
+			bits.push_back(BitColumn());
+			history.push_back(BitColumn());
 		}
+		keepHistory = false;
 
 		adder3Index = 0;
 		minAdd3Length = 4;
@@ -88,13 +92,7 @@ namespace flopoco
 
 	BitHeap::~BitHeap()
 	{
-		for(unsigned i=0; i<bits.size(); i++){
-			list<WeightedBit*>& l = bits[i];
-			list<WeightedBit*>::iterator it;
-			for(it=l.begin(); it!=l.end(); it++){
-				delete (*it);
-			}
-		}
+		// the bits are owned by bitArena
 	}
 
 
@@ -774,38 +772,24 @@ namespace flopoco
 			return;
 		}
 
-		WeightedBit* bit= new WeightedBit(getGUid(), newUid(w), w, type, op->getCurrentCycle(), op->getCriticalPath()) ;
+		bitArena.push_back(WeightedBit(getGUid(), newUid(w), w, type, op->getCurrentCycle(), op->getCriticalPath()));
+		WeightedBit* bit = &bitArena.back();
 		// created at (op->getCycle(), opt-getCriticalPath())
 
 		int bitStage = bit->computeStage(stagesPerCycle, elementaryTime);
 		if (bitStage > plottingStage)
 			plottingStage = bitStage;
 
-		list<WeightedBit*>& l=bits[w];
-
-		//insert so that the list is sorted by bit cycle/delay
-		list<WeightedBit*>::iterator it=l.begin();
-		bool proceed=true;
-		unsigned count=0;
-		while(proceed)
-		{
-			if (it==l.end() || (*bit <= **it))
-			{ // test in this order to avoid segfault!
-				l.insert(it, bit);
-				proceed=false;
-			}
-			else
-			{
-				count++;
-				it++;
-			}
-		}
+		//insert so that the column is sorted by bit cycle/delay
+		bits[w].insertSorted(bit);
 
-		// now generate VHDL
-		op->vhdl << tab << op->declare(bit->getName()) << " <= " << rhs << ";";
+		// now generate VHDL, through the structured emission as there is one such line per bit
+		ostringstream bitComment;
 		if(comment.size())
-			op->vhdl <<  " -- " << comment;
-		op->vhdl <<  " -- " << "cycle= " << bit->getCycle() << " cp= " << bit->getCriticalPath(bit->getCycle()) << endl;
+			bitComment << comment << " -- ";
+		bitComment << "cycle= " << bit->getCycle() << " cp= " << bit->getCriticalPath(bit->getCycle());
+		op->declare(bit->getName());
+		op->emitAssignment(bit->getName(), rhs, bitComment.str());
 
 		REPORT(DEBUG, "added bit named "  << bit->getName() << " on column " << w <<" at cycle= "<< bit->getCycle() <<" cp= "<<bit->getCriticalPath(bit->getCycle()));
 
@@ -816,15 +800,21 @@ namespace flopoco
 
 	void BitHeap::removeBit(unsigned weight, int dir)
 	{
-		list<WeightedBit*>& l=bits[weight];
-
-		//WeightedBit* bit;
+		BitColumn& l=bits[weight];
 
-		//if dir=0 the bit will be removed from the begining of the list, else from the end of the list of weighted bits
+		//if dir=0 the bit will be removed from the begining of the column, else from the end of the column of weighted bits
 		if(dir==0)
+		{
+			if(keepHistory)
+				history[weight].push_back(l.front());
 			l.pop_front();
+		}
 		else if(dir==1)
+		{
+			if(keepHistory)
+				history[weight].push_back(l.back());
 			l.pop_back();
+		}
 
 
 
@@ -838,7 +828,7 @@ namespace flopoco
 
 	WeightedBit* BitHeap::latestInputBitToCompressor(unsigned w, int c0, int c1)
 	{
-		list<WeightedBit*>::iterator it;
+		BitColumn::iterator it;
 
 		if(w>=maxWeight)	{
 			REPORT(DEBUG, "latestInputBitToCompressor returns null because w>=maxWeight");
@@ -882,7 +872,7 @@ namespace flopoco
 	void BitHeap::elemReduce(unsigned i, BasicCompressor* bc, int type)
 	{
 		REPORT(DEBUG, "Entering elemReduce for column "<< i << " using compressor " << bc->getName() );
-		list<WeightedBit*>::iterator it = bits[i].begin();
+		BitColumn::iterator it = bits[i].begin();
 		stringstream signal[2];
 
 		op->vhdl << endl;
@@ -974,10 +964,7 @@ namespace flopoco
 
 
 	unsigned BitHeap::currentHeight(unsigned w) {
-		int h=0;
-		list<WeightedBit*>& l = bits[w];
-		h=l.size();
-		return h;
+		return bits[w].size();
 	}
 
 
@@ -1011,7 +998,7 @@ namespace flopoco
 
 	void BitHeap::generatePossibleCompressors()
 	{
-		//Build a vector of basic compressors that are fit for this target
+		//Build a vector of basic compressors that are fit for this target, shared with the other bit heaps of the design
 		int /*maxCompressibleBits,*/ col0, col1;
 
 		//maxCompressibleBits = op->getTarget()->lutInputs();
@@ -1029,7 +1016,7 @@ namespace flopoco
 						vector<int> newVect;
 						newVect.push_back(col0);
 						newVect.push_back(col1);
-						BasicCompressor* bc = new BasicCompressor(op->getTarget(), newVect);
+						BasicCompressor* bc = BasicCompressor::getCompressor(op->getTarget(), newVect);
 						if(col0==3 && col1==0)
 							fullAdder = bc;
 						possibleCompressors.push_back(bc);
@@ -1043,14 +1030,14 @@ namespace flopoco
 			vector<int> newVect;
 			newVect.push_back(col0);
 			newVect.push_back(col1);
-			possibleCompressors.push_back(new BasicCompressor(op->getTarget(), newVect));
+			possibleCompressors.push_back(BasicCompressor::getCompressor(op->getTarget(), newVect));
 		}
 		{// test
 			col0=5; col1=1;
 			vector<int> newVect;
 			newVect.push_back(col0);
 			newVect.push_back(col1);
-			compressor = new BasicCompressor(op->getTarget(), newVect);
+			compressor = BasicCompressor::getCompressor(op->getTarget(), newVect);
 			possibleCompressors.push_back(compressor);
 		}
 		*/
@@ -1059,14 +1046,14 @@ namespace flopoco
 			vector<int> newVect;
 			newVect.push_back(col0);
 			newVect.push_back(col1);
-			possibleCompressors.push_back(new BasicCompressor(op->getTarget(), newVect));
+			possibleCompressors.push_back(BasicCompressor::getCompressor(op->getTarget(), newVect));
 		}
 		{//test
 			col0=4; col1=1;
 			vector<int> newVect;
 			newVect.push_back(col0);
 			newVect.push_back(col1);
-			compressor = new BasicCompressor(op->getTarget(), newVect);
+			compressor = BasicCompressor::getCompressor(op->getTarget(), newVect);
 			possibleCompressors.push_back(compressor);
 		}
 		{// test
@@ -1074,7 +1061,7 @@ namespace flopoco
 			vector<int> newVect;
 			newVect.push_back(col0);
 			newVect.push_back(col1);
-			compressor = new BasicCompressor(op->getTarget(), newVect);
+			compressor = BasicCompressor::getCompressor(op->getTarget(), newVect);
 			possibleCompressors.push_back(compressor);
 		}
 		{//test
@@ -1082,7 +1069,7 @@ namespace flopoco
 			vector<int> newVect;
 			newVect.push_back(col0);
 			newVect.push_back(col1);
-			compressor = new BasicCompressor(op->getTarget(), newVect);
+			compressor = BasicCompressor::getCompressor(op->getTarget(), newVect);
 			possibleCompressors.push_back(compressor);
 		}
 		{
@@ -1090,14 +1077,14 @@ namespace flopoco
 			vector<int> newVect;
 			newVect.push_back(col0);
 			newVect.push_back(col1);
-			possibleCompressors.push_back(new BasicCompressor(op->getTarget(), newVect));
+			possibleCompressors.push_back(BasicCompressor::getCompressor(op->getTarget(), newVect));
 		}
 		{//test
 			col0=3; col1=1;
 			vector<int> newVect;
 			newVect.push_back(col0);
 			newVect.push_back(col1);
-			compressor = new BasicCompressor(op->getTarget(), newVect);
+			compressor = BasicCompressor::getCompressor(op->getTarget(), newVect);
 			possibleCompressors.push_back(compressor);
 		}
 		{
@@ -1105,7 +1092,7 @@ namespace flopoco
 			vector<int> newVect;
 			newVect.push_back(col0);
 			newVect.push_back(col1);
-			compressor = new BasicCompressor(op->getTarget(), newVect);
+			compressor = BasicCompressor::getCompressor(op->getTarget(), newVect);
 			possibleCompressors.push_back(compressor);
 		}
 
@@ -1121,23 +1108,211 @@ namespace flopoco
 			vector<int> newVect;
 			newVect.push_back(2);
 			newVect.push_back(0);
-			halfAdder = new BasicCompressor(op->getTarget(), newVect);
+			halfAdder = BasicCompressor::getCompressor(op->getTarget(), newVect);
 		}
 		*/
 	}
 
 
+	void BitHeap::planCompression(int planner, vector<unsigned> available, vector<unsigned> heights,
+			vector<pair<unsigned, unsigned> > &plan)
+	{
+		unsigned int i, j;
+
+		plan.clear();
+
+		//a compressor fits on column i if there are enough available bits on the columns it reads
+		auto fits = [&](unsigned int j, unsigned int i) -> bool
+		{
+			BasicCompressor *bc = possibleCompressors[j];
+
+			if(available[i] < bc->getColumnSize(0))
+				return false;
+			if(bc->getColumnSize(1) == 0)
+				return true;
+			return ((i < maxWeight-1) && (available[i+1] >= bc->getColumnSize(1)));
+		};
+		//take the bits of a compressor out of the columns
+		auto apply = [&](unsigned int j, unsigned int i)
+		{
+			BasicCompressor *bc = possibleCompressors[j];
+
+			plan.push_back(make_pair(i, j));
+			available[i] -= bc->getColumnSize(0);
+			heights[i]   -= bc->getColumnSize(0);
+			if(bc->getColumnSize(1) != 0)
+			{
+				available[i+1] -= bc->getColumnSize(1);
+				heights[i+1]   -= bc->getColumnSize(1);
+			}
+		};
+
+		if(planner == 0)
+		{
+			/*
+			 * Try to use only optimal compressors. When going through the columns,
+			 * if the compressible bits in a column are not enough to fill an OPTIMAL
+			 * compressor, then leave the bits unprocessed and move on to the next column
+			 */
+			for(j=0; j<possibleCompressors.size(); j++)
+				for(i=minWeight; i<maxWeight; i++)
+					while(fits(j, i))
+						apply(j, i);
+		}
+		else if(planner == 1)
+		{
+			/*
+			 * Start from the greedy plan, then go through its compressors, from the last one,
+			 * and try to remove each of them, or to replace it by a compressor using fewer LUTs.
+			 * A change is kept when the lookahead, which completes the compression of the heap
+			 * with the greedy planner, needs no more stages and fewer LUTs than before.
+			 */
+			vector<unsigned> used;
+			int baseStages, baseLuts;
+
+			//evaluate a plan: this stage, then the greedy planner until the end of the compression
+			auto lookahead = [&](vector<pair<unsigned, unsigned> > &candidate, int &nbStages, int &nbLuts)
+			{
+				vector<unsigned> nextHeights = heights;
+				int nextStages, nextLuts;
+
+				nbLuts = 0;
+				applyCompressionPlan(candidate, nextHeights, nbLuts);
+				simulateCompression(0, nextHeights, nextStages, nextLuts);
+				nbStages = 1 + nextStages;
+				nbLuts += nextLuts;
+			};
+
+			planCompression(0, available, heights, plan);
+			if(plan.empty())
+				return;
+			lookahead(plan, baseStages, baseLuts);
+
+			for(int k=plan.size()-1; k>=0; k--)
+			{
+				vector<pair<unsigned, unsigned> > candidate, bestPlan;
+				unsigned int col = plan[k].first;
+				BasicCompressor *bc = possibleCompressors[plan[k].second];
+				int nbStages, nbLuts, bestStages = baseStages, bestLuts = baseLuts;
+				bool improved = false;
+
+				//remove the compressor, but never leave a stage without compressors
+				candidate = plan;
+				candidate.erase(candidate.begin()+k);
+				if(!candidate.empty())
+				{
+					lookahead(candidate, nbStages, nbLuts);
+					if((nbStages <= baseStages) && (nbLuts < bestLuts))
+					{
+						bestPlan = candidate;
+						bestStages = nbStages;
+						bestLuts = nbLuts;
+						improved = true;
+					}
+				}
+
+				//replace the compressor by a smaller one, using the bits left by the other compressors
+				if(!improved)
+				{
+					used.assign(maxWeight+1, 0);
+					for(size_t c=0; c<candidate.size(); c++)
+					{
+						used[candidate[c].first]   += possibleCompressors[candidate[c].second]->getColumnSize(0);
+						used[candidate[c].first+1] += possibleCompressors[candidate[c].second]->getColumnSize(1);
+					}
+					for(j=0; j<possibleCompressors.size(); j++)
+					{
+						BasicCompressor *bcj = possibleCompressors[j];
+
+						if((bcj == bc) || (bcj->getOutputSize() > bc->getOutputSize()))
+							continue;
+						if(available[col]-used[col] < bcj->getColumnSize(0))
+							continue;
+						if((bcj->getColumnSize(1) != 0)
+								&& ((col >= maxWeight-1) || (available[col+1]-used[col+1] < bcj->getColumnSize(1))))
+							continue;
+
+						candidate = plan;
+						candidate[k].second = j;
+						lookahead(candidate, nbStages, nbLuts);
+						if((nbStages <= baseStages) && (nbLuts < bestLuts))
+						{
+							bestPlan = candidate;
+							bestStages = nbStages;
+							bestLuts = nbLuts;
+							improved = true;
+						}
+					}
+				}
+
+				if(improved)
+				{
+					plan = bestPlan;
+					baseStages = bestStages;
+					baseLuts = bestLuts;
+				}
+			}
+		}
+		else
+		{
+			THROWERROR("planCompression: unknown compression planner " << planner);
+		}
+	}
+
+
+	void BitHeap::applyCompressionPlan(vector<pair<unsigned, unsigned> > &plan, vector<unsigned> &heights, int &nbLuts)
+	{
+		for(size_t k=0; k<plan.size(); k++)
+		{
+			BasicCompressor *bc = possibleCompressors[plan[k].second];
+
+			heights[plan[k].first] -= bc->getColumnSize(0);
+			if(bc->getColumnSize(1) != 0)
+				heights[plan[k].first+1] -= bc->getColumnSize(1);
+			//the bits beyond maxWeight are dropped
+			for(int o=0; (o<bc->getOutputSize()) && (plan[k].first+o<maxWeight); o++)
+				heights[plan[k].first+o] += 1;
+			nbLuts += bc->getOutputSize();
+		}
+	}
+
+
+	void BitHeap::simulateCompression(int planner, vector<unsigned> heights, int &nbStages, int &nbLuts)
+	{
+		vector<pair<unsigned, unsigned> > plan;
+		unsigned maxHeight;
+
+		nbStages = 0;
+		nbLuts = 0;
+		do
+		{
+			//all the bits are considered available
+			planCompression(planner, heights, heights, plan);
+			if(plan.empty())
+				break;
+			applyCompressionPlan(plan, heights, nbLuts);
+			nbStages++;
+
+			maxHeight = 0;
+			for(unsigned i=minWeight; i<maxWeight; i++)
+				if(heights[i] > maxHeight)
+					maxHeight = heights[i];
+		}
+		while(maxHeight >= 3);
+	}
+
+
 	void BitHeap::printColumnInfo(int w)
 	{
 		int i=0;
 
-		for(list<WeightedBit*>::iterator it = bits[w].begin(); it!=bits[w].end(); ++it)
+		for(BitColumn::iterator it = bits[w].begin(); it!=bits[w].end(); ++it)
 			{
 				REPORT(FULL, "i="<<i<<"  name=" << (*it)->getName() <<" cycle="<<(*it)->getCycle()
 					   << " cp="<<(*it)->getCriticalPath((*it)->getCycle()));
 				// check the ordering -- this should be useless, was inserted for debug purpose
 				if(i>0) {
-					list<WeightedBit*>::iterator itm1 = it;
+					BitColumn::iterator itm1 = it;
 					itm1--;
 					if(**it < **itm1)
 						THROWERROR("Wrong ordering of weighted bits: *it=" << *it << " ("<<
@@ -1153,6 +1328,8 @@ namespace flopoco
 
 	void BitHeap::generateCompressorVHDL()
 	{
+		ProfileScope profile("bitheap compression");
+		Profiler::instance().count("bitheaps_compressed");
 		op->vhdl << tab << endl << tab << "-- Beginning of code generated by BitHeap::generateCompressorVHDL" << endl;
 		REPORT(DEBUG, "begin generateCompressorVHDL");
 
@@ -1214,6 +1391,21 @@ namespace flopoco
 			// There is some compression to do
 			generatePossibleCompressors();
 
+			//compare the planners, on the bits of the heap
+			if(compressionPlanner != 0)
+			{
+				vector<unsigned> heights(maxWeight+1, 0);
+				int greedyStages, greedyLuts, plannerStages, plannerLuts;
+
+				for(unsigned w=minWeight; w<maxWeight; w++)
+					heights[w] = bits[w].size();
+				simulateCompression(0, heights, greedyStages, greedyLuts);
+				simulateCompression(compressionPlanner, heights, plannerStages, plannerLuts);
+				REPORT(INFO, "compressor planner " << compressionPlanner << ": " << plannerStages << " stage(s) and "
+						<< plannerLuts << " LUT(s), the greedy planner: " << greedyStages << " stage(s) and "
+						<< greedyLuts << " LUT(s)");
+			}
+
 			elementaryTime = op->getTarget()->lutDelay() + op->getTarget()->localWireDelay();
 			stagesPerCycle = (1/op->getTarget()->frequency()) / elementaryTime;
 			int stage = minCycle*stagesPerCycle + minCP/elementaryTime ;
@@ -1515,7 +1707,7 @@ namespace flopoco
 				if (bits[w].size() > (unsigned)0)
 					{
 
-						for(list<WeightedBit*>::iterator it = bits[w].begin(); it!=bits[w].end(); ++it)
+						for(BitColumn::iterator it = bits[w].begin(); it!=bits[w].end(); ++it)
 							{
 								if (minCycle > (*it)->getCycle())
 									{
@@ -1576,7 +1768,7 @@ namespace flopoco
 			{
 				int count = 0;
 
-				for(list<WeightedBit*>::iterator it = bits[i].begin(); (it!=bits[i].end() && count<(i==lsb ? 3 : 2)); ++it)
+				for(BitColumn::iterator it = bits[i].begin(); (it!=bits[i].end() && count<(i==lsb ? 3 : 2)); ++it)
 				{
 #if 0
 					if(
@@ -1597,7 +1789,7 @@ namespace flopoco
 
 		for(int i = msb; i>=lsb+1; i--)
 		{
-			list<WeightedBit*>::iterator it = bits[i].begin();
+			BitColumn::iterator it = bits[i].begin();
 
 			if(cnt[i]>=2)
 			{
@@ -1628,7 +1820,7 @@ namespace flopoco
 		}
 
 		// We know the LSB col is of size 3
-		list<WeightedBit*>::iterator it = bits[lsb].begin();
+		BitColumn::iterator it = bits[lsb].begin();
 		if(cnt[lsb]>0)
 			inAdder0 << (*it)->getName();
 		if(cnt[lsb]>1)
@@ -1856,7 +2048,7 @@ namespace flopoco
 					{
 						int syncLoopCount = 0;
 
-						for(list<WeightedBit*>::iterator it=bits[j].begin(); ((it!=bits[j].end()) && (syncLoopCount<2)); it++)
+						for(BitColumn::iterator it=bits[j].begin(); ((it!=bits[j].end()) && (syncLoopCount<2)); it++)
 						{
 							if(*lastBit < **it)
 								lastBit = *it;
@@ -1873,7 +2065,7 @@ namespace flopoco
 				//create the first term
 				for(int j=term1IndexLeftNew; j>=term1IndexRightNew; j--)
 				{
-					list<WeightedBit*>::iterator it = bits[j].begin();
+					BitColumn::iterator it = bits[j].begin();
 
 					if(bits[j].size() >= 1)
 					{
@@ -1890,7 +2082,7 @@ namespace flopoco
 				//create the second term
 				for(int j=term2IndexLeft; j>=term2IndexRight; j--)
 				{
-					list<WeightedBit*>::iterator it;
+					BitColumn::iterator it;
 
 					if(bits[j].empty())
 					{
@@ -1966,7 +2158,7 @@ namespace flopoco
 		//create the result of the compression
 		for(int i=maxWeight-1; i>=0; i--)
 		{
-			list<WeightedBit*>::iterator it = bits[i].begin();
+			BitColumn::iterator it = bits[i].begin();
 
 			if(bits[i].size() >= 1)
 			{
@@ -1998,7 +2190,7 @@ namespace flopoco
 				if(bits[w].size() > 0)
 					{
 
-						for(list<WeightedBit*>::iterator it = bits[w].begin(); it!=bits[w].end(); ++it)
+						for(BitColumn::iterator it = bits[w].begin(); it!=bits[w].end(); ++it)
 							{
 								if (maxCycle < (*it)->getCycle())
 									{
@@ -2065,7 +2257,7 @@ namespace flopoco
 				REPORT(FULL,"i=   " << i);
 				if(i >= 0)
 				{
-					list<WeightedBit*>::iterator it = bits[i].begin();
+					BitColumn::iterator it = bits[i].begin();
 					if(bits[i].size()==2)
 					{
 						inAdder0 << (*it)->getName();
@@ -2163,7 +2355,7 @@ namespace flopoco
 				REPORT(FULL,"i=   "<<i);
 				if(i>=0)
 				{
-					list<WeightedBit*>::iterator it = bits[i].begin();
+					BitColumn::iterator it = bits[i].begin();
 					if(bits[i].size()==3)
 					{
 						inAdder0 << (*it)->getName();
@@ -2457,7 +2649,7 @@ namespace flopoco
 		for(unsigned i=minWeight; i<maxWeight; i++)
 		{
 			cnt[i]=0;
-			for(list<WeightedBit*>::iterator it = bits[i].begin(); it!=bits[i].end(); it++)
+			for(BitColumn::iterator it = bits[i].begin(); it!=bits[i].end(); it++)
 			{
 				if((*it)->computeStage(stagesPerCycle, elementaryTime)<=stage)
 				{
@@ -2491,7 +2683,7 @@ namespace flopoco
 
 		while((index<maxWeight) && ((cnt[index]<=2)&&(cnt[index]>0)))
 		{
-			list<WeightedBit*>::iterator it = bits[index].begin();
+			BitColumn::iterator it = bits[index].begin();
 			columnIndex = 0;
 
 			while(columnIndex<cnt[index]-1)
@@ -2568,7 +2760,7 @@ namespace flopoco
 		for(unsigned i=minWeight; i<maxWeight; i++)
 		{
 			cnt[i]=0;
-			for(list<WeightedBit*>::iterator it = bits[i].begin(); it!=bits[i].end(); it++)
+			for(BitColumn::iterator it = bits[i].begin(); it!=bits[i].end(); it++)
 			{
 				if((*it)->computeStage(stagesPerCycle, elementaryTime)<=stage)
 				{
@@ -2742,7 +2934,7 @@ namespace flopoco
 
 					//create the right side of the terms for the 3-input addition
 					for(unsigned int i=endAddChain; i>=index; i--){
-						list<WeightedBit*>::iterator it = bits[i].begin();
+						BitColumn::iterator it = bits[i].begin();
 
 						if(cnt[i]>=3)
 						{
@@ -2843,63 +3035,44 @@ namespace flopoco
 
 		REPORT(DEBUG,"start compressing maxHeight=" << maxWeight);
 
-		/*
-		 * Try to use only optimal compressors. When going through the columns,
-		 * if the compressible bits in a column are not enough to fill an OPTIMAL
-		 * compressor, then leave the bits unprocessed and move on to the next column
-		 */
-		unsigned int i, j;
+		//plan the compressors of this stage, from the bits available at this stage
+		vector<unsigned> available(maxWeight+1, 0), heights(maxWeight+1, 0);
+		vector<pair<unsigned, unsigned> > plan;
 
-		i = minWeight;		//column index
-		j = 0;				//compressor index
-		while(j < possibleCompressors.size())
+		for(unsigned int i=minWeight; i<maxWeight; i++)
 		{
-			while(i < maxWeight)
-			{
-				while(
-						((possibleCompressors[j]->getColumnSize(1) == 0) && (cnt[i] >= possibleCompressors[j]->getColumnSize(0))) ||
-						((possibleCompressors[j]->getColumnSize(1)!=0) && (cnt[i] >= possibleCompressors[j]->getColumnSize(0)) && (cnt[i+1] >= possibleCompressors[j]->getColumnSize(1)))
-					)
-				{
-					if(possibleCompressors[j]->getColumnSize(1)!=0)
-					{
-						if((i < bits.size()-1) && (cnt[i] >= possibleCompressors[j]->getColumnSize(0)) && (cnt[i+1]>=possibleCompressors[j]->getColumnSize(1)))
-						{
-							REPORT(DEBUG,endl);
-							REPORT(DEBUG,"Using Compressor " << j <<" to reduce columns " << i << " and " << i+1);
-							elemReduce(i, possibleCompressors[j]);
-							cnt[i]-=possibleCompressors[j]->getColumnSize(0);
-							cnt[i+1]-=possibleCompressors[j]->getColumnSize(1);
-							didCompress = true;
-							usedCompressors[j]=true;
-						}
-					}
-					else
-					{
-						if(cnt[i] >= possibleCompressors[j]->getColumnSize(0))
-						{
-							REPORT(DEBUG,endl);
-							REPORT(DEBUG,"Using Compressor " << j <<" to reduce column " << i);
-							elemReduce(i, possibleCompressors[j]);
-							cnt[i]-=possibleCompressors[j]->getColumnSize(0);
-							didCompress = true;
-							usedCompressors[j]=true;
-						}
-					}
-				}
+			available[i] = cnt[i];
+			heights[i] = bits[i].size();
+		}
+		planCompression(compressionPlanner, available, heights, plan);
 
-				i++;
-			}
+		//apply the compressors, in the order given by the plan
+		for(size_t k=0; k<plan.size(); k++)
+		{
+			unsigned int i = plan[k].first;
+			unsigned int j = plan[k].second;
 
-			i = minWeight;
-			j++;
+			REPORT(DEBUG,endl);
+			if(possibleCompressors[j]->getColumnSize(1) != 0)
+			{
+				REPORT(DEBUG,"Using Compressor " << j <<" to reduce columns " << i << " and " << i+1);
+			}
+			else
+			{
+				REPORT(DEBUG,"Using Compressor " << j <<" to reduce column " << i);
+			}
+			elemReduce(i, possibleCompressors[j]);
+			cnt[i]-=possibleCompressors[j]->getColumnSize(0);
+			cnt[i+1]-=possibleCompressors[j]->getColumnSize(1);
+			didCompress = true;
+			usedCompressors[j]=true;
 		}
 
 		//update the next three (actually, the log of the size of the largest compressor) columns
 		for(unsigned int i=minWeight; i<maxWeight; i++)
 		{
 			cnt[i]=0;
-			for(list<WeightedBit*>::iterator it = bits[i].begin(); it!=bits[i].end(); it++)
+			for(BitColumn::iterator it = bits[i].begin(); it!=bits[i].end(); it++)
 			{
 				if((*it)->computeStage(stagesPerCycle, elementaryTime) <= stage)
 				{
@@ -3094,5 +3267,17 @@ namespace flopoco
 
 	bool BitHeap::getSignedIO() {return signedIO;}
 
+	void BitHeap::setCompressionPlanner(int planner) {
+		if(bitheapCompressed)
+			THROWERROR("setCompressionPlanner: the bit heap is already compressed");
+		compressionPlanner = planner;
+	}
+
+	int BitHeap::getCompressionPlanner() {return compressionPlanner;}
+
+	void BitHeap::setHistoryRetention(bool keep) {keepHistory = keep;}
+
+	bool BitHeap::getHistoryRetention() {return keepHistory;}
+
 }
 
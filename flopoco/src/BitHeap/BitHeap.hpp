@@ -15,8 +15,10 @@
 #ifndef __BITHEAP_HPP
 #define __BITHEAP_HPP
 #include <vector>
+#include <deque>
 #include <sstream>
 #include "WeightedBit.hpp"
+#include "BitColumn.hpp"
 #include "Operator.hpp"
 #include "Table.hpp"
 #include "DualTable.hpp"
@@ -27,6 +29,11 @@
 
  #define COMPRESSION_TYPE 0
 
+// the planner choosing the compressors of each stage:
+//	0 = greedy, the largest compressors first, as many as possible
+//	1 = heuristic with lookahead, the greedy plan of each stage pruned while the remaining stages don't get worse
+ #define COMPRESSION_PLANNER 0
+
 
 /*
    Each bit in the bit heap is flagged with the cycle at which it is produced.
@@ -80,8 +87,14 @@ namespace flopoco{
 		 *								2 = using a mix of the two, with an 
 		 *									addition tree at the end of the 
 		 *									compression
+		 * @param compressionPlanner	the planner choosing the compressors of each stage:
+		 *								0 = greedy (default),
+		 *								1 = heuristic with lookahead, removing or shrinking the
+		 *									compressors of the greedy plan of each stage, as long as
+		 *									the compression needs no more stages and fewer LUTs
 		 */
-		BitHeap(Operator* op, int maxWeight, bool enableSuperTiles = true, string name = "", int compressionType = COMPRESSION_TYPE);
+		BitHeap(Operator* op, int maxWeight, bool enableSuperTiles = true, string name = "", int compressionType = COMPRESSION_TYPE,
+				int compressionPlanner = COMPRESSION_PLANNER);
 		~BitHeap();
 
 		/** @brief add a bit to the bit heap. The bit will be added at the cycle op->currentCycle() with critical path op->getCriticalPath().
@@ -232,6 +245,16 @@ namespace flopoco{
 		void setSignedIO(bool s);
 
 		bool getSignedIO();
+
+		/** @brief set the planner choosing the compressors (see the constructor). To be called before generateCompressorVHDL() */
+		void setCompressionPlanner(int planner);
+
+		int getCompressionPlanner();
+
+		/** @brief if true, the bits removed from the columns are kept in history (default false) */
+		void setHistoryRetention(bool keep);
+
+		bool getHistoryRetention();
 	protected:
 
 
@@ -290,12 +313,33 @@ namespace flopoco{
 
 
 		/** @brief counts the bits not processed yet in wb */
-		int count(list<WeightedBit*> wb, int cycle);
+		int count(const BitColumn &wb, int cycle);
 
 		void printColumnInfo(int w);
 
 		void generatePossibleCompressors();
 
+		/**
+		 * @brief plan the compressors of one stage
+		 * @param planner    the planner to use (see the constructor)
+		 * @param available  the number of bits of each column that can be compressed at this stage
+		 * @param heights    the total number of bits of each column
+		 * @param plan       the compressors to apply, in order, as pairs (column, index in possibleCompressors)
+		 */
+		void planCompression(int planner, vector<unsigned> available, vector<unsigned> heights,
+				vector<pair<unsigned, unsigned> > &plan);
+
+		/**
+		 * @brief apply the compressors of a plan to the heights of the columns, and count their LUTs
+		 */
+		void applyCompressionPlan(vector<pair<unsigned, unsigned> > &plan, vector<unsigned> &heights, int &nbLuts);
+
+		/**
+		 * @brief simulate the compression of columns of the given heights, ignoring timing,
+		 * and count the stages and the LUTs of the compressors
+		 */
+		void simulateCompression(int planner, vector<unsigned> heights, int &nbStages, int &nbLuts);
+
 		/** @brief remove the compressed bits */
 		void removeCompressedBits(int c, int red);
 
@@ -316,12 +360,15 @@ namespace flopoco{
 		void printBitHeapStatus();
 
 	public: // TODO privatize
-		vector<list<WeightedBit*> > bits; 			/**<  Each list is ordered by arrival time of the bits, i.e. lexicographic order on (cycle, cp).
-															During the generation of the compressor, bits are added and removed to these lists */
-		vector<list<WeightedBit*> > history; 		/**<  remembers all the changes to bits */
+		vector<BitColumn> bits; 					/**<  Each column is ordered by arrival time of the bits, i.e. lexicographic order on (cycle, cp).
+															During the generation of the compressor, bits are added and removed to these columns */
+		vector<BitColumn> history; 					/**<  remembers the bits removed from bits, in the order of their removal, when keepHistory is set */
 	private:
+		deque<WeightedBit> bitArena;				/**< the storage of all the bits of the heap, freed with the heap; bits and history only hold pointers into it */
+		bool keepHistory;							/**< are the removed bits kept in history */
 		Operator* op;
 		int compressionType;						/**< The type of compression performed (explained in the header of the constructor)*/
+		int compressionPlanner;						/**< The planner choosing the compressors of each stage (explained in the header of the constructor)*/
 		unsigned maxWeight;							/**< The compressor tree will produce a result for weights < maxWeight (work modulo 2^maxWeight)*/
 		unsigned minWeight;							/**< bits smaller than this one are already compressed */
 		mpz_class constantBits;						/**< This int gather all the constant bits that need to be added to the bit heap (for rounding, two's complement etc) */
@@ -21,18 +21,18 @@ using namespace std;
 namespace flopoco
 {
 
-	Plotter::Snapshot::Snapshot(vector<list<WeightedBit*> > bitheap, int minWeight_, 
+	Plotter::Snapshot::Snapshot(vector<BitColumn> &bitheap, int minWeight_, 
 			int maxWeight_, unsigned maxHeight_, bool didCompress_,  int cycle_, double cp_):
 		maxWeight(maxWeight_), minWeight(minWeight_), maxHeight(maxHeight_), didCompress(didCompress_) , 
 		cycle(cycle_), cp(cp_)
 	{
 		for(int w=minWeight; w<maxWeight_; w++)
 		{
-			list<WeightedBit*> t;
+			BitColumn t;
 
 			if(bitheap[w].size()>0)	
 			{
-				for(list<WeightedBit*>::iterator it = bitheap[w].begin(); it!=bitheap[w].end(); ++it)	
+				for(BitColumn::iterator it = bitheap[w].begin(); it!=bitheap[w].end(); ++it)	
 				{
 					WeightedBit* b = new WeightedBit(*it);
 					t.push_back(b);
@@ -599,7 +599,7 @@ namespace flopoco
 
 
 
-	void Plotter::drawInitialConfiguration(vector<list<WeightedBit*> > bits, int minWeight, int offsetY, int turnaroundX)
+	void Plotter::drawInitialConfiguration(vector<BitColumn> &bits, int minWeight, int offsetY, int turnaroundX)
 	{
 		int color = 0;
 		int cnt = 0;
@@ -613,7 +613,7 @@ namespace flopoco
 		{
 			if(bits[i].size()>0)
 			{
-				for(list<WeightedBit*>::iterator bit = bits[i].begin(); bit!=bits[i].end(); ++bit)
+				for(BitColumn::iterator bit = bits[i].begin(); bit!=bits[i].end(); ++bit)
 				{
 					if(orderedBits.size()==0)
 					{
@@ -659,7 +659,7 @@ namespace flopoco
 			if(bits[i].size()>0)
 			{
 				cnt = 0;
-				for(list<WeightedBit*>::iterator it = bits[i].begin(); it!=bits[i].end(); ++it)
+				for(BitColumn::iterator it = bits[i].begin(); it!=bits[i].end(); ++it)
 				{
 					color=0;
 
@@ -681,7 +681,7 @@ namespace flopoco
 
 
 
-	void Plotter::drawConfiguration(vector<list<WeightedBit*> > bits,unsigned nr, int cycle, double criticalPath,
+	void Plotter::drawConfiguration(vector<BitColumn> &bits,unsigned nr, int cycle, double criticalPath,
 			int minWeight, int offsetY, int turnaroundX, bool timeCondition)
 	{
 		int cnt = 0;
@@ -723,7 +723,7 @@ namespace flopoco
 			if(bits[i].size()>0)
 			{
 				cnt = 0;
-				for(list<WeightedBit*>::iterator it = bits[i].begin(); it!=bits[i].end(); ++it)
+				for(BitColumn::iterator it = bits[i].begin(); it!=bits[i].end(); ++it)
 				{
 					int cy = (*it)->getCycle();
 					double cp = (*it)->getCriticalPath(cy);
@@ -38,7 +38,7 @@ namespace flopoco
 		{
 			public:
 
-				Snapshot(vector<list<WeightedBit*> > bitheap, int minWeight_, int maxWeight_, unsigned maxHeight,
+				Snapshot(vector<BitColumn> &bitheap, int minWeight_, int maxWeight_, unsigned maxHeight,
 						bool didCompress_,  int cycle, double cp);
 
 
@@ -57,7 +57,7 @@ namespace flopoco
 
 				//unsigned getMaxHeight();
 
-				vector<list<WeightedBit*> > bits;
+				vector<BitColumn> bits;
 				int maxWeight;
 				int minWeight;
 				unsigned maxHeight;
@@ -144,9 +144,9 @@ namespace flopoco
 
 		void initializeHeapPlotting(bool isInitial);
 
-		void drawInitialConfiguration( vector<list<WeightedBit*> > bits, int maxWeight, int offsetY, int turnaroundX);
+		void drawInitialConfiguration( vector<BitColumn> &bits, int maxWeight, int offsetY, int turnaroundX);
 
-		void drawConfiguration(vector<list<WeightedBit*> > bits, unsigned nr, int cycle, double cp,
+		void drawConfiguration(vector<BitColumn> &bits, unsigned nr, int cycle, double cp,
 				int maxWeight, int offsetY, int turnaroundX, bool timeCondition);
 
 		/**
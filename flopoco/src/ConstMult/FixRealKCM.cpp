@@ -478,7 +478,21 @@ namespace flopoco{
 				REPORT(DEBUG, "lsbIn=" << lsbIn);
 				parentOp->vhdl << tab << parentOp->declare(sliceInName, m[i]- l[i] +1 ) << " <= "
 											 << inputSignalName << range(m[i]-lsbIn, l[i]-lsbIn) << "; -- input address  m=" << m[i] << "  l=" << l[i]  << endl;
-				FixRealKCMTable* t = new FixRealKCMTable(parentOp->getTarget(), this, i);
+				// The table only depends on the constant and on the chunk, and table 0 on the round bit it holds:
+				// share it with the identical KCMs of the design
+				ostringstream tableParams;
+				tableParams << "constant=" << constant << " signedInput=" << signedInput
+										<< " msbIn=" << msbIn << " lsbIn=" << lsbIn << " lsbOut=" << lsbOut << " g=" << g
+										<< " m=" << m[i] << " l=" << l[i] << " sign=" << tableOutputSign[i]
+										<< " roundBit=" << (addRoundBit && (i==0) && (g>0));
+				string tableKey = UserInterface::operatorCacheKey(parentOp->getTarget(), "FixRealKCMTable", tableParams.str());
+				FixRealKCMTable* t = (FixRealKCMTable*) UserInterface::getCachedOperator(tableKey);
+				if(t == NULL) {
+					t = new FixRealKCMTable(parentOp->getTarget(), this, i);
+					UserInterface::addToOperatorCache(tableKey, t);
+				}
+				else
+					REPORT(DETAILED, "Reusing table " << t->getName() << " for chunk " << i);
 				parentOp->addSubComponent(t);
 				parentOp->inPortMap (t , "X", sliceInName);
 				parentOp->outPortMap(t , "Y", sliceOutName);
@@ -12,19 +12,53 @@ namespace flopoco {
 	FixEMethodEvaluator::FixEMethodEvaluator(Target* target, size_t _radix, size_t _maxDigit, int _msbInOut, int _lsbInOut,
 		vector<string> _coeffsP, vector<string> _coeffsQ,
 		double _delta, bool _scaleInput, double _inputScaleFactor,
-		map<string, double> inputDelays)
+		size_t _foldingFactor, map<string, double> inputDelays)
+	: FixEMethodEvaluator(target, _radix, _maxDigit, _msbInOut, _lsbInOut,
+			vector<vector<string>>(1, _coeffsP), vector<vector<string>>(1, _coeffsQ),
+			_delta, _scaleInput, _inputScaleFactor, _foldingFactor, 0, false, "none", false, "auto", false, "mcm", inputDelays)
+	{
+	}
+
+
+	FixEMethodEvaluator::FixEMethodEvaluator(Target* target, size_t _radix, size_t _maxDigit, int _msbInOut, int _lsbInOut,
+		vector<vector<string>> _coeffsP, vector<vector<string>> _coeffsQ,
+		double _delta, bool _scaleInput, double _inputScaleFactor,
+		size_t _foldingFactor, int _segmentBits, bool _onlineOutput, string _onlineCompose,
+		bool _trimWidths, string _selection, bool _carrySave, string _multiples, map<string, double> inputDelays)
 	: Operator(target), radix(_radix), maxDigit(_maxDigit),
-	  	  n(_coeffsP.size()), m(_coeffsQ.size()),
+	  	  n(firstCoefficientSet(_coeffsP, "P").size()), m(firstCoefficientSet(_coeffsQ, "Q").size()),
 	  	  msbInOut(_msbInOut), lsbInOut(_lsbInOut),
-		  coeffsP(_coeffsP), coeffsQ(_coeffsQ),
+		  coeffsP(firstCoefficientSet(_coeffsP, "P")), coeffsQ(firstCoefficientSet(_coeffsQ, "Q")),
 		  delta(_delta), scaleInput(_scaleInput), inputScaleFactor(_inputScaleFactor),
-		  maxDegree(n>m ? n : m)
+		  foldingFactor(_foldingFactor), nbFoldedRows(0),
+		  maxDegree(n>m ? n : m),
+		  nbLanes(_segmentBits > 0 ? 1 : _coeffsP.size()), lanesCoeffsP(_coeffsP), lanesCoeffsQ(_coeffsQ),
+		  segmentBits(_segmentBits), nbSegments(_segmentBits > 0 ? _coeffsP.size() : 1),
+		  onlineOutput(_onlineOutput), onlineCompose(_onlineCompose), firstComposedDigit(0),
+		  trimWidths(_trimWidths), selection(_selection), carrySave(_carrySave),
+		  multiples(_multiples)
 	{
 		ostringstream name;
+		int laneStartCycle;
+		double laneStartCriticalPath;
 
 		srcFileName = "FixEMethodEvaluator";
 		name << "FixEMethodEvaluator_n_" << n << "_m_" << m
 				<< "_msbInOut_" << vhdlize(msbInOut) << "_lsbInOut_" << vhdlize(lsbInOut);
+		if(nbLanes > 1)
+			name << "_lanes_" << nbLanes;
+		if(foldingFactor > 1)
+			name << "_F_" << foldingFactor;
+		if(segmentBits > 0)
+			name << "_seg_" << segmentBits;
+		if(onlineOutput)
+			name << "_online" << (onlineCompose != "none" ? "_" + onlineCompose : "");
+		if(trimWidths)
+			name << "_trim";
+		if(carrySave)
+			name << "_cs";
+		if(multiples != "mcm")
+			name << "_" << multiples;
 		setName(name.str()+"_uid"+vhdlize(getNewUId()));
 
 		useNumericStd_Signed();
@@ -32,9 +66,13 @@ namespace flopoco {
 		setCopyrightString("Matei Istoan, 2017");
 
 		//safety checks and warnings
-		if(n != m)
-			REPORT(INFO, "WARNING: degree of numerator and of denominator are different! "
-					<< "This will lead to a less efficient implementation.");
+		if(lanesCoeffsP.size() != lanesCoeffsQ.size())
+			THROWERROR("the number of coefficient sets for P and for Q must be the same!");
+		for(size_t lane=0; lane<nbLanes; lane++)
+			if(lanesCoeffsP[lane].size() != lanesCoeffsQ[lane].size())
+				REPORT(INFO, "WARNING: degree of numerator and of denominator are different"
+						<< (nbLanes > 1 ? join(" for lane ", lane) : "") << "! "
+						<< "This will lead to a less efficient implementation.");
 #if RADIX8plusSUPPORT==0
 		if((radix != 2) && (radix != 4) && (radix != 8))
 			THROWERROR("radixes higher than 8 currently not supported!");
@@ -45,33 +83,72 @@ namespace flopoco {
 			THROWERROR("maximum digit larger than the maximum digit in the redundant digit set!");
 		if((delta<0 || delta>1))
 			THROWERROR("delta must be in the interval [0, 1)!");
-
-		//create a copy of the coefficients of P and Q
+		if(foldingFactor < 1)
+			THROWERROR("the folding factor must be at least 1!");
+		if((foldingFactor > 1) && (!target->isPipelined()))
+			THROWERROR("a folded architecture requires a pipelined target!");
+		if((foldingFactor > 1) && (nbLanes > 1))
+			THROWERROR("a folded architecture with several lanes is currently not supported!");
+		if(segmentBits < 0)
+			THROWERROR("the number of segment bits must be positive!");
+		if((segmentBits > 0) && (segmentBits > msbInOut-lsbInOut))
+			THROWERROR("the number of segment bits must be smaller than the size of the input!");
+		if((segmentBits > 0) && (nbSegments != ((size_t)1 << segmentBits)))
+			THROWERROR("a segmented architecture with " << segmentBits << " segment bits requires "
+					<< (1 << segmentBits) << " coefficient sets, but " << nbSegments << " were given!");
+		if((onlineCompose != "none") && (onlineCompose != "add") && (onlineCompose != "mul"))
+			THROWERROR("unknown online composition " << onlineCompose << ", should be none, add or mul!");
+		if(onlineOutput && (foldingFactor > 1))
+			THROWERROR("online output requires an unrolled architecture!");
+		if((onlineCompose != "none") && (!onlineOutput))
+			THROWERROR("an online composition requires online output!");
+		if((onlineCompose != "none") && ((nbLanes != 2) || (radix != 2)))
+			THROWERROR("an online composition is currently only supported for two lanes in radix 2!");
+		if(trimWidths && (foldingFactor > 1))
+			THROWERROR("trimming the widths requires an unrolled architecture!");
+		if(carrySave && (delta <= 0))
+			THROWERROR("carry-save residuals require delta > 0, the margin of the selection for the estimate of the residuals!");
+		if(carrySave && (foldingFactor > 1))
+			THROWERROR("carry-save residuals require an unrolled architecture!");
+		if(carrySave && (segmentBits > 0))
+			THROWERROR("carry-save residuals are currently not supported in segmented mode, where q_i is not a constant!");
+		if(carrySave && (selection != "auto") && (selection != "compressed"))
+			THROWERROR("carry-save residuals only support the compressed selection, on the sum of the top bits of the residuals!");
+		if((multiples != "mcm") && (multiples != "single") && (multiples != "table"))
+			THROWERROR("unknown implementation " << multiples << " of the multiples of X, should be mcm, single or table!");
+
+		//create a copy of the coefficients of P and Q, for each of the lanes
 		copyVectors();
 
-		REPORT(DEBUG, "coefficients of P, as mp numbers:");
-		for(size_t i=0; i<n; i++)
-		{
-			double tmpD = mpfr_get_d(mpCoeffsP[i], GMP_RNDN);
-			REPORT(DEBUG, "" << tmpD);
-		}
-		REPORT(DEBUG, "coefficients of Q, as mp numbers:");
-		for(size_t i=0; i<m; i++)
-		{
-			double tmpD = mpfr_get_d(mpCoeffsQ[i], GMP_RNDN);
-			REPORT(DEBUG, "" << tmpD);
-		}
-
 		//compute the parameters of the algorithm
 		REPORT(DEBUG, "compute the parameters of the algorithm");
 		setAlgorithmParameters();
 
-		//check P's coefficients
-		checkPCoeffs();
-		//check Q's coefficients
-		checkQCoeffs();
-		//check the ranges on the input
-		checkX();
+		//	in segmented mode, the checks are done on the coefficients of all the segments
+		for(size_t lane=0; lane<lanesCoeffsP.size(); lane++)
+		{
+			selectLane(lane);
+
+			REPORT(DEBUG, "coefficients of P, as mp numbers" << (nbLanes > 1 ? join(", lane ", lane) : "") << ":");
+			for(size_t i=0; i<n; i++)
+			{
+				double tmpD = mpfr_get_d(mpCoeffsP[i], GMP_RNDN);
+				REPORT(DEBUG, "" << tmpD);
+			}
+			REPORT(DEBUG, "coefficients of Q, as mp numbers" << (nbLanes > 1 ? join(", lane ", lane) : "") << ":");
+			for(size_t i=0; i<m; i++)
+			{
+				double tmpD = mpfr_get_d(mpCoeffsQ[i], GMP_RNDN);
+				REPORT(DEBUG, "" << tmpD);
+			}
+
+			//check P's coefficients
+			checkPCoeffs();
+			//check Q's coefficients
+			checkQCoeffs();
+			//check the ranges on the input
+			checkX();
+		}
 
 		//compute the number of iterations needed
 		nbIter = msbInOut - lsbInOut + 1;
@@ -82,6 +159,30 @@ namespace flopoco {
 		//g = intlog2(nbIter);
 		g = 0;
 
+		//set the parameters of the folded architecture
+		//	iterations 3 to nbIter-1 are computed by nbFoldedRows rows of CUs,
+		//	reused foldingFactor times
+		if(foldingFactor > 1)
+		{
+			if(nbIter < 5)
+			{
+				REPORT(INFO, "WARNING: not enough iterations to fold, generating an unrolled architecture");
+				foldingFactor = 1;
+			}
+			else
+			{
+				nbFoldedRows = ceil(1.0*(nbIter-3)/foldingFactor);
+				//no pass should be left without work
+				if(foldingFactor != (size_t)ceil(1.0*(nbIter-3)/nbFoldedRows))
+				{
+					foldingFactor = ceil(1.0*(nbIter-3)/nbFoldedRows);
+					REPORT(INFO, "WARNING: folding factor adjusted to " << foldingFactor);
+				}
+				REPORT(INFO, "folded architecture: " << nbFoldedRows << " row(s) of computation units, reused for "
+						<< foldingFactor << " cycles");
+			}
+		}
+
 		//set the format of the internal signals
 		REPORT(DEBUG, "set the format of the internal signals");
 		//	W^Hat
@@ -96,22 +197,61 @@ namespace flopoco {
 		lsbD = 0;
 		dD   = new Signal("dD", Signal::wire, true, msbD, lsbD);
 		//	X
-		msbX = msbInOut;
+		//		in segmented mode, only the offset inside the segment, as a positive signed number
+		msbX = (segmentBits > 0 ? msbInOut-segmentBits+1 : msbInOut);
 		lsbX = lsbInOut;
 		dX   = new Signal("dX", Signal::wire, true, msbX, lsbX);
 		// DiMultX
 		msbDiMX = msbX + (int)ceil(log2(maxDigit));
 		lsbDiMX = lsbX;
 		dDiMX   = new Signal("dDiMX", Signal::wire, true, msbDiMX, lsbDiMX);
+		//	Q
+		//		only used in segmented mode, where |q_i| < alpha <= 1/4
+		msbQ = -1;
+		lsbQ = lsbW;
+		dQ   = new Signal("dQ", Signal::wire, true, msbQ, lsbQ);
 
 		//--------- pipelining
 		setCriticalPath(getMaxInputDelays(inputDelays));
 		//--------- pipelining
 
 		//add the inputs
-		addFixInput("X", true, msbInOut, lsbInOut);
-		//add the outputs
-		addFixOutput("Y", true, msbInOut, lsbInOut, 2);
+		//	in segmented mode, the input is unsigned
+		addFixInput("X", (segmentBits == 0), msbInOut, lsbInOut);
+		//add the outputs, one for each lane
+		for(size_t lane=0; lane<nbLanes; lane++)
+			addFixOutput(laneOutputName(lane), true, msbInOut, lsbInOut, 2);
+		//add the online outputs
+		//	one for each digit of each lane, and for each digit of the composition of the lanes
+		//	the test bench only checks their valid signals, when written at the last cycle of the pipeline
+		if(onlineOutput)
+		{
+			addInput("X_valid");
+			for(size_t lane=0; lane<nbLanes; lane++)
+				for(size_t i=1; i<nbIter; i++)
+				{
+					addOutput(laneOutputName(lane) + join("_D_", i), msbD-lsbD+1, 0);
+					addOutput(laneOutputName(lane) + join("_D_", i, "_valid"), 1, 0, false);
+				}
+			if(onlineCompose != "none")
+			{
+				firstComposedDigit = (onlineCompose == "add" ? -1 : 0);
+				for(int j=firstComposedDigit; j<(int)nbIter; j++)
+				{
+					addOutput(join("S_D_", vhdlize(j)), msbD-lsbD+1, 0);
+					addOutput(join("S_D_", vhdlize(j), "_valid"), 1, 0, false);
+				}
+			}
+		}
+
+		//split the input into the index of the segment and the offset inside the segment
+		if(segmentBits > 0)
+		{
+			vhdl << tab << declare("X_segment", segmentBits) << " <= std_logic_vector(X"
+					<< range(msbInOut-lsbInOut, msbInOut-lsbInOut-segmentBits+1) << ");" << endl;
+			vhdl << tab << declareFixPoint("X_offset", true, msbX, lsbX) << " <= signed('0' & X"
+					<< range(msbInOut-lsbInOut-segmentBits, 0) << ");" << endl;
+		}
 
 		//scale the input X by the factor delta, if necessary
 		if(scaleInput)
@@ -119,20 +259,30 @@ namespace flopoco {
 			int xScaleSize;
 
 			//a helper signal
-			vhdl << tab << declare("X_std_lv", msbX-lsbX+1) << " <= std_logic_vector(X);" << endl;
+			vhdl << tab << declare("X_std_lv", msbX-lsbX+1) << " <= std_logic_vector("
+					<< (segmentBits > 0 ? "X_offset" : "X") << ");" << endl;
 
 			//scale the input
 			//	multiply by inputScaleFactor
 			//		set by default to 1/2*alpha, if not otherwise specified by the user
-			FixRealKCM *scaleMult = new FixRealKCM(
-												 	 target,							//target
-													 true,								//signed input
-													 msbX,								//msbIn
-													 lsbX,								//lsbIn
-													 lsbX-g,							//lsbOut
-													 std::to_string(inputScaleFactor),	//the constant
-													 1.0								//target ulp error
-												 	 );
+			//	the multiplier only depends on its parameters, so it is shared with the identical requests of the design
+			string scaleMultKey = UserInterface::operatorCacheKey(target, "FixRealKCM",
+					join("signedIn=1 msbIn=", msbX, " lsbIn=", lsbX, " lsbOut=", lsbX-g)
+					+ " constant=" + std::to_string(inputScaleFactor) + " targetUlpError=1.0");
+			FixRealKCM *scaleMult = (FixRealKCM*) UserInterface::getCachedOperator(scaleMultKey);
+			if(scaleMult == NULL)
+			{
+				scaleMult = new FixRealKCM(
+											target,								//target
+											true,								//signed input
+											msbX,								//msbIn
+											lsbX,								//lsbIn
+											lsbX-g,								//lsbOut
+											std::to_string(inputScaleFactor),	//the constant
+											1.0									//target ulp error
+											);
+				UserInterface::addToOperatorCache(scaleMultKey, scaleMult);
+			}
 			addSubComponent(scaleMult);
 			inPortMap (scaleMult, "X", "X_std_lv");
 			outPortMap(scaleMult, "R", "X_scaled_int");
@@ -171,7 +321,6 @@ namespace flopoco {
 
 			//update the size of the signals based on X
 			//	X
-			msbX = msbInOut;
 			lsbX = lsbInOut-g;
 			dX   = new Signal("dX", Signal::wire, true, msbX, lsbX);
 			// DiMultX
@@ -183,7 +332,8 @@ namespace flopoco {
 		{
 			//no scaling required
 			//	just copy the input to an intermediate signal
-			vhdl << tab << declare("X_scaled", msbX-lsbX+1) << " <= std_logic_vector(X);" << endl;
+			vhdl << tab << declare("X_scaled", msbX-lsbX+1) << " <= std_logic_vector("
+					<< (segmentBits > 0 ? "X_offset" : "X") << ");" << endl;
 		}
 
 		//a helper signal
@@ -194,8 +344,6 @@ namespace flopoco {
 		//create the DiMX signals
 		REPORT(DEBUG, "create the DiMX signals");
 		addComment(" ---- create the DiMX signals ----", tab);
-		//	the multipliers by constants
-		IntConstMult *dimxMult[maxDigit+1];
 
 		//--------- pipelining
 		currentCycle = getCurrentCycle();
@@ -205,42 +353,8 @@ namespace flopoco {
 		//multiply by the positive constants
 		REPORT(DEBUG, "multiply by the positive constants");
 		addComment(" ---- multiply by the positive constants ----", tab);
-		for(size_t i=0; i<=maxDigit; i++)
-		{
-			//create the multiplication between X and the constant given by i
-			REPORT(DEBUG, "create the multiplication between X and the constant " << i);
-			if(i == 0)
-			{
-				//--------- pipelining
-				manageCriticalPath(target->localWireDelay(), true);
-				//--------- pipelining
+		generateMultiplesOfX(currentCycle, currentCriticalPath);
 
-				vhdl << tab << declareFixPoint(join("X_Mult_", i, "_std_lv"), true, msbDiMX, lsbDiMX)
-						<< " <= " << zg(msbDiMX-lsbDiMX+1) << ";" << endl;
-			}
-			else
-			{
-				//--------- pipelining
-				setCycle(currentCycle);
-				setCriticalPath(currentCriticalPath);
-				//--------- pipelining
-
-				dimxMult[i] = new IntConstMult(
-												target,					//target
-												msbX-lsbX+1,		 	//size of X
-												mpz_class(i)			//the constant
-												);
-				addSubComponent(dimxMult[i]);
-				inPortMap  (dimxMult[i], "X", "X_scaled_std_lv");
-				outPortMap (dimxMult[i], "R", join("X_Mult_", i, "_std_lv"));
-				vhdl << tab << instance(dimxMult[i], join("ConstMult_", i));
-			}
-
-			vhdl << tab << declareFixPoint(join("X_Mult_", i, "_int"), true,
-					getSignalByName(join("X_Mult_", i, "_std_lv"))->width()+lsbX-1, lsbX)
-					<< " <= signed(X_Mult_" << i << "_std_lv);" << endl;
-			resizeFixPoint(join("X_Mult_", i), join("X_Mult_", i, "_int"), msbDiMX, lsbDiMX, 1);
-		}
 		//multiply by the negative constants
 		REPORT(DEBUG, "multiply by the negative constants");
 		addComment(" ---- multiply by the negative constants ----", tab);
@@ -260,89 +374,154 @@ namespace flopoco {
 		manageCriticalPath(target->localWireDelay(msbW-lsbW+1), true);
 		//--------- pipelining
 
+		//create the selection units
+		REPORT(DEBUG, "create the selection unit");
+		GenericSimpleSelectionFunction *sel;
+
+		//	the folded architecture needs a combinatorial selection, so not a ROM in a memory block
+		//	with carry-save residuals, the selection rounds the sum of the top bits of the residuals
+		if(carrySave)
+			selection = "compressed";
+		if(selection == "auto")
+			selection = GenericSimpleSelectionFunction::chooseMethod(target, radix, maxDigit, (foldingFactor == 1));
+		sel = new GenericSimpleSelectionFunction(
+												target,			//target
+												radix,	 		//radix
+												maxDigit, 		//maximum digit
+												dW, 			//signal W
+												selection,		//implementation of the table
+												carrySave,		//carry-save residuals
+												delta			//delta
+												);
+		addSubComponent(sel);
+		REPORT(INFO, "selection function implemented as " << selection
+				<< (carrySave ? ", on carry-save residuals" : ""));
+		reportResidualForm();
+
+		//compute the widths of the computation units
+		computeTruncatedWidths();
+
+		//--------- pipelining
+		laneStartCycle = getCurrentCycle();
+		laneStartCriticalPath = getCriticalPath();
+		//--------- pipelining
+
+		//create the datapath of each of the lanes
+		//	the lanes share the scaled input and its multiples
+		for(size_t lane=0; lane<nbLanes; lane++)
+		{
+			REPORT(DEBUG, "create the datapath of lane " << lane);
+			selectLane(lane);
+			if(nbLanes > 1)
+				addComment(join(" ---- lane ", lane, " ----"), tab);
+
+			//--------- pipelining
+			setCycle(laneStartCycle);
+			setCriticalPath(laneStartCriticalPath);
+			//--------- pipelining
+
+			generateLane(sel);
+		}
+
+		//combine the digits of the lanes online
+		if(onlineCompose != "none")
+			generateOnlineComposition(sel);
+
+		//the folded architecture has already written its result
+		if(foldingFactor == 1)
+		{
+			//--------- pipelining
+			for(size_t lane=0; lane<nbLanes; lane++)
+				syncCycleFromSignal(lanePrefixName(lane) + "sum", true);
+			//	the outputs checked by the test bench must be written in the last cycle
+			if(onlineCompose != "none")
+				for(int j=firstComposedDigit; j<(int)nbIter; j++)
+					syncCycleFromSignal(join("OC_S_", vhdlize(j)), true);
+			//--------- pipelining
+
+			//write the results to the outputs
+			REPORT(DEBUG, "write the results to the outputs, only the bits that we want");
+			for(size_t lane=0; lane<nbLanes; lane++)
+				vhdl << tab << laneOutputName(lane) << " <= " << lanePrefixName(lane) << "sum"
+						<< range(msbInOut-lsbInOut+g, g) << ";" << endl;
+		}
+
+		if(segmentBits > 0)
+		{
+			REPORT(INFO, "segmented architecture: " << nbSegments << " segments, indexed by the top "
+					<< segmentBits << " bits of the input");
+		}
+		if(nbLanes > 1)
+		{
+			REPORT(INFO, "sharing the input stage between " << nbLanes << " lanes saves, compared to "
+					<< nbLanes << " separate operators: "
+					<< (nbLanes-1)*maxDigit << " constant multipliers by the digits, "
+					<< (nbLanes-1)*maxDigit << " negations on " << msbDiMX-lsbDiMX+1 << " bits"
+					<< (scaleInput ? join(", ", nbLanes-1, " input scaling multipliers") : ""));
+		}
+
+		REPORT(DEBUG, "constructor completed");
+	}
+
+
+	void FixEMethodEvaluator::generateLane(GenericSimpleSelectionFunction *sel)
+	{
+		Target *target = getTarget();
+
 		//create the computation units
 		REPORT(DEBUG, "create the computation units");
 		GenericComputationUnit *cu0, *cuI[maxDegree-2], *cuN;
 
 		//target->setPipelined(false);
 
+		//the truncated units of the previous lane have different coefficients
+		laneTruncatedCUs.clear();
+
 		//compute unit 0
 		REPORT(DEBUG, "create the computation unit 0");
-		cu0 = new GenericComputationUnit(
-										target,			//target
-										radix, 			//radix
-										maxDigit,		//maximum digit
-										0,				//index
-										-1,				//special case
-										dW,				//signal W
-										dX,				//signal X
-										dD, 			//signal Di
-										coeffsQ[0]		//constant q_i
-										);
-		addSubComponent(cu0);
+		cu0 = createComputationUnit(0, -1, CU_NO_TRUNCATION);
 		//compute units 1 - n-1
 		for(size_t i=1; i<=(maxDegree-2); i++)
 		{
 			//compute unit i
 			REPORT(DEBUG, "create the computation unit " << i);
-			cuI[i-1] = new GenericComputationUnit(
-												target,			//target
-												radix, 			//radix
-												maxDigit, 		//maximum digit
-												i,				//index
-												0,				//special case
-												dW,				//signal W
-												dX,				//signal X
-												dD, 			//signal Di
-												coeffsQ[i]		//constant q_i
-												);
-			addSubComponent(cuI[i-1]);
+			cuI[i-1] = createComputationUnit(i, 0, CU_NO_TRUNCATION);
 		}
 		//compute unit n
 		REPORT(DEBUG, "create the computation unit n");
-		cuN = new GenericComputationUnit(
-										target,					//target
-										radix, 					//radix
-										maxDigit, 				//maximum digit
-										maxDegree-1,			//index
-										+1,						//special case
-										dW,						//signal W
-										dX,						//signal X
-										dD, 					//signal Di
-										coeffsQ[maxDegree-1]	//constant q_i
-										);
-		addSubComponent(cuN);
+		cuN = createComputationUnit(maxDegree-1, +1, CU_NO_TRUNCATION);
 
-		//create the selection units
-		REPORT(DEBUG, "create the selection unit");
-		GenericSimpleSelectionFunction *sel;
 
-		sel = new GenericSimpleSelectionFunction(
-												target,			//target
-												radix,	 		//radix
-												maxDigit, 		//maximum digit
-												dW 				//signal W
-												);
-		addSubComponent(sel);
+		//iterations 1 and 2 of the segmented architecture
+		//	the residual vector and the digits of iteration 1 are read from the table of coefficients,
+		//	and iteration 2 is done by computation units, as the coefficients are no longer constants
+		if(segmentBits > 0)
+		{
+			generateCoefficientTable();
 
-		//target->setPipelined(true);
+			if(nbIter >= 2)
+				generateIteration(2, cu0, cuI, cuN, sel);
+		}
 
 		//iteration 0
 		//	initialize the elements of the residual vector
-		addComment(" ---- iteration 0 ----", tab);
-		REPORT(DEBUG, "iteration 0");
-		for(size_t i=0; i<maxDegree; i++)
+		if(segmentBits == 0)
 		{
-			vhdl << tab << declareFixPoint(join("W_0_", i), true, msbW, lsbW) << " <= "
-					<< signedFixPointNumber(mpCoeffsP[i], msbW, lsbW, 0) << ";" << endl;
-			vhdl << tab << declareFixPoint(join("D_0_", i), true, msbD, lsbD) << " <= "
-					<< zg(msbD-lsbD+1, 0) << ";" << endl;
+			addComment(" ---- iteration 0 ----", tab);
+			REPORT(DEBUG, "iteration 0");
+			for(size_t i=0; i<maxDegree; i++)
+			{
+				vhdl << tab << declareFixPoint(lanePrefix + join("W_0_", i), true, msbW, lsbW) << " <= "
+						<< signedFixPointNumber(mpCoeffsP[i], msbW, lsbW, 0) << ";" << endl;
+				vhdl << tab << declareFixPoint(lanePrefix + join("D_0_", i), true, msbD, lsbD) << " <= "
+						<< zg(msbD-lsbD+1, 0) << ";" << endl;
+			}
 		}
 
 		//iteration 1
 		//	the elements of the residual vector are the ones at the previous iteration
 		//	shifted by log2(radix) positions to the left
-		if(nbIter >= 1)
+		if((nbIter >= 1) && (segmentBits == 0))
 		{
 			addComment(" ---- iteration 1 ----", tab);
 			REPORT(DEBUG, "iteration 1");
@@ -358,11 +537,11 @@ namespace flopoco {
 				manageCriticalPath(target->localWireDelay(msbW-lsbW+1), true);
 				//--------- pipelining
 
-				vhdl << tab << declareFixPoint(join("W_1_", i), true, msbW, lsbW) << " <= "
+				vhdl << tab << declareFixPoint(lanePrefix + join("W_1_", i), true, msbW, lsbW) << " <= "
 						<< signedFixPointNumber(mpTmp, msbW, lsbW, 0) << ";" << endl;
 
 				//create the selection unit
-				vhdl << tab << declareFixPoint(join("D_1_", i), true, msbD, lsbD) << " <= "
+				vhdl << tab << declareFixPoint(lanePrefix + join("D_1_", i), true, msbD, lsbD) << " <= "
 						<< signedFixPointNumber(mpTmp, msbD, lsbD, 0) << ";" << endl;
 
 				mpfr_clear(mpTmp);
@@ -373,7 +552,7 @@ namespace flopoco {
 		//iteration 2
 		//	the elements of the residual vector and the select digits can almost be pre-computed
 		//	except for the operations including X
-		if(nbIter >= 2)
+		if((nbIter >= 2) && (segmentBits == 0))
 		{
 			addComment(" ---- iteration 2 ----", tab);
 			REPORT(DEBUG, "iteration 2");
@@ -427,13 +606,13 @@ namespace flopoco {
 				//--------- pipelining
 
 				//create the signal for the sum
-				vhdl << tab << declareFixPoint(join("sum_2_", i), true, msbW, lsbW) << " <= "
+				vhdl << tab << declareFixPoint(lanePrefix + join("sum_2_", i), true, msbW, lsbW) << " <= "
 						<< signedFixPointNumber(mpSum, msbW, lsbW, 0) << ";" << endl;
 
 				//create the signal for x*d_{i+1}^{(1)}
 				if(i < (maxDegree-1))
 				{
-					resizeFixPoint(join("sum_2_", i, "_term2"),
+					resizeFixPoint(lanePrefix + join("sum_2_", i, "_term2"),
 							join("X_Mult_", vhdlize(sv_d_ip1.get_d())), msbW, lsbW, 1);
 				}
 
@@ -444,165 +623,59 @@ namespace flopoco {
 				//create w_i^{(2)}
 				if(i < (maxDegree-1))
 				{
-					vhdl << tab << declareFixPoint(join("W_2_", i, "_int"), true, msbW, lsbW) << " <= "
-							<< "sum_2_" << i << " + "
-							<< "sum_2_" << i << "_term2"
+					vhdl << tab << declareFixPoint(lanePrefix + join("W_2_", i, "_int"), true, msbW, lsbW) << " <= "
+							<< lanePrefix << "sum_2_" << i << " + "
+							<< lanePrefix << "sum_2_" << i << "_term2"
 							<< ";" << endl;
 				}
-				vhdl << tab << declareFixPoint(join("W_2_", i), true, msbW, lsbW) << " <= ";
+				vhdl << tab << declareFixPoint(lanePrefix + join("W_2_", i), true, msbW, lsbW) << " <= ";
 				if(i < (maxDegree-1))
 				{
-					vhdl << "W_2_" << i << "_int";
+					vhdl << lanePrefix << "W_2_" << i << "_int";
 				}
 				else
 				{
-					vhdl << "sum_2_" << i;
+					vhdl << lanePrefix << "sum_2_" << i;
 				}
 				vhdl << range(msbW-lsbW-ceil(log2(radix)), 0) << " & " << zg(ceil(log2(radix))) << ";" << endl;
-
-				//create the selection unit
-				//inputs
-				inPortMap(sel,  "W", join("W_2_", i));
-				//outputs
-				outPortMap(sel, "D", join("D_2_", i));
-				//the instance
-				vhdl << tab << instance(sel, join("SEL_2_", i));
+				//	the residuals of iteration 2 are not redundant: their carry bits are zero
+				if(carrySave)
+					vhdl << tab << declareFixPoint(lanePrefix + join("WC_2_", i), true, msbW, lsbW) << " <= "
+							<< zg(msbW-lsbW+1, 0) << ";" << endl;
 
 				mpfr_clears(mpTmp, mpSum, w_i, d_0, d_i, d_ip1, (mpfr_ptr)nullptr);
 			}
+
+			//create the selection units
+			vector<size_t> selIndices;
+			for(size_t i=0; i<maxDegree; i++)
+				selIndices.push_back(i);
+			instanceSelections(sel, selIndices, lanePrefix + "W_2_", lanePrefix + "D_2_", lanePrefix + "SEL_2_",
+					-1, (carrySave ? lanePrefix + "WC_2_" : ""));
 		}
 
 		//--------- pipelining
 		nextCycle(true);
 		//--------- pipelining
 
+		//the folded architecture handles iterations 3 to nbIter-1 and the final result
+		if(foldingFactor > 1)
+		{
+			generateFoldedIterations(cu0, cuI, cuN, sel);
+
+			return;
+		}
+
 		//iterations 3 to nbIter
 		REPORT(DEBUG, "iterations 1 to nbIter");
 		for(size_t iter=3; iter<=nbIter; iter++)
 		{
-			REPORT(DEBUG, "iteration " << iter);
-			addComment(join(" ---- iteration ", iter, " ----"), tab);
-
-			//--------- pipelining
-			if(iter > 2)
-			{
-				for(size_t i=0; i<maxDegree; i++)
-				{
-					//after iteration nbIter-m, we can stop generating some of the SELs
-					if((i > nbIter-iter) && (iter > nbIter-maxDegree))
-						continue;
-
-					syncCycleFromSignal(join("W_", iter-1, "_0"), true);
-					syncCycleFromSignal(join("D_", iter-1, "_0"), true);
-				}
-				setCriticalPath(sel->getOutDelayMap()["D"]);
-			}
-			//--------- pipelining
-
-			//create computation unit index 0
-			REPORT(DEBUG, "create computation unit index 0");
-			//	a special case
-			//inputs
-			inPortMap(cu0, "Wi",   join("W_", iter-1, "_0"));
-			inPortMap(cu0, "D0",   join("D_", iter-1, "_0"));
-			inPortMap(cu0, "Di",   join("D_", iter-1, "_0"));
-			inPortMap(cu0, "Dip1", join("D_", iter-1, "_1"));
-			inPortMap(cu0, "X",    "X_scaled_signed");
-			for(int i=(-(int)maxDigit); i<=(int)maxDigit; i++)
-			{
-				inPortMap(cu0, join("X_Mult_", vhdlize(i)), join("X_Mult_", vhdlize(i)));
-			}
-			//outputs
-			outPortMap(cu0, "Wi_next", join("W_", iter, "_0"));
-			//the instance
-			vhdl << tab << instance(cu0, join("CU_", iter, "_0"));
-
-			//create computation units index 1 to maxDegree-1
-			REPORT(DEBUG, "create computation units index 1 to maxDegree-1");
-			for(size_t i=1; i<=(maxDegree-2); i++)
-			{
-				//after iteration nbIter-m, we can stop generating some of the CUs
-				if((i > nbIter-iter) && (iter > nbIter-maxDegree))
-					break;
-
-				REPORT(DEBUG, "create computation unit index " << i);
-				//inputs
-				inPortMap(cuI[i-1], "Wi",   join("W_", iter-1, "_", i));
-				inPortMap(cuI[i-1], "D0",   join("D_", iter-1, "_0"));
-				inPortMap(cuI[i-1], "Di",   join("D_", iter-1, "_", i));
-				inPortMap(cuI[i-1], "Dip1", join("D_", iter-1, "_", i+1));
-				inPortMap(cuI[i-1], "X",    "X_scaled_signed");
-				for(int j=(-(int)maxDigit); j<=(int)maxDigit; j++)
-				{
-					inPortMap(cuI[i-1], join("X_Mult_", vhdlize(j)), join("X_Mult_", vhdlize(j)));
-				}
-				//outputs
-				outPortMap(cuI[i-1], "Wi_next", join("W_", iter, "_", i));
-				//the instance
-				vhdl << tab << instance(cuI[i-1], join("CU_", iter, "_", i));
-			}
-
-			//after iteration nbIter-m, this CU is no longer needed
-			if(iter <= (nbIter-maxDegree+1))
-			{
-				//create computation unit index maxDegree
-				REPORT(DEBUG, "create computation unit index maxDegree");
-				//	a special case
-				//inputs
-				inPortMap(cuN, "Wi",   join("W_", iter-1, "_", maxDegree-1));
-				inPortMap(cuN, "D0",   join("D_", iter-1, "_0"));
-				inPortMap(cuN, "Di",   join("D_", iter-1, "_", maxDegree-1));
-				inPortMap(cuN, "X",    "X_scaled_signed");
-				//outputs
-				outPortMap(cuN, "Wi_next", join("W_", iter, "_", maxDegree-1));
-				//the instance
-				vhdl << tab << instance(cuN, join("CU_", iter-1, "_", maxDegree-1));
-			}
-
-			//create the selection units index 0 to maxDegree-1
-			REPORT(DEBUG, "create the selection units index 0 to maxDegree-1");
-			for(size_t i=0; i<maxDegree; i++)
-			{
-				//after iteration nbIter-m, we can stop generating some of the SELs
-				if((i > nbIter-iter) && (iter > nbIter-maxDegree))
-					continue;
-
-				REPORT(DEBUG, "create the selection unit " << i);
-
-				//--------- pipelining
-				setCycleFromSignal(join("W_", iter, "_", i), true);
-				setCriticalPath(cu0->getOutDelayMap()["Wi_next"]);
-				//--------- pipelining
-
-				//inputs
-				inPortMap(sel,  "W", join("W_", iter, "_", i));
-				//outputs
-				outPortMap(sel, "D", join("D_", iter, "_", i));
-				//the instance
-				vhdl << tab << instance(sel, join("SEL_", iter, "_", i));
-			}
-
-			//--------- pipelining
-			for(size_t i=0; i<maxDegree; i++)
-			{
-				//after iteration nbIter-m, we can stop generating some of the SELs
-				if((i > nbIter-iter) && (iter > nbIter-maxDegree))
-					continue;
-
-				syncCycleFromSignal(join("D_", iter, "_", i), true);
-			}
-			setCriticalPath(sel->getOutDelayMap()["D"]);
-
-			//if((iter > 2) && (iter%2 == 0))
-			//if((iter > 2) && (iter%3 == 0))
-			//if((iter > 2) && (iter%4 == 0))
-				nextCycle(true);
-			//--------- pipelining
+			generateIteration(iter, cu0, cuI, cuN, sel);
 		}
 
 		//--------- pipelining
-		syncCycleFromSignal(join("W_", nbIter, "_0"), true);
-		syncCycleFromSignal(join("D_", nbIter, "_0"), true);
+		syncCycleFromSignal(lanePrefix + join("W_", nbIter, "_0"), true);
+		syncCycleFromSignal(lanePrefix + join("D_", nbIter, "_0"), true);
 		setCriticalPath(sel->getOutDelayMap()["D"]);
 		//--------- pipelining
 
@@ -627,7 +700,7 @@ namespace flopoco {
 			REPORT(DEBUG, "adding D_" << i << "_" << 0 << " at weight " << (nbIter-1-i)*ceil(log2(radix)));
 			bitheap->addSignedBitVector(
 										(nbIter-1-i)*ceil(log2(radix)),			//weight
-										join("D_", i, "_", 0),					//input signal name
+										lanePrefix + join("D_", i, "_", 0),					//input signal name
 										msbD-lsbD+1								//size
 										);
 			*/
@@ -635,7 +708,7 @@ namespace flopoco {
 			REPORT(DEBUG, "adding D_" << i << "_" << 0 << " at weight " << (nbIter+g-1-i)*ceil(log2(radix)));
 			bitheap->addSignedBitVector(
 										(nbIter+g-1-i)*ceil(log2(radix)),		//weight
-										join("D_", i, "_", 0),					//input signal name
+										lanePrefix + join("D_", i, "_", 0),					//input signal name
 										msbD-lsbD+1								//size
 										);
 
@@ -653,141 +726,1229 @@ namespace flopoco {
 
 		//retrieve the bits we want from the bit heap
 		REPORT(DEBUG, "retrieve the bits from the bit heap");
-		vhdl << tab << declareFixPoint("sum", true, msbW, lsbW) << " <= signed(" <<
+		vhdl << tab << declareFixPoint(lanePrefix + "sum", true, msbW, lsbW) << " <= signed(" <<
 				bitheap->getSumName() << range(msbW-lsbW, 0) << ");" << endl;
 
-		//write the result to the output
-		REPORT(DEBUG, "write the result to the output, only the bits that we want");
-		vhdl << tab << "Y <= sum" << range(msbInOut-lsbInOut+g, g) << ";" << endl;
-
-		REPORT(DEBUG, "constructor completed");
+		//output the digits of the result, as soon as they are available
+		if(onlineOutput)
+			generateOnlineDigits();
 	}
 
 
-	FixEMethodEvaluator::~FixEMethodEvaluator()
+	GenericComputationUnit* FixEMethodEvaluator::createComputationUnit(size_t index, int specialCase, int lsbTrunc)
 	{
-		for(size_t i=0; i<maxDegree; i++)
-		{
-			mpfr_clear(mpCoeffsP[i]);
-			mpfr_clear(mpCoeffsQ[i]);
-		}
+		GenericComputationUnit *cu;
+
+		//	in segmented mode, q_i is read from the table of coefficients
+		if((segmentBits > 0) && (specialCase != -1))
+			cu = new GenericComputationUnit(
+											getTarget(),	//target
+											radix, 			//radix
+											maxDigit,		//maximum digit
+											index,			//index
+											specialCase,	//special case
+											dW,				//signal W
+											dX,				//signal X
+											dD, 			//signal Di
+											dQ,				//signal Qi
+											lsbTrunc		//truncation LSB
+											);
+		else
+			cu = new GenericComputationUnit(
+											getTarget(),	//target
+											radix, 			//radix
+											maxDigit,		//maximum digit
+											index,			//index
+											specialCase,	//special case
+											dW,				//signal W
+											dX,				//signal X
+											dD, 			//signal Di
+											coeffsQ[index],	//constant q_i
+											lsbTrunc,		//truncation LSB
+											carrySave		//carry-save residuals
+											);
+		addSubComponent(cu);
+
+		return cu;
 	}
 
 
-	void FixEMethodEvaluator::copyVectors()
+	GenericComputationUnit* FixEMethodEvaluator::getComputationUnit(size_t iter, size_t index, int specialCase,
+			GenericComputationUnit *cu)
 	{
-		size_t iterLimit = coeffsP.size();
-
-		//copy the coefficients of P
-		for(size_t i=0; i<iterLimit; i++)
-		{
-			//create a copy as MPFR
-			mpfr_init2(mpCoeffsP[i], LARGEPREC);
-			//	parse the constant using Sollya
-			sollya_obj_t node;
-			node = sollya_lib_parse_string(coeffsP[i].c_str());
-			/* If  parse error throw an exception */
-			if (sollya_lib_obj_is_error(node))
-			{
-				THROWERROR("emulate: Unable to parse string "<< coeffsP[i] << " as a numeric constant");
-			}
-			sollya_lib_get_constant(mpCoeffsP[i], node);
-			free(node);
-		}
-		//fill with zeros, if necessary
-		for(size_t i=iterLimit; i<maxDegree; i++)
-		{
-			//create a copy as string
-			coeffsP.push_back(string("0"));
+		string key;
 
-			//create a copy as MPFR
-			mpfr_init2(mpCoeffsP[i], LARGEPREC);
-			mpfr_set_zero(mpCoeffsP[i], 0);
-		}
+		if(cuLsbTrunc[iter][index] == CU_NO_TRUNCATION)
+			return cu;
 
-		iterLimit = coeffsQ.size();
-		//copy the coefficients of Q
-		for(size_t i=0; i<iterLimit; i++)
+		//the truncated units are shared by all the iterations using the same LSB
+		key = join("CU_", index, "_", specialCase, "_", cuLsbTrunc[iter][index]);
+		if(laneTruncatedCUs.find(key) == laneTruncatedCUs.end())
 		{
-			//create a copy as MPFR
-			mpfr_init2(mpCoeffsQ[i], LARGEPREC);
-			//	parse the constant using Sollya
-			sollya_obj_t node;
-			node = sollya_lib_parse_string(coeffsQ[i].c_str());
-			/* If  parse error throw an exception */
-			if (sollya_lib_obj_is_error(node))
-			{
-				THROWERROR("emulate: Unable to parse string "<< coeffsQ[i] << " as a numeric constant");
-			}
-			sollya_lib_get_constant(mpCoeffsQ[i], node);
-			free(node);
+			REPORT(DEBUG, "create the computation unit " << index << " truncated to lsb=" << cuLsbTrunc[iter][index]);
+			laneTruncatedCUs[key] = createComputationUnit(index, specialCase, cuLsbTrunc[iter][index]);
 		}
-		//fill with zeros, if necessary
-		for(size_t i=iterLimit; i<maxDegree; i++)
-		{
-			//create a copy as string
-			coeffsQ.push_back(string("0"));
 
-			//create a copy as MPFR
-			mpfr_init2(mpCoeffsQ[i], LARGEPREC);
-			mpfr_set_zero(mpCoeffsQ[i], 0);
-		}
+		return laneTruncatedCUs[key];
 	}
 
 
-	void FixEMethodEvaluator::setAlgorithmParameters()
+	void FixEMethodEvaluator::generateMultiplesOfX(int startCycle, double startCriticalPath)
 	{
-		//set xi
-		//	this is only for radix 2
-		//xi    = 0.5  * (1+delta);
-		//	generic case
-		xi    = 0.5  * (1.0+delta);
-		//set alpha
-		//	this is only for radix 2
-		//alpha = 0.25 * (1-delta);
-		//	generic case
-		alpha = (1.0/(2*radix)) * (1.0-delta);
-		//set the scale factor
-		//	compute the value of the scale factor in two cases:
-		//	1) when scaling is required, and it hasn't been set by the user
-		//	2) when scaling isn't required, for the analysis of the parameters
-		if(((scaleInput == true) && (inputScaleFactor == -1)) || (scaleInput == false))
-		{
-			//if the scale factor needs to be automatically be set,
-			//	then set if to the maximum admissible limit
-			//	we need to first determine the maximum value of the coefficients of Q,
-			//	and then subtract it from alpha
-			mpfr_t mpTmp, mpTmp2, mpAlpha;
+		Target *target = getTarget();
+		int wX = msbX-lsbX+1;
+		int wDiMX = msbDiMX-lsbDiMX+1;
+		vector<size_t> oddMultiples;
+		int mcmAdders = -1;
 
-			mpfr_inits2(LARGEPREC, mpTmp, mpTmp2, mpAlpha, (mpfr_ptr)nullptr);
+		//--------- pipelining
+		manageCriticalPath(target->localWireDelay(), true);
+		//--------- pipelining
 
-			mpfr_set_zero(mpTmp, 0);
-			for(size_t i=1; i<m; i++)
+		vhdl << tab << declareFixPoint("X_Mult_0", true, msbDiMX, lsbDiMX) << " <= " << zg(wDiMX) << ";" << endl;
+
+		//the odd multiples, the even ones being shifts of them
+		for(size_t i=3; i<=maxDigit; i+=2)
+			oddMultiples.push_back(i);
+
+		if(multiples == "single")
+		{
+			//a constant multiplier for each of the multiples, as unsigned products of X
+			for(size_t i=1; i<=maxDigit; i++)
 			{
-				mpfr_abs(mpTmp2, mpTmp, GMP_RNDN);
-				if(mpfr_cmp(mpTmp2, mpTmp) > 0)
-					mpfr_set(mpTmp, mpTmp2, GMP_RNDN);
-			}
+				//--------- pipelining
+				setCycle(startCycle);
+				setCriticalPath(startCriticalPath);
+				//--------- pipelining
 
-			mpfr_set_d(mpAlpha, alpha, GMP_RNDN);
+				string dimxMultKey = UserInterface::operatorCacheKey(target, "IntConstMult", join("wIn=", wX, " n=", i));
+				IntConstMult *dimxMult = (IntConstMult*) UserInterface::getCachedOperator(dimxMultKey);
+				if(dimxMult == NULL)
+				{
+					dimxMult = new IntConstMult(
+												target,					//target
+												wX,		 				//size of X
+												mpz_class(i)			//the constant
+												);
+					UserInterface::addToOperatorCache(dimxMultKey, dimxMult);
+				}
+				addSubComponent(dimxMult);
+				inPortMap  (dimxMult, "X", "X_scaled_std_lv");
+				outPortMap (dimxMult, "R", join("X_Mult_", i, "_uns"));
+				vhdl << tab << instance(dimxMult, join("ConstMult_", i));
 
-			mpfr_sub(mpTmp, mpAlpha, mpTmp, GMP_RNDN);
-			inputScaleFactor = mpfr_get_d(mpTmp, GMP_RNDN);
+				//--------- pipelining
+				syncCycleFromSignal(join("X_Mult_", i, "_uns"), true);
+				setCriticalPath(dimxMult->getOutDelayMap()["R"]);
+				//--------- pipelining
 
-			mpfr_clears(mpTmp, mpTmp2, mpAlpha, (mpfr_ptr)nullptr);
+				generateSignedMultiple(i, join("X_Mult_", i, "_uns"), getSignalByName(join("X_Mult_", i, "_uns"))->width());
+			}
 		}
-	}
+		else if((multiples == "mcm") && (oddMultiples.size() > 0))
+		{
+			//the odd multiples in a single multiple constant multiplier, sharing the intermediate sums
+			vector<mpz_class> constants;
+			ostringstream constantList;
 
+			for(size_t c : oddMultiples)
+			{
+				constants.push_back(mpz_class(c));
+				constantList << " " << c;
+			}
 
-	void FixEMethodEvaluator::checkPCoeffs()
-	{
-		mpfr_t mpXi;
+			//--------- pipelining
+			setCycle(startCycle);
+			setCriticalPath(startCriticalPath);
+			//--------- pipelining
 
-		mpfr_init2(mpXi, LARGEPREC);
-		mpfr_set_d(mpXi, xi, GMP_RNDN);
-		//check that the coefficients of P are smaller than xi
-		for(size_t i=0; i<maxDegree; i++)
-		{
+			string mcmKey = UserInterface::operatorCacheKey(target, "IntConstMCM", join("wIn=", wX) + " n=" + constantList.str());
+			IntConstMCM *mcm = (IntConstMCM*) UserInterface::getCachedOperator(mcmKey);
+			if(mcm == NULL)
+			{
+				mcm = new IntConstMCM(target, wX, constants.size(), constants);
+				UserInterface::addToOperatorCache(mcmKey, mcm);
+			}
+			addSubComponent(mcm);
+			inPortMap(mcm, "X", "X_scaled_std_lv");
+			for(size_t j=0; j<oddMultiples.size(); j++)
+				outPortMap(mcm, join("R", j), join("X_Mult_", oddMultiples[j], "_uns"));
+			vhdl << tab << instance(mcm, "ConstMCM");
+
+			for(size_t j=0; j<oddMultiples.size(); j++)
+			{
+				//--------- pipelining
+				setCycleFromSignal(join("X_Mult_", oddMultiples[j], "_uns"), true);
+				setCriticalPath(mcm->getOutDelayMap()[join("R", j)]);
+				//--------- pipelining
+
+				generateSignedMultiple(oddMultiples[j], join("X_Mult_", oddMultiples[j], "_uns"), mcm->rsizes[j]);
+			}
+
+			//the adders of the merged shift-and-add graphs, and those summing the heads of each graph
+			set<string> visited;
+			std::function<int(ShiftAddOp*)> countAdders = [&](ShiftAddOp *sao) -> int
+			{
+				if((sao == NULL) || (sao->op == ShiftAddOpType::X) || visited.count(sao->name))
+					return 0;
+				visited.insert(sao->name);
+				return (sao->op == ShiftAddOpType::Shift ? 0 : 1) + countAdders(sao->i)
+						+ ((sao->j != sao->i) ? countAdders(sao->j) : 0);
+			};
+			mcmAdders = 0;
+			for(ShiftAddDag *dag : mcm->implementations)
+			{
+				for(ShiftAddOp *head : dag->saoHeadlist)
+					mcmAdders += countAdders(head);
+				mcmAdders += dag->saoHeadlist.size()-1;
+			}
+		}
+		else if((multiples == "table") && (oddMultiples.size() > 0))
+		{
+			//the odd multiples in a table indexed by X, as signed products
+			vector<mpz_class> values;
+
+			if(wX > 12)
+				THROWERROR("a table of the multiples of X requires an input of at most 12 bits, X has " << wX << " bits!");
+			for(mpz_class x=0; x<(mpz_class(1) << wX); x++)
+			{
+				mpz_class value = 0, signedX = (x >= (mpz_class(1) << (wX-1)) ? x - (mpz_class(1) << wX) : x);
+
+				for(size_t j=0; j<oddMultiples.size(); j++)
+				{
+					mpz_class product = mpz_class(oddMultiples[j]) * signedX;
+
+					if(product < 0)
+						product += (mpz_class(1) << wDiMX);
+					value += product << (j*wDiMX);
+				}
+				values.push_back(value);
+			}
+
+			//--------- pipelining
+			setCycle(startCycle);
+			setCriticalPath(startCriticalPath);
+			//--------- pipelining
+
+			GenericTable *multTable = new GenericTable(target, wX, oddMultiples.size()*wDiMX, values);
+			addSubComponent(multTable);
+			inPortMap (multTable, "X", "X_scaled_std_lv");
+			outPortMap(multTable, "Y", "X_Mult_Table");
+			vhdl << tab << instance(multTable, "MultiplesTable");
+
+			//--------- pipelining
+			syncCycleFromSignal("X_Mult_Table", true);
+			setCriticalPath(multTable->getOutDelayMap()["Y"]);
+			//--------- pipelining
+
+			for(size_t j=0; j<oddMultiples.size(); j++)
+				vhdl << tab << declareFixPoint(join("X_Mult_", oddMultiples[j]), true, msbDiMX, lsbDiMX)
+						<< " <= signed(X_Mult_Table" << range((j+1)*wDiMX-1, j*wDiMX) << ");" << endl;
+
+			REPORT(INFO, "table of the multiples of X: " << values.size() << " words of " << oddMultiples.size()*wDiMX << " bits");
+		}
+
+		if(multiples != "single")
+		{
+			//--------- pipelining
+			setCycle(startCycle);
+			setCriticalPath(startCriticalPath);
+			manageCriticalPath(target->localWireDelay(wDiMX), true);
+			//--------- pipelining
+
+			//X itself, sign extended
+			vhdl << tab << declareFixPoint("X_Mult_1", true, msbDiMX, lsbDiMX)
+					<< " <= resize(X_scaled_signed, " << wDiMX << ");" << endl;
+
+			//the even multiples, as shifts of the odd ones
+			for(size_t i=2; i<=maxDigit; i+=2)
+			{
+				size_t odd = i;
+				int shift = 0;
+
+				while((odd & 1) == 0)
+				{
+					odd >>= 1;
+					shift++;
+				}
+
+				//--------- pipelining
+				syncCycleFromSignal(join("X_Mult_", odd), true);
+				//--------- pipelining
+
+				vhdl << tab << declareFixPoint(join("X_Mult_", i), true, msbDiMX, lsbDiMX)
+						<< " <= X_Mult_" << odd << range(wDiMX-1-shift, 0) << " & " << zg(shift) << ";" << endl;
+			}
+		}
+
+		//the number of adders of the multiples, compared to a constant multiplier for each of them
+		if(multiples == "mcm")
+		{
+			REPORT(INFO, "multiples of X: " << (mcmAdders < 0 ? 0 : mcmAdders) << " adders in the multiple constant multiplier, "
+					<< "against about " << countMultiplesAdders(maxDigit, "single") << " with a constant multiplier for each multiple "
+					<< "(at least " << countMultiplesAdders(maxDigit, "mcm") << " are needed)");
+		}
+		else
+		{
+			REPORT(INFO, "multiples of X: about " << countMultiplesAdders(maxDigit, multiples) << " adders, "
+					<< "against at least " << countMultiplesAdders(maxDigit, "mcm") << " with a multiple constant multiplier");
+		}
+	}
+
+
+	void FixEMethodEvaluator::generateSignedMultiple(size_t c, string product, int productWidth)
+	{
+		Target *target = getTarget();
+		int wX = msbX-lsbX+1;
+		int wDiMX = msbDiMX-lsbDiMX+1;
+		int wHigh = wDiMX-wX;
+
+		//the product is unsigned, of the bits U of X: c*X = c*U - c*2^wX when X is negative,
+		//	so only the bits above wX are corrected
+		if(productWidth <= wX)
+		{
+			vhdl << tab << declareFixPoint(join("X_Mult_", c), true, msbDiMX, lsbDiMX)
+					<< " <= resize(signed(" << product << range(wX-1, 0) << "), " << wDiMX << ");" << endl;
+			return;
+		}
+
+		//--------- pipelining
+		manageCriticalPath(target->adderDelay(wHigh), true);
+		//--------- pipelining
+
+		vhdl << tab << declare(join("X_Mult_", c, "_corr"), wHigh) << " <= \""
+				<< unsignedBinary(mpz_class(c) % (mpz_class(1) << wHigh), wHigh) << "\" when X_scaled_std_lv(" << wX-1 << ")='1' else "
+				<< zg(wHigh) << ";" << endl;
+		vhdl << tab << declare(join("X_Mult_", c, "_high"), wHigh) << " <= std_logic_vector(unsigned("
+				<< (wHigh > productWidth-wX ? zg(wHigh-(productWidth-wX)) + " & " : "")
+				<< product << range(productWidth-1, wX) << ") - unsigned(X_Mult_" << c << "_corr));" << endl;
+		vhdl << tab << declareFixPoint(join("X_Mult_", c), true, msbDiMX, lsbDiMX)
+				<< " <= signed(X_Mult_" << c << "_high & " << product << range(wX-1, 0) << ");" << endl;
+	}
+
+
+	int FixEMethodEvaluator::countMultiplesAdders(int maxDigit, string method)
+	{
+		int adders = 0;
+
+		if(method == "table")
+			return 0;
+		for(int k=3; k<=maxDigit; k++)
+		{
+			if(method == "single")
+			{
+				//an adder per non-zero digit of the constant in CSD, but the first
+				int nonZeroDigits = 0;
+				for(int c=k; c != 0; c >>= 1)
+					if(c & 1)
+					{
+						nonZeroDigits++;
+						//the digit is -1 at the end of a run of ones
+						c += ((c & 3) == 3 ? 1 : -1);
+					}
+				adders += nonZeroDigits-1;
+			}
+			else if(k & 1)
+			{
+				//an adder per odd multiple, from X and a smaller odd multiple: k = 2^s*a +- b
+				adders++;
+			}
+		}
+
+		return adders;
+	}
+
+
+	void FixEMethodEvaluator::reportResidualForm()
+	{
+		Target *target = getTarget();
+		int width = maxInt(3, msbW, msbX, msbD) - minInt(3, lsbW, lsbX, lsbD) + 1;
+		int widthQ = (segmentBits > 0 ? msbQ-lsbQ+1 : 0);
+		//	carry-save residuals need a margin for the estimate of the selection, and constant coefficients
+		int nbForms = ((delta > 0) && (segmentBits == 0) ? 2 : 1);
+		double delay[2], lut[2];
+
+		//the estimates of an iteration of a lane, for the residuals in non-redundant (0) and carry-save (1) form
+		for(int form=0; form<nbForms; form++)
+		{
+			bool cs = (form == 1);
+
+			delay[form] = GenericComputationUnit::estimateDelay(target, maxDigit, 0, width, cs)
+					+ GenericSimpleSelectionFunction::estimateDelay(target, radix, maxDigit, cs, delta);
+			lut[form] = GenericComputationUnit::estimateLUTs(target, maxDigit, -1, width, msbDiMX-lsbDiMX+1, widthQ, msbD-lsbD+1, cs);
+			if(maxDegree > 2)
+				lut[form] += (maxDegree-2) * GenericComputationUnit::estimateLUTs(target, maxDigit, 0, width,
+						msbDiMX-lsbDiMX+1, widthQ, msbD-lsbD+1, cs);
+			if(maxDegree > 1)
+				lut[form] += GenericComputationUnit::estimateLUTs(target, maxDigit, 1, width,
+						msbDiMX-lsbDiMX+1, widthQ, msbD-lsbD+1, cs);
+			lut[form] += maxDegree * GenericSimpleSelectionFunction::estimateLUTs(target, radix, maxDigit,
+					(cs ? "compressed" : selection), cs, delta);
+		}
+
+		REPORT(INFO, "residuals in " << (carrySave ? "carry-save" : "non-redundant") << " form: "
+				<< "estimated delay of an iteration " << std::setprecision(3) << delay[carrySave]*1e9 << "ns ("
+				<< 1e-6/delay[carrySave] << "MHz), " << lut[carrySave] << " LUTs per iteration");
+		if(nbForms == 2)
+			REPORT(INFO, "  in " << (carrySave ? "non-redundant" : "carry-save") << " form: "
+					<< std::setprecision(3) << delay[!carrySave]*1e9 << "ns (" << 1e-6/delay[!carrySave] << "MHz), "
+					<< lut[!carrySave] << " LUTs per iteration");
+	}
+
+
+	void FixEMethodEvaluator::computeTruncatedWidths()
+	{
+		//the lanes may have different degrees, and so different units and error bounds
+		//	in segmented mode, the segments share the datapath of lane 0
+		lanesCuLsbTrunc.clear();
+		for(size_t lane=0; lane<nbLanes; lane++)
+		{
+			selectLane(lane);
+			computeLaneTruncatedWidths(lane);
+			lanesCuLsbTrunc.push_back(cuLsbTrunc);
+		}
+		selectLane(0);
+	}
+
+
+	void FixEMethodEvaluator::computeLaneTruncatedWidths(size_t lane)
+	{
+		Target *target = getTarget();
+		int log2Radix = ceil(log2(radix));
+		int msbInt = maxInt(3, msbW, msbX, msbD);
+		int lsbInt = minInt(3, lsbW, lsbX, lsbD);
+		int lsbMax = lsbWHat - 4 - log2Radix;
+		int nbTruncatedTerms = (carrySave ? 4 : 3);
+		double qMin, budget, errorBound, uniformDelay, trimmedDelay;
+		size_t nbUnits, nbTruncatedUnits, uniformBits, trimmedBits;
+
+		//the units generated by generateIteration
+		auto isUnitUsed = [this](size_t iter, size_t i) -> bool
+		{
+			if(i == 0)
+				return true;
+			if(i < (maxDegree-1))
+				return !((i > nbIter-iter) && (iter > nbIter-maxDegree));
+			return (iter <= (nbIter-maxDegree+1));
+		};
+
+		//by default, none of the units are truncated
+		cuLsbTrunc.assign(nbIter+1, vector<int>(maxDegree, CU_NO_TRUNCATION));
+		if(!trimWidths)
+			return;
+
+		REPORT(DEBUG, "compute the widths of the computation units");
+
+		//the smallest value of |Q(x)|, over the coefficients of the lane, or of all the segments
+		//	|x| < alpha, so |Q(x)| >= 1 - sum(|q_i|*alpha^i)
+		qMin = 1.0;
+		for(size_t set=(segmentBits > 0 ? 0 : lane); set<(segmentBits > 0 ? nbSegments : lane+1); set++)
+		{
+			double sum = 0.0, alphaPow = 1.0;
+
+			selectLane(set);
+			for(size_t i=1; i<m; i++)
+			{
+				alphaPow *= alpha;
+				sum += fabs(mpfr_get_d(mpCoeffsQ[i], GMP_RNDN)) * alphaPow;
+			}
+			if(1.0-sum < qMin)
+				qMin = 1.0-sum;
+		}
+		selectLane(lane);
+		if(qMin <= 0)
+		{
+			REPORT(INFO, "WARNING: Q(x) cannot be bounded away from zero, the widths are not trimmed"
+					<< (nbLanes > 1 ? join(" in lane ", lane) : ""));
+			return;
+		}
+
+		//the error budget of each unit, as a power of 2
+		//	the total error should stay under 2^lsbW / (2*r)
+		nbUnits = 0;
+		for(size_t iter=3; iter<=nbIter; iter++)
+			for(size_t i=0; i<maxDegree; i++)
+				if(isUnitUsed(iter, i))
+					nbUnits++;
+		if(nbUnits == 0)
+			return;
+		budget = lsbW - 1 - log2Radix - log2(nbUnits);
+
+		//compute the LSB of each unit
+		//	a unit truncated to lsb t adds an error of at most (maxDigit+3)*2^t to its sum,
+		//	(maxDigit+4)*2^t in carry-save form, where the carry bits of the residual are also truncated,
+		//	so at most r*(maxDigit+3)*2^t to w_i[iter],
+		//	and at most r*(maxDigit+3)*2^t * r^-iter * alpha^i / qMin to the result
+		nbTruncatedUnits = 0;
+		errorBound = 0.0;
+		uniformBits = 0;
+		trimmedBits = 0;
+		uniformDelay = 0.0;
+		trimmedDelay = 0.0;
+		for(size_t iter=3; iter<=nbIter; iter++)
+		{
+			int minLsbIter = msbInt;
+
+			for(size_t i=0; i<maxDegree; i++)
+			{
+				int lsb;
+
+				if(!isUnitUsed(iter, i))
+					continue;
+
+				lsb = floor(budget - log2Radix - log2(maxDigit+nbTruncatedTerms) + 1.0*iter*log2Radix - i*log2(alpha) + log2(qMin));
+				//	the selection function must still see an accurate estimate of the residual
+				if(lsb > lsbMax)
+					lsb = lsbMax;
+
+				if(lsb > lsbInt)
+				{
+					cuLsbTrunc[iter][i] = lsb;
+					nbTruncatedUnits++;
+					errorBound += radix * (maxDigit+nbTruncatedTerms) * pow(2.0, lsb) * pow(1.0*radix, -1.0*iter) * pow(alpha, 1.0*i) / qMin;
+				}
+				else
+				{
+					lsb = lsbInt;
+				}
+				REPORT(DEBUG, "computation unit " << i << " of iteration " << iter << ": lsb=" << lsb);
+
+				uniformBits += msbInt-lsbInt+1;
+				trimmedBits += msbInt-lsb+1;
+				if(lsb < minLsbIter)
+					minLsbIter = lsb;
+			}
+
+			//	the delay of an iteration is dominated by the final adder of its widest unit
+			uniformDelay += target->adderDelay(msbInt-lsbInt+1);
+			trimmedDelay += target->adderDelay(msbInt-minLsbIter+1);
+		}
+
+		REPORT(INFO, "trimmed widths: " << nbTruncatedUnits << " of the " << nbUnits << " computation units "
+				<< "of iterations 3 to " << nbIter << " are truncated" << (nbLanes > 1 ? join(" in lane ", lane) : ""));
+		REPORT(INFO, "  bits of the sums of the computation units: " << trimmedBits << " instead of " << uniformBits
+				<< " (" << std::setprecision(3) << 100.0*(uniformBits-trimmedBits)/uniformBits << "% less)");
+		//	in carry-save form, the delay of the units does not depend on their width
+		if(!carrySave)
+			REPORT(INFO, "  estimated delay of the iterations: " << std::setprecision(3) << trimmedDelay*1e9
+					<< "ns instead of " << uniformDelay*1e9 << "ns");
+		REPORT(INFO, "  added error at most " << std::setprecision(3) << errorBound*pow(2.0, -lsbW) << " ulp(s) of W");
+	}
+
+
+	void FixEMethodEvaluator::generateCoefficientTable()
+	{
+		int wW = msbW-lsbW+1;
+		int wD = msbD-lsbD+1;
+		int wQ = msbQ-lsbQ+1;
+		int wordSize = maxDegree*(wW+wD) + (maxDegree-1)*wQ;
+		int shift;
+		vector<mpz_class> values;
+
+		//the bits of a value, in two's complement on the format (msb, lsb)
+		auto fixPointBits = [](mpfr_srcptr x, int msb, int lsb) -> mpz_class
+		{
+			mpz_class bits;
+			mpfr_t mpTmp;
+
+			mpfr_init2(mpTmp, LARGEPREC);
+			mpfr_mul_2si(mpTmp, x, -lsb, GMP_RNDN);
+			//	rounding takes place here
+			mpfr_get_z(bits.get_mpz_t(), mpTmp, GMP_RNDN);
+			mpfr_clear(mpTmp);
+
+			if(bits < 0)
+				bits += (mpz_class(1) << (msb-lsb+1));
+			return bits & ((mpz_class(1) << (msb-lsb+1)) - 1);
+		};
+
+		//create the contents of the table
+		//	for each segment: W_1_i and D_1_i for all i, followed by q_i for i>0
+		REPORT(DEBUG, "create the contents of the table of coefficients");
+		for(size_t segment=0; segment<nbSegments; segment++)
+		{
+			mpz_class value = 0;
+
+			selectLane(segment);
+
+			shift = 0;
+			for(size_t i=0; i<maxDegree; i++)
+			{
+				//the elements of the residual vector at iteration 1, and the selected digits
+				mpfr_t mpTmp;
+
+				mpfr_init2(mpTmp, LARGEPREC);
+				mpfr_mul_ui(mpTmp, mpCoeffsP[i], radix, GMP_RNDN);
+
+				value += fixPointBits(mpTmp, msbW, lsbW) << shift;
+				shift += wW;
+				value += fixPointBits(mpTmp, msbD, lsbD) << shift;
+				shift += wD;
+
+				mpfr_clear(mpTmp);
+			}
+			for(size_t i=1; i<maxDegree; i++)
+			{
+				value += fixPointBits(mpCoeffsQ[i], msbQ, lsbQ) << shift;
+				shift += wQ;
+			}
+
+			values.push_back(value);
+		}
+		selectLane(0);
+
+		//create the table
+		REPORT(DEBUG, "create the table of coefficients");
+		addComment(" ---- table of the coefficients of the segments ----", tab);
+		GenericTable *coeffTable = new GenericTable(getTarget(), segmentBits, wordSize, values);
+		addSubComponent(coeffTable);
+		inPortMap (coeffTable, "X", "X_segment");
+		outPortMap(coeffTable, "Y", "SegmentCoeffs");
+		vhdl << tab << instance(coeffTable, "SegmentCoeffTable");
+
+		//--------- pipelining
+		syncCycleFromSignal("SegmentCoeffs", true);
+		setCriticalPath(coeffTable->getOutDelayMap()["Y"]);
+		//--------- pipelining
+
+		//split the output of the table into the residual vector and the digits of iteration 1, and q_i
+		addComment(" ---- iteration 1 ----", tab);
+		shift = 0;
+		for(size_t i=0; i<maxDegree; i++)
+		{
+			vhdl << tab << declareFixPoint(lanePrefix + join("W_1_", i), true, msbW, lsbW) << " <= "
+					<< "signed(SegmentCoeffs" << range(shift+wW-1, shift) << ");" << endl;
+			shift += wW;
+			vhdl << tab << declareFixPoint(lanePrefix + join("D_1_", i), true, msbD, lsbD) << " <= "
+					<< "signed(SegmentCoeffs" << range(shift+wD-1, shift) << ");" << endl;
+			shift += wD;
+		}
+		for(size_t i=1; i<maxDegree; i++)
+		{
+			vhdl << tab << declareFixPoint(lanePrefix + join("Q_", i), true, msbQ, lsbQ) << " <= "
+					<< "signed(SegmentCoeffs" << range(shift+wQ-1, shift) << ");" << endl;
+			shift += wQ;
+		}
+
+		REPORT(INFO, "table of coefficients: " << nbSegments << " words of " << wordSize << " bits");
+	}
+
+
+	void FixEMethodEvaluator::generateIteration(size_t iter, GenericComputationUnit *cu0, GenericComputationUnit **cuI,
+			GenericComputationUnit *cuN, GenericSimpleSelectionFunction *sel)
+	{
+		GenericComputationUnit *cu;
+
+		REPORT(DEBUG, "iteration " << iter);
+		addComment(join(" ---- iteration ", iter, " ----"), tab);
+
+		//--------- pipelining
+		for(size_t i=0; i<maxDegree; i++)
+		{
+			//after iteration nbIter-m, we can stop generating some of the SELs
+			if((i > nbIter-iter) && (iter > nbIter-maxDegree))
+				continue;
+
+			syncCycleFromSignal(lanePrefix + join("W_", iter-1, "_0"), true);
+			syncCycleFromSignal(lanePrefix + join("D_", iter-1, "_0"), true);
+		}
+		setCriticalPath(sel->getOutDelayMap()["D"]);
+		//--------- pipelining
+
+		//create computation unit index 0
+		REPORT(DEBUG, "create computation unit index 0");
+		//	a special case
+		cu = getComputationUnit(iter, 0, -1, cu0);
+		//inputs
+		inPortMap(cu, "Wi",   lanePrefix + join("W_", iter-1, "_0"));
+		if(carrySave)
+			inPortMap(cu, "WiC", lanePrefix + join("WC_", iter-1, "_0"));
+		inPortMap(cu, "D0",   lanePrefix + join("D_", iter-1, "_0"));
+		inPortMap(cu, "Di",   lanePrefix + join("D_", iter-1, "_0"));
+		inPortMap(cu, "Dip1", lanePrefix + join("D_", iter-1, "_1"));
+		inPortMap(cu, "X",    "X_scaled_signed");
+		for(int i=(-(int)maxDigit); i<=(int)maxDigit; i++)
+		{
+			inPortMap(cu, join("X_Mult_", vhdlize(i)), join("X_Mult_", vhdlize(i)));
+		}
+		//outputs
+		outPortMap(cu, "Wi_next", lanePrefix + join("W_", iter, "_0"));
+		if(carrySave)
+			outPortMap(cu, "WiC_next", lanePrefix + join("WC_", iter, "_0"));
+		//the instance
+		vhdl << tab << instance(cu, lanePrefix + join("CU_", iter, "_0"));
+
+		//create computation units index 1 to maxDegree-1
+		REPORT(DEBUG, "create computation units index 1 to maxDegree-1");
+		for(size_t i=1; i<=(maxDegree-2); i++)
+		{
+			//after iteration nbIter-m, we can stop generating some of the CUs
+			if((i > nbIter-iter) && (iter > nbIter-maxDegree))
+				break;
+
+			REPORT(DEBUG, "create computation unit index " << i);
+			cu = getComputationUnit(iter, i, 0, cuI[i-1]);
+			//inputs
+			inPortMap(cu, "Wi",   lanePrefix + join("W_", iter-1, "_", i));
+			if(carrySave)
+				inPortMap(cu, "WiC", lanePrefix + join("WC_", iter-1, "_", i));
+			inPortMap(cu, "D0",   lanePrefix + join("D_", iter-1, "_0"));
+			inPortMap(cu, "Di",   lanePrefix + join("D_", iter-1, "_", i));
+			inPortMap(cu, "Dip1", lanePrefix + join("D_", iter-1, "_", i+1));
+			inPortMap(cu, "X",    "X_scaled_signed");
+			if(segmentBits > 0)
+				inPortMap(cu, "Qi", lanePrefix + join("Q_", i));
+			for(int j=(-(int)maxDigit); j<=(int)maxDigit; j++)
+			{
+				inPortMap(cu, join("X_Mult_", vhdlize(j)), join("X_Mult_", vhdlize(j)));
+			}
+			//outputs
+			outPortMap(cu, "Wi_next", lanePrefix + join("W_", iter, "_", i));
+			if(carrySave)
+				outPortMap(cu, "WiC_next", lanePrefix + join("WC_", iter, "_", i));
+			//the instance
+			vhdl << tab << instance(cu, lanePrefix + join("CU_", iter, "_", i));
+		}
+
+		//after iteration nbIter-m, this CU is no longer needed
+		if(iter <= (nbIter-maxDegree+1))
+		{
+			//create computation unit index maxDegree
+			REPORT(DEBUG, "create computation unit index maxDegree");
+			//	a special case
+			cu = getComputationUnit(iter, maxDegree-1, +1, cuN);
+			//inputs
+			inPortMap(cu, "Wi",   lanePrefix + join("W_", iter-1, "_", maxDegree-1));
+			if(carrySave)
+				inPortMap(cu, "WiC", lanePrefix + join("WC_", iter-1, "_", maxDegree-1));
+			inPortMap(cu, "D0",   lanePrefix + join("D_", iter-1, "_0"));
+			inPortMap(cu, "Di",   lanePrefix + join("D_", iter-1, "_", maxDegree-1));
+			inPortMap(cu, "X",    "X_scaled_signed");
+			if(segmentBits > 0)
+				inPortMap(cu, "Qi", lanePrefix + join("Q_", maxDegree-1));
+			//outputs
+			outPortMap(cu, "Wi_next", lanePrefix + join("W_", iter, "_", maxDegree-1));
+			if(carrySave)
+				outPortMap(cu, "WiC_next", lanePrefix + join("WC_", iter, "_", maxDegree-1));
+			//the instance
+			vhdl << tab << instance(cu, lanePrefix + join("CU_", iter-1, "_", maxDegree-1));
+		}
+
+		//create the selection units index 0 to maxDegree-1
+		REPORT(DEBUG, "create the selection units index 0 to maxDegree-1");
+		vector<size_t> selIndices;
+		for(size_t i=0; i<maxDegree; i++)
+		{
+			//after iteration nbIter-m, we can stop generating some of the SELs
+			if((i > nbIter-iter) && (iter > nbIter-maxDegree))
+				continue;
+
+			selIndices.push_back(i);
+		}
+		instanceSelections(sel, selIndices, lanePrefix + join("W_", iter, "_"), lanePrefix + join("D_", iter, "_"),
+				lanePrefix + join("SEL_", iter, "_"), getComputationUnit(iter, 0, -1, cu0)->getOutDelayMap()["Wi_next"],
+				(carrySave ? lanePrefix + join("WC_", iter, "_") : ""));
+
+		//--------- pipelining
+		for(size_t i=0; i<maxDegree; i++)
+		{
+			//after iteration nbIter-m, we can stop generating some of the SELs
+			if((i > nbIter-iter) && (iter > nbIter-maxDegree))
+				continue;
+
+			syncCycleFromSignal(lanePrefix + join("D_", iter, "_", i), true);
+		}
+		setCriticalPath(sel->getOutDelayMap()["D"]);
+
+		//if((iter > 2) && (iter%2 == 0))
+		//if((iter > 2) && (iter%3 == 0))
+		//if((iter > 2) && (iter%4 == 0))
+			nextCycle(true);
+		//--------- pipelining
+	}
+
+
+	void FixEMethodEvaluator::generateOnlineDigits()
+	{
+		int savedCycle = getCurrentCycle();
+		double savedCriticalPath = getCriticalPath();
+
+		REPORT(DEBUG, "output the digits of the result online");
+		addComment(" ---- online output of the digits of the result ----", tab);
+		for(size_t i=1; i<nbIter; i++)
+		{
+			//--------- pipelining
+			setCycleFromSignal(lanePrefix + join("D_", i, "_0"), false);
+			//--------- pipelining
+
+			vhdl << tab << laneOutput << "_D_" << i << " <= std_logic_vector(" << lanePrefix << "D_" << i << "_0);" << endl;
+			vhdl << tab << laneOutput << "_D_" << i << "_valid <= X_valid;" << endl;
+			onlineValidCycles[laneOutput + join("_D_", i, "_valid")] = getCurrentCycle();
+
+			REPORT(DEBUG, "digit " << i << " of " << laneOutput << " available at cycle " << getCurrentCycle());
+		}
+
+		//--------- pipelining
+		setCycle(savedCycle, false);
+		setCriticalPath(savedCriticalPath);
+		//--------- pipelining
+	}
+
+
+	void FixEMethodEvaluator::instanceSelections(GenericSimpleSelectionFunction *sel, vector<size_t> indices,
+			string wPrefix, string dPrefix, string instancePrefix, double inputCriticalPath, string wcPrefix)
+	{
+		for(size_t i : indices)
+		{
+			REPORT(DEBUG, "create the selection unit " << i);
+
+			//--------- pipelining
+			if(inputCriticalPath >= 0)
+			{
+				setCycleFromSignal(join(wPrefix, (int)i), true);
+				setCriticalPath(inputCriticalPath);
+			}
+			//--------- pipelining
+
+			//inputs
+			inPortMap(sel,  "W", join(wPrefix, (int)i));
+			if(wcPrefix != "")
+				inPortMap(sel, "WC", join(wcPrefix, (int)i));
+			//outputs
+			outPortMap(sel, "D", join(dPrefix, (int)i));
+			//the instance
+			vhdl << tab << instance(sel, join(instancePrefix, (int)i));
+		}
+	}
+
+
+	void FixEMethodEvaluator::generateOnlineComposition(GenericSimpleSelectionFunction *sel)
+	{
+		Target *target = getTarget();
+		string pA = lanePrefixName(0);
+		string pB = lanePrefixName(1);
+		int N = nbIter-1;
+		int resultCycle, firstCycle, lastCycle;
+
+		//--------- pipelining
+		resultCycle = 0;
+		for(size_t lane=0; lane<nbLanes; lane++)
+		{
+			setCycleFromSignal(lanePrefixName(lane) + "sum", false);
+			if(getCurrentCycle() > resultCycle)
+				resultCycle = getCurrentCycle();
+		}
+		//--------- pipelining
+
+		if(onlineCompose == "add")
+		{
+			//online addition, radix 2, with digits in {-1, 0, 1}
+			//	z_k = a_k + b_k = 2*t_k + w_k, with t_k in {-1, 0, 1} and w_k in {-1, 0}
+			//	z2_k = w_k + t_{k+1} = 2*t2_k + w2_k, with t2_k in {-1, 0} and w2_k in {0, 1}
+			//	s_k = w2_k + t2_{k+1}, in {-1, 0, 1}
+			REPORT(DEBUG, "create the online adder");
+			addComment(" ---- online adder ----", tab);
+			for(int k=1; k<=N; k++)
+			{
+				//--------- pipelining
+				setCycleFromSignal(pA + join("D_", k, "_0"), false);
+				syncCycleFromSignal(pB + join("D_", k, "_0"), false);
+				setCriticalPath(sel->getOutDelayMap()["D"]);
+				manageCriticalPath(target->lutDelay() + target->localWireDelay(), false);
+				//--------- pipelining
+
+				vhdl << tab << declareFixPoint(join("OA_z_", k), true, 2, 0) << " <= resize(" << pA << "D_" << k << "_0, 3)"
+						<< " + resize(" << pB << "D_" << k << "_0, 3);" << endl;
+				vhdl << tab << declareFixPoint(join("OA_t_", k), true, 1, 0) << " <= \"01\" when OA_z_" << k << " > 0 else "
+						<< "\"11\" when OA_z_" << k << " = -2 else \"00\";" << endl;
+				vhdl << tab << declareFixPoint(join("OA_w_", k), true, 1, 0) << " <= \"11\" when (OA_z_" << k << " = 1) or (OA_z_"
+						<< k << " = -1) else \"00\";" << endl;
+			}
+			for(int k=0; k<=N; k++)
+			{
+				//--------- pipelining
+				if(k > 0)
+					setCycleFromSignal(join("OA_w_", k), false);
+				if(k < N)
+					syncCycleFromSignal(join("OA_t_", k+1), false);
+				manageCriticalPath(target->lutDelay() + target->localWireDelay(), false);
+				//--------- pipelining
+
+				vhdl << tab << declareFixPoint(join("OA_z2_", k), true, 2, 0) << " <= ";
+				if(k > 0)
+					vhdl << "resize(OA_w_" << k << ", 3)";
+				if((k > 0) && (k < N))
+					vhdl << " + ";
+				if(k < N)
+					vhdl << "resize(OA_t_" << k+1 << ", 3)";
+				vhdl << ";" << endl;
+				vhdl << tab << declareFixPoint(join("OA_t2_", k), true, 1, 0) << " <= \"11\" when OA_z2_" << k << " < 0 else \"00\";" << endl;
+				vhdl << tab << declareFixPoint(join("OA_w2_", k), true, 1, 0) << " <= \"01\" when (OA_z2_" << k << " = 1) or (OA_z2_"
+						<< k << " = -1) else \"00\";" << endl;
+			}
+			for(int k=-1; k<=N; k++)
+			{
+				//--------- pipelining
+				if(k >= 0)
+					setCycleFromSignal(join("OA_w2_", k), false);
+				if(k < N)
+					syncCycleFromSignal(join("OA_t2_", k+1), false);
+				manageCriticalPath(target->adderDelay(2), false);
+				//--------- pipelining
+
+				vhdl << tab << declareFixPoint(join("OC_S_", vhdlize(k)), true, 1, 0) << " <= ";
+				if(k >= 0)
+					vhdl << "OA_w2_" << k;
+				if((k >= 0) && (k < N))
+					vhdl << " + ";
+				if(k < N)
+					vhdl << "OA_t2_" << k+1;
+				vhdl << ";" << endl;
+			}
+		}
+		else
+		{
+			//online multiplication, radix 2, with digits in {-1, 0, 1} and an online delay of 3
+			//	v[j] = 2*w[j-1] + (A[k-1]*b_k + B[k]*a_k)*2^-3, with k=j+3
+			//	p_j = SEL(v[j]), using an estimate of v[j] with 2 fractional bits
+			//	w[j] = v[j] - p_j
+			//	the prefixes A[k] and B[k] of the inputs are built by on-the-fly conversion
+			int delay = 3;
+			int msbV = 1;
+			int lsbV = -(N+delay);
+			int wV = msbV-lsbV+1;
+
+			REPORT(DEBUG, "create the online multiplier");
+			addComment(" ---- online multiplier ----", tab);
+
+			//the prefixes of the inputs, and the prefixes minus one ulp
+			for(size_t op=0; op<2; op++)
+			{
+				string pIn = (op == 0 ? pA : pB);
+				string q   = (op == 0 ? "OM_QA_" : "OM_QB_");
+				string qm  = (op == 0 ? "OM_QMA_" : "OM_QMB_");
+
+				//--------- pipelining
+				setCycleFromSignal(pIn + "D_1_0", false);
+				//--------- pipelining
+
+				vhdl << tab << declareFixPoint(q + "0", true, 0, -N) << " <= " << zg(N+1) << ";" << endl;
+				vhdl << tab << declareFixPoint(qm + "0", true, 0, -N) << " <= \"1" << zg(N, -2) << "\";" << endl;
+				for(int k=1; k<=N; k++)
+				{
+					string digit = pIn + join("D_", k, "_0");
+					string prefixQ  = join(q, k-1) + range(N, N-k+1);
+					string prefixQM = join(qm, k-1) + range(N, N-k+1);
+
+					//--------- pipelining
+					setCycleFromSignal(digit, false);
+					syncCycleFromSignal(join(q, k-1), false);
+					setCriticalPath(sel->getOutDelayMap()["D"]);
+					manageCriticalPath(target->lutDelay() + target->localWireDelay(), false);
+					//--------- pipelining
+
+					vhdl << tab << declareFixPoint(join(q, k), true, 0, -N) << " <= "
+							<< "(" << prefixQ  << " & \"1" << zg(N-k, -2) << "\") when " << digit << " = \"01\" else "
+							<< "(" << prefixQ  << " & \"0" << zg(N-k, -2) << "\") when " << digit << " = \"00\" else "
+							<< "(" << prefixQM << " & \"1" << zg(N-k, -2) << "\");" << endl;
+					vhdl << tab << declareFixPoint(join(qm, k), true, 0, -N) << " <= "
+							<< "(" << prefixQ  << " & \"0" << zg(N-k, -2) << "\") when " << digit << " = \"01\" else "
+							<< "(" << prefixQM << " & \"1" << zg(N-k, -2) << "\") when " << digit << " = \"00\" else "
+							<< "(" << prefixQM << " & \"0" << zg(N-k, -2) << "\");" << endl;
+				}
+			}
+
+			//the iterations of the multiplier
+			for(int j=-delay+1; j<=N; j++)
+			{
+				int k = j+delay;
+
+				//--------- pipelining
+				if(j > -delay+1)
+					setCycleFromSignal(join("OM_W_", vhdlize(j-1)), false);
+				if(k <= N)
+				{
+					syncCycleFromSignal(join("OM_QA_", k-1), false);
+					syncCycleFromSignal(join("OM_QB_", k), false);
+				}
+				manageCriticalPath(target->lutDelay() + target->adderDelay(wV), false);
+				//--------- pipelining
+
+				//the new terms of the product
+				if(k <= N)
+				{
+					vhdl << tab << declareFixPoint(join("OM_TA_", vhdlize(j)), true, 0, -N) << " <= "
+							<< "OM_QA_" << k-1 << " when " << pB << "D_" << k << "_0 = \"01\" else "
+							<< "-OM_QA_" << k-1 << " when " << pB << "D_" << k << "_0 = \"11\" else "
+							<< zg(N+1) << ";" << endl;
+					vhdl << tab << declareFixPoint(join("OM_TB_", vhdlize(j)), true, 0, -N) << " <= "
+							<< "OM_QB_" << k << " when " << pA << "D_" << k << "_0 = \"01\" else "
+							<< "-OM_QB_" << k << " when " << pA << "D_" << k << "_0 = \"11\" else "
+							<< zg(N+1) << ";" << endl;
+				}
+				vhdl << tab << declareFixPoint(join("OM_V_", vhdlize(j)), true, msbV, lsbV) << " <= ";
+				if(j > -delay+1)
+					vhdl << "shift_left(OM_W_" << vhdlize(j-1) << ", 1)";
+				else
+					vhdl << zg(wV);
+				if(k <= N)
+					vhdl << " + resize(OM_TA_" << vhdlize(j) << ", " << wV << ")"
+							<< " + resize(OM_TB_" << vhdlize(j) << ", " << wV << ")";
+				vhdl << ";" << endl;
+
+				//the selection of the digits of the product, from the first integer digit
+				if(j >= 0)
+				{
+					//--------- pipelining
+					manageCriticalPath(target->lutDelay() + target->adderDelay(wV), false);
+					//--------- pipelining
+
+					vhdl << tab << declareFixPoint(join("OM_VHat_", j), true, msbV, -2) << " <= OM_V_" << j
+							<< range(wV-1, wV-4) << ";" << endl;
+					vhdl << tab << declareFixPoint(join("OC_S_", vhdlize(j)), true, 1, 0) << " <= "
+							<< "\"01\" when OM_VHat_" << j << " >= 2 else "
+							<< "\"11\" when OM_VHat_" << j << " < -2 else \"00\";" << endl;
+					vhdl << tab << declareFixPoint(join("OM_W_", vhdlize(j)), true, msbV, lsbV) << " <= OM_V_" << j
+							<< " - shift_left(resize(OC_S_" << j << ", " << wV << "), " << -lsbV << ");" << endl;
+				}
+				else
+				{
+					vhdl << tab << declareFixPoint(join("OM_W_", vhdlize(j)), true, msbV, lsbV) << " <= OM_V_" << vhdlize(j) << ";" << endl;
+				}
+			}
+		}
+
+		//output the digits of the composition, as soon as they are available
+		addComment(" ---- online output of the digits of the composition ----", tab);
+		firstCycle = -1;
+		lastCycle = 0;
+		for(int j=firstComposedDigit; j<=N; j++)
+		{
+			//--------- pipelining
+			setCycleFromSignal(join("OC_S_", vhdlize(j)), false);
+			//--------- pipelining
+
+			vhdl << tab << "S_D_" << vhdlize(j) << " <= std_logic_vector(OC_S_" << vhdlize(j) << ");" << endl;
+			vhdl << tab << "S_D_" << vhdlize(j) << "_valid <= X_valid;" << endl;
+			onlineValidCycles[join("S_D_", vhdlize(j), "_valid")] = getCurrentCycle();
+
+			if(firstCycle < 0)
+				firstCycle = getCurrentCycle();
+			if(getCurrentCycle() > lastCycle)
+				lastCycle = getCurrentCycle();
+		}
+
+		REPORT(INFO, "online " << (onlineCompose == "add" ? "addition" : "multiplication") << " of the lanes: "
+				<< "first digit at cycle " << firstCycle << ", last digit at cycle " << lastCycle
+				<< ", while the results of the lanes are only available at cycle " << resultCycle);
+	}
+
+
+	FixEMethodEvaluator::~FixEMethodEvaluator()
+	{
+		for(size_t lane=0; lane<lanesMpCoeffsP.size(); lane++)
+		{
+			selectLane(lane);
+			for(size_t i=0; i<maxDegree; i++)
+			{
+				mpfr_clear(mpCoeffsP[i]);
+				mpfr_clear(mpCoeffsQ[i]);
+			}
+			delete[] mpCoeffsP;
+			delete[] mpCoeffsQ;
+		}
+	}
+
+
+	void FixEMethodEvaluator::copyVectors()
+	{
+		size_t commonDegree = 0;
+
+		//in segmented mode, all the segments share the same datapath, so they must have the same degree
+		if(segmentBits > 0)
+		{
+			for(size_t lane=0; lane<lanesCoeffsP.size(); lane++)
+			{
+				if(lanesCoeffsP[lane].size() > commonDegree)
+					commonDegree = lanesCoeffsP[lane].size();
+				if(lanesCoeffsQ[lane].size() > commonDegree)
+					commonDegree = lanesCoeffsQ[lane].size();
+			}
+			for(size_t lane=0; lane<lanesCoeffsP.size(); lane++)
+			{
+				lanesCoeffsP[lane].resize(commonDegree, string("0"));
+				lanesCoeffsQ[lane].resize(commonDegree, string("0"));
+			}
+		}
+
+		for(size_t lane=0; lane<lanesCoeffsP.size(); lane++)
+		{
+			//work on the coefficients of the current lane
+			coeffsP = lanesCoeffsP[lane];
+			coeffsQ = lanesCoeffsQ[lane];
+			lanesN.push_back(coeffsP.size());
+			lanesM.push_back(coeffsQ.size());
+			maxDegree = (coeffsP.size() > coeffsQ.size() ? coeffsP.size() : coeffsQ.size());
+			mpCoeffsP = new mpfr_t[maxDegree];
+			mpCoeffsQ = new mpfr_t[maxDegree];
+
+			size_t iterLimit = coeffsP.size();
+
+			//copy the coefficients of P
+			for(size_t i=0; i<iterLimit; i++)
+			{
+				//create a copy as MPFR
+				mpfr_init2(mpCoeffsP[i], LARGEPREC);
+				//	parse the constant using Sollya
+				sollya_obj_t node;
+				node = sollya_lib_parse_string(coeffsP[i].c_str());
+				/* If  parse error throw an exception */
+				if (sollya_lib_obj_is_error(node))
+				{
+					THROWERROR("emulate: Unable to parse string "<< coeffsP[i] << " as a numeric constant");
+				}
+				sollya_lib_get_constant(mpCoeffsP[i], node);
+				free(node);
+			}
+			//fill with zeros, if necessary
+			for(size_t i=iterLimit; i<maxDegree; i++)
+			{
+				//create a copy as string
+				coeffsP.push_back(string("0"));
+
+				//create a copy as MPFR
+				mpfr_init2(mpCoeffsP[i], LARGEPREC);
+				mpfr_set_zero(mpCoeffsP[i], 0);
+			}
+
+			iterLimit = coeffsQ.size();
+			//copy the coefficients of Q
+			for(size_t i=0; i<iterLimit; i++)
+			{
+				//create a copy as MPFR
+				mpfr_init2(mpCoeffsQ[i], LARGEPREC);
+				//	parse the constant using Sollya
+				sollya_obj_t node;
+				node = sollya_lib_parse_string(coeffsQ[i].c_str());
+				/* If  parse error throw an exception */
+				if (sollya_lib_obj_is_error(node))
+				{
+					THROWERROR("emulate: Unable to parse string "<< coeffsQ[i] << " as a numeric constant");
+				}
+				sollya_lib_get_constant(mpCoeffsQ[i], node);
+				free(node);
+			}
+			//fill with zeros, if necessary
+			for(size_t i=iterLimit; i<maxDegree; i++)
+			{
+				//create a copy as string
+				coeffsQ.push_back(string("0"));
+
+				//create a copy as MPFR
+				mpfr_init2(mpCoeffsQ[i], LARGEPREC);
+				mpfr_set_zero(mpCoeffsQ[i], 0);
+			}
+
+			//save the copies of the current lane
+			lanesCoeffsP[lane] = coeffsP;
+			lanesCoeffsQ[lane] = coeffsQ;
+			lanesMpCoeffsP.push_back(mpCoeffsP);
+			lanesMpCoeffsQ.push_back(mpCoeffsQ);
+		}
+
+		selectLane(0);
+	}
+
+
+	void FixEMethodEvaluator::selectLane(size_t lane)
+	{
+		n = lanesN[lane];
+		m = lanesM[lane];
+		maxDegree = (n > m ? n : m);
+		coeffsP = lanesCoeffsP[lane];
+		coeffsQ = lanesCoeffsQ[lane];
+		mpCoeffsP = lanesMpCoeffsP[lane];
+		mpCoeffsQ = lanesMpCoeffsQ[lane];
+		lanePrefix = lanePrefixName(lane);
+		laneOutput = laneOutputName(lane);
+		//	the widths of the units, once computed: the segments share those of lane 0
+		if((segmentBits > 0 ? 0 : lane) < lanesCuLsbTrunc.size())
+			cuLsbTrunc = lanesCuLsbTrunc[segmentBits > 0 ? 0 : lane];
+	}
+
+
+	string FixEMethodEvaluator::lanePrefixName(size_t lane)
+	{
+		return (nbLanes > 1 ? join("L", lane, "_") : "");
+	}
+
+
+	string FixEMethodEvaluator::laneOutputName(size_t lane)
+	{
+		return (nbLanes > 1 ? join("Y_", lane) : "Y");
+	}
+
+
+	void FixEMethodEvaluator::getAlgorithmParameters(int _radix, double _delta, double *_xi, double *_alpha)
+	{
+		//set xi
+		//	this is only for radix 2
+		//xi    = 0.5  * (1+delta);
+		//	generic case
+		*(_xi)    = 0.5  * (1.0+_delta);
+		//set alpha
+		//	this is only for radix 2
+		//alpha = 0.25 * (1-delta);
+		//	generic case
+		*(_alpha) = (1.0/(2*_radix)) * (1.0-_delta);
+	}
+
+
+	void FixEMethodEvaluator::setAlgorithmParameters()
+	{
+		//set xi and alpha
+		getAlgorithmParameters(radix, delta, &xi, &alpha);
+		//set the scale factor
+		//	compute the value of the scale factor in two cases:
+		//	1) when scaling is required, and it hasn't been set by the user
+		//	2) when scaling isn't required, for the analysis of the parameters
+		if(((scaleInput == true) && (inputScaleFactor == -1)) || (scaleInput == false))
+		{
+			//if the scale factor needs to be automatically be set,
+			//	then set if to the maximum admissible limit
+			//	we need to first determine the maximum value of the coefficients of Q,
+			//	and then subtract it from alpha
+			mpfr_t mpTmp, mpTmp2, mpAlpha;
+
+			mpfr_inits2(LARGEPREC, mpTmp, mpTmp2, mpAlpha, (mpfr_ptr)nullptr);
+
+			mpfr_set_zero(mpTmp, 0);
+			for(size_t i=1; i<m; i++)
+			{
+				mpfr_abs(mpTmp2, mpTmp, GMP_RNDN);
+				if(mpfr_cmp(mpTmp2, mpTmp) > 0)
+					mpfr_set(mpTmp, mpTmp2, GMP_RNDN);
+			}
+
+			mpfr_set_d(mpAlpha, alpha, GMP_RNDN);
+
+			mpfr_sub(mpTmp, mpAlpha, mpTmp, GMP_RNDN);
+			inputScaleFactor = mpfr_get_d(mpTmp, GMP_RNDN);
+
+			mpfr_clears(mpTmp, mpTmp2, mpAlpha, (mpfr_ptr)nullptr);
+		}
+	}
+
+
+	void FixEMethodEvaluator::checkPCoeffs()
+	{
+		mpfr_t mpXi;
+
+		mpfr_init2(mpXi, LARGEPREC);
+		mpfr_set_d(mpXi, xi, GMP_RNDN);
+		//check that the coefficients of P are smaller than xi
+		for(size_t i=0; i<maxDegree; i++)
+		{
 			if(mpfr_cmp(mpCoeffsP[i], mpXi) > 0)
 				THROWERROR("checkPCoeff: coefficient coeffsP[" << i << "]=" << coeffsP[i]
 					<< " does not satisfy the constraints");
@@ -848,8 +2009,9 @@ namespace flopoco {
 
 		//check that the largest value that X can take is smaller than alpha/2
 		//	largest value X can take
+		//		in segmented mode, the largest offset inside a segment
 		mpfr_set_ui(mpX, 1, GMP_RNDN);
-		mpfr_mul_2si(mpX, mpX, msbInOut, GMP_RNDN);
+		mpfr_mul_2si(mpX, mpX, (segmentBits > 0 ? msbInOut-segmentBits+1 : msbInOut), GMP_RNDN);
 		//	need to subtract 1 ulp
 		mpfr_set_ui(mpTmp, 1, GMP_RNDN);
 		mpfr_mul_2si(mpTmp, mpTmp, lsbInOut, GMP_RNDN);
@@ -861,12 +2023,202 @@ namespace flopoco {
 		//now perform the test
 		if(mpfr_cmp(mpX, mpLimit) > 0)
 			THROWERROR("checkX: input format for X, with msb=" << msbInOut
-					<< " and lsb=" << lsbInOut << " does not satisfy the constraints");
+					<< " and lsb=" << lsbInOut
+					<< (segmentBits > 0 ? join(" and ", segmentBits, " segment bits") : "")
+					<< " does not satisfy the constraints");
 
 		mpfr_clears(mpAlpha, mpLimit, mpX, mpTmp, (mpfr_ptr)nullptr);
 	}
 
 
+	void FixEMethodEvaluator::generateFoldedIterations(GenericComputationUnit *cu0, GenericComputationUnit **cuI,
+			GenericComputationUnit *cuN, GenericSimpleSelectionFunction *sel)
+	{
+		size_t nbFoldedIter = nbIter-3;
+		size_t nbLastRows = nbFoldedIter - (foldingFactor-1)*nbFoldedRows;
+		int counterSize = intlog2(foldingFactor-1);
+		int accSize = msbW-lsbW+1;
+		int digitShift = ceil(log2(radix));
+		int initCounter, foldCycle;
+		double passDelay;
+		string enableCond = "";
+		ostringstream accFull, accLast;
+
+		//the rows are chained combinatorially inside a cycle, so the units cannot be pipelined
+		if((cu0->getPipelineDepth() > 0) || (sel->getPipelineDepth() > 0))
+			THROWERROR("a folded architecture requires combinatorial computation units and selection functions; "
+					<< "try a lower target frequency");
+
+		//--------- pipelining
+		for(size_t i=0; i<maxDegree; i++)
+		{
+			syncCycleFromSignal(join("W_2_", i), true);
+			syncCycleFromSignal(join("D_2_", i), true);
+		}
+		syncCycleFromSignal("D_1_0", true);
+		//--------- pipelining
+
+		//all the signals of the folded part live in the same cycle
+		foldCycle = getCurrentCycle();
+
+		//the counter is aligned so that a new input reaches the folded part when it is 0
+		initCounter = (foldingFactor - (foldCycle % foldingFactor)) % foldingFactor;
+
+		//the controller
+		REPORT(DEBUG, "create the controller of the folded architecture");
+		addComment(" ---- controller of the folded architecture ----", tab);
+		declareFixPoint("FoldCounter", false, counterSize-1, 0);
+		vhdl << tab << declare("FoldFirst") << " <= '1' when FoldCounter = \""
+				<< unsignedBinary(mpz_class(0), counterSize) << "\" else '0';" << endl;
+		vhdl << tab << declare("FoldLast") << " <= '1' when FoldCounter = \""
+				<< unsignedBinary(mpz_class(foldingFactor-1), counterSize) << "\" else '0';" << endl;
+
+		//the inputs of the first row: the output of iteration 2 for a new input, the fed back values otherwise
+		addComment(" ---- inputs of the first row ----", tab);
+		for(size_t i=0; i<maxDegree; i++)
+		{
+			declareFixPoint(join("WF_reg_", i), true, msbW, lsbW);
+			declareFixPoint(join("DF_reg_", i), true, msbD, lsbD);
+
+			vhdl << tab << declareFixPoint(join("WF_0_", i), true, msbW, lsbW) << " <= W_2_" << i
+					<< " when FoldFirst = '1' else WF_reg_" << i << ";" << endl;
+			vhdl << tab << declareFixPoint(join("DF_0_", i), true, msbD, lsbD) << " <= D_2_" << i
+					<< " when FoldFirst = '1' else DF_reg_" << i << ";" << endl;
+		}
+
+		//the rows of computation units
+		for(size_t row=0; row<nbFoldedRows; row++)
+		{
+			REPORT(DEBUG, "folded row " << row);
+			addComment(join(" ---- folded row ", row, " ----"), tab);
+
+			//create computation unit index 0
+			inPortMap(cu0, "Wi",   join("WF_", row, "_0"));
+			inPortMap(cu0, "D0",   join("DF_", row, "_0"));
+			inPortMap(cu0, "Di",   join("DF_", row, "_0"));
+			inPortMap(cu0, "Dip1", join("DF_", row, "_1"));
+			inPortMap(cu0, "X",    "X_scaled_signed");
+			for(int j=(-(int)maxDigit); j<=(int)maxDigit; j++)
+			{
+				inPortMap(cu0, join("X_Mult_", vhdlize(j)), join("X_Mult_", vhdlize(j)));
+			}
+			outPortMap(cu0, "Wi_next", join("WF_", row+1, "_0"));
+			vhdl << tab << instance(cu0, join("CU_F_", row, "_0"));
+
+			//create computation units index 1 to maxDegree-2
+			for(size_t i=1; i<=(maxDegree-2); i++)
+			{
+				inPortMap(cuI[i-1], "Wi",   join("WF_", row, "_", i));
+				inPortMap(cuI[i-1], "D0",   join("DF_", row, "_0"));
+				inPortMap(cuI[i-1], "Di",   join("DF_", row, "_", i));
+				inPortMap(cuI[i-1], "Dip1", join("DF_", row, "_", i+1));
+				inPortMap(cuI[i-1], "X",    "X_scaled_signed");
+				if(segmentBits > 0)
+					inPortMap(cuI[i-1], "Qi", join("Q_", i));
+				for(int j=(-(int)maxDigit); j<=(int)maxDigit; j++)
+				{
+					inPortMap(cuI[i-1], join("X_Mult_", vhdlize(j)), join("X_Mult_", vhdlize(j)));
+				}
+				outPortMap(cuI[i-1], "Wi_next", join("WF_", row+1, "_", i));
+				vhdl << tab << instance(cuI[i-1], join("CU_F_", row, "_", i));
+			}
+
+			//create computation unit index maxDegree-1
+			inPortMap(cuN, "Wi",   join("WF_", row, "_", maxDegree-1));
+			inPortMap(cuN, "D0",   join("DF_", row, "_0"));
+			inPortMap(cuN, "Di",   join("DF_", row, "_", maxDegree-1));
+			inPortMap(cuN, "X",    "X_scaled_signed");
+			if(segmentBits > 0)
+				inPortMap(cuN, "Qi", join("Q_", maxDegree-1));
+			outPortMap(cuN, "Wi_next", join("WF_", row+1, "_", maxDegree-1));
+			vhdl << tab << instance(cuN, join("CU_F_", row, "_", maxDegree-1));
+
+			//create the selection units
+			vector<size_t> selIndices;
+			for(size_t i=0; i<maxDegree; i++)
+				selIndices.push_back(i);
+			instanceSelections(sel, selIndices, join("WF_", row+1, "_"), join("DF_", row+1, "_"), join("SEL_F_", row, "_"));
+		}
+
+		//accumulate the digits of the result, most significant first
+		//	the digits of iterations 1 and 2 are added when a new input enters the folded part
+		REPORT(DEBUG, "accumulate the digits of the result");
+		addComment(" ---- accumulation of the result digits ----", tab);
+		declareFixPoint("FoldAcc_reg", true, accSize-1, 0);
+		declareFixPoint("FoldResult_reg", true, accSize-1, 0);
+		vhdl << tab << declareFixPoint("FoldAcc_init", true, accSize-1, 0) << " <= "
+				<< "shift_left(resize(D_1_0, " << accSize << "), " << digitShift << ") + resize(D_2_0, " << accSize << ");" << endl;
+		vhdl << tab << declareFixPoint("FoldAcc", true, accSize-1, 0)
+				<< " <= FoldAcc_init when FoldFirst = '1' else FoldAcc_reg;" << endl;
+		//	a pass uses the digits of all the rows, except for the last one which might use less
+		accFull << "shift_left(FoldAcc, " << nbFoldedRows*digitShift << ")";
+		for(size_t row=0; row<nbFoldedRows; row++)
+			accFull << " + shift_left(resize(DF_" << row+1 << "_0, " << accSize << "), "
+				<< (nbFoldedRows-1-row)*digitShift << ")";
+		accLast << "shift_left(FoldAcc, " << nbLastRows*digitShift << ")";
+		for(size_t row=0; row<nbLastRows; row++)
+			accLast << " + shift_left(resize(DF_" << row+1 << "_0, " << accSize << "), "
+				<< (nbLastRows-1-row)*digitShift << ")";
+		vhdl << tab << declareFixPoint("FoldAcc_next", true, accSize-1, 0) << " <= " << accFull.str() << ";" << endl;
+		vhdl << tab << declareFixPoint("FoldAcc_last", true, accSize-1, 0) << " <= " << accLast.str() << ";" << endl;
+
+		//the registers of the folded part
+		REPORT(DEBUG, "create the registers of the folded architecture");
+		addComment(" ---- registers of the folded architecture ----", tab);
+		if(isRecirculatory())
+			enableCond = "stall_s = '0'";
+		else if(hasClockEnable())
+			enableCond = "ce = '1'";
+		vhdl << tab << "process(clk, rst)" << endl;
+		vhdl << tab << tab << "begin" << endl;
+		vhdl << tab << tab << tab << "if rst = '1' then" << endl;
+		vhdl << tab << tab << tab << tab << "FoldCounter <= \"" << unsignedBinary(mpz_class(initCounter), counterSize) << "\";" << endl;
+		for(size_t i=0; i<maxDegree; i++)
+		{
+			vhdl << tab << tab << tab << tab << "WF_reg_" << i << " <= (others => '0');" << endl;
+			vhdl << tab << tab << tab << tab << "DF_reg_" << i << " <= (others => '0');" << endl;
+		}
+		vhdl << tab << tab << tab << tab << "FoldAcc_reg <= (others => '0');" << endl;
+		vhdl << tab << tab << tab << tab << "FoldResult_reg <= (others => '0');" << endl;
+		vhdl << tab << tab << tab << "elsif clk'event and clk = '1' then" << endl;
+		if(enableCond != "")
+			vhdl << tab << tab << tab << tab << "if " << enableCond << " then" << endl;
+		vhdl << tab << tab << tab << tab << "if FoldLast = '1' then" << endl;
+		vhdl << tab << tab << tab << tab << tab << "FoldCounter <= (others => '0');" << endl;
+		vhdl << tab << tab << tab << tab << tab << "FoldResult_reg <= FoldAcc_last;" << endl;
+		vhdl << tab << tab << tab << tab << "else" << endl;
+		vhdl << tab << tab << tab << tab << tab << "FoldCounter <= FoldCounter + 1;" << endl;
+		vhdl << tab << tab << tab << tab << "end if;" << endl;
+		for(size_t i=0; i<maxDegree; i++)
+		{
+			vhdl << tab << tab << tab << tab << "WF_reg_" << i << " <= WF_" << nbFoldedRows << "_" << i << ";" << endl;
+			vhdl << tab << tab << tab << tab << "DF_reg_" << i << " <= DF_" << nbFoldedRows << "_" << i << ";" << endl;
+		}
+		vhdl << tab << tab << tab << tab << "FoldAcc_reg <= FoldAcc_next;" << endl;
+		if(enableCond != "")
+			vhdl << tab << tab << tab << tab << "end if;" << endl;
+		vhdl << tab << tab << tab << "end if;" << endl;
+		vhdl << tab << tab << "end process;" << endl;
+
+		//write the result to the output, only the bits that we want
+		vhdl << tab << "Y <= FoldResult_reg" << range(msbInOut-lsbInOut+g, g) << ";" << endl;
+
+		//the result of an input is available foldingFactor cycles after it reaches the folded part,
+		//	and a new input can be accepted every foldingFactor cycles
+		setPipelineDepth(foldCycle+foldingFactor);
+		setInitiationInterval(foldingFactor);
+
+		//one pass goes through all the rows of the folded part
+		passDelay = nbFoldedRows * (cu0->getOutDelayMap()["Wi_next"] + sel->getOutDelayMap()["D"]);
+		if(passDelay > 1.0/getTarget()->frequency())
+			REPORT(INFO, "WARNING: the critical path of the folded part (" << passDelay*1e9
+					<< "ns) is larger than the target period; try a larger folding factor");
+		REPORT(INFO, "folded architecture: " << nbFoldedRows*maxDegree << " computation units (instead of "
+				<< (nbIter-2)*maxDegree << "), initiation interval " << foldingFactor
+				<< ", latency " << getPipelineDepth() << " cycles");
+	}
+
+
 	void FixEMethodEvaluator::emulate(TestCase * tc)
 	{
 		//get the inputs from the TestCase
@@ -877,7 +2229,16 @@ namespace flopoco {
 		mpz_class big1Xp     = (mpz_class(1) << (msbInOut-lsbInOut));
 
 		//handle the signed inputs
-		if(svX >= big1Xp)
+		//	in segmented mode, the input is unsigned, and its top bits select the segment
+		size_t segment = 0;
+		if(segmentBits > 0)
+		{
+			int offsetSize = msbInOut-lsbInOut+1-segmentBits;
+
+			segment = mpz_class(svX >> offsetSize).get_ui();
+			svX -= (mpz_class(segment) << offsetSize);
+		}
+		else if(svX >= big1Xp)
 			svX -= big1X;
 
 		// compute the multiple-precision output
@@ -887,10 +2248,6 @@ namespace flopoco {
 		//initialize the variables
 		mpfr_inits2(LARGEPREC, mpX, mpP, mpQ, mpTmp, mpY, (mpfr_ptr)nullptr);
 
-		//initialize P and Q
-		mpfr_set_zero(mpP, 0);
-		mpfr_set_zero(mpQ, 0);
-
 		//initialize X
 		mpfr_set_z(mpX, svX.get_mpz_t(), GMP_RNDN);
 		//	scale X appropriately, by the amount given by lsbInOut
@@ -900,56 +2257,733 @@ namespace flopoco {
 		if(scaleInput == true)
 			mpfr_mul_d(mpX, mpX, inputScaleFactor, GMP_RNDN);
 
-		//compute P
-		for(int i=0; i<(int)n; i++)
+		//compute the result of each of the lanes
+		//	the coefficients are read directly (no selectLane), so that emulate() can run on several threads
+		for(size_t lane=0; lane<nbLanes; lane++)
 		{
-			//compute X^i
-			mpfr_pow_si(mpTmp, mpX, i, GMP_RNDN);
-			//multiply by coeffsP[i]
-			mpfr_mul(mpTmp, mpTmp, mpCoeffsP[i], GMP_RNDN);
+			size_t coeffsLane = (segmentBits > 0 ? segment : lane);
+			size_t laneN = lanesN[coeffsLane];
+			size_t laneM = lanesM[coeffsLane];
+			mpfr_t *laneMpCoeffsP = lanesMpCoeffsP[coeffsLane];
+			mpfr_t *laneMpCoeffsQ = lanesMpCoeffsQ[coeffsLane];
+
+			//initialize P and Q
+			mpfr_set_zero(mpP, 0);
+			mpfr_set_zero(mpQ, 0);
+
+			//compute P
+			for(int i=0; i<(int)laneN; i++)
+			{
+				//compute X^i
+				mpfr_pow_si(mpTmp, mpX, i, GMP_RNDN);
+				//multiply by coeffsP[i]
+				mpfr_mul(mpTmp, mpTmp, laneMpCoeffsP[i], GMP_RNDN);
 
-			//add the new term to the sum
-			mpfr_add(mpP, mpP, mpTmp, GMP_RNDN);
- 		}
+				//add the new term to the sum
+				mpfr_add(mpP, mpP, mpTmp, GMP_RNDN);
+	 		}
 
-		//compute Q
-		for(int i=0; i<(int)m; i++)
-		{
-			//compute X^i
-			mpfr_pow_si(mpTmp, mpX, i, GMP_RNDN);
-			//multiply by coeffsQ[i]
-			mpfr_mul(mpTmp, mpTmp, mpCoeffsQ[i], GMP_RNDN);
+			//compute Q
+			for(int i=0; i<(int)laneM; i++)
+			{
+				//compute X^i
+				mpfr_pow_si(mpTmp, mpX, i, GMP_RNDN);
+				//multiply by coeffsQ[i]
+				mpfr_mul(mpTmp, mpTmp, laneMpCoeffsQ[i], GMP_RNDN);
 
-			//add the new term to the sum
-			mpfr_add(mpQ, mpQ, mpTmp, GMP_RNDN);
-		}
+				//add the new term to the sum
+				mpfr_add(mpQ, mpQ, mpTmp, GMP_RNDN);
+			}
 
-		//compute Y = P/Q
-		mpfr_div(mpY, mpP, mpQ, GMP_RNDN);
+			//compute Y = P/Q
+			mpfr_div(mpY, mpP, mpQ, GMP_RNDN);
 
-		//scale the result back to an integer
-		mpfr_mul_2si(mpY, mpY, -lsbInOut+msbInOut, GMP_RNDN);
+			//scale the result back to an integer
+			mpfr_mul_2si(mpY, mpY, -lsbInOut+msbInOut, GMP_RNDN);
 
-		//round the result
-		mpfr_get_z(svYd.get_mpz_t(), mpY, GMP_RNDD);
-		mpfr_get_z(svYu.get_mpz_t(), mpY, GMP_RNDU);
+			//round the result
+			mpfr_get_z(svYd.get_mpz_t(), mpY, GMP_RNDD);
+			mpfr_get_z(svYu.get_mpz_t(), mpY, GMP_RNDU);
 
-		//handle the signed outputs
-		if(svYd < 0)
-			svYd += big1X;
-		if(svYu < 0)
-			svYu += big1X;
+			//handle the signed outputs
+			if(svYd < 0)
+				svYd += big1X;
+			if(svYu < 0)
+				svYu += big1X;
 
-		//only use the required bits
-		svYd &= (big1X-1);
-		svYu &= (big1X-1);
+			//only use the required bits
+			svYd &= (big1X-1);
+			svYu &= (big1X-1);
 
-		//add this expected output to the TestCase
-		tc->addExpectedOutput("Y", svYd);
-		tc->addExpectedOutput("Y", svYu);
+			//add this expected output to the TestCase
+			tc->addExpectedOutput(laneOutputName(lane), svYd);
+			tc->addExpectedOutput(laneOutputName(lane), svYu);
+		}
 
 		//cleanup
 		mpfr_clears(mpX, mpP, mpQ, mpTmp, mpY, (mpfr_ptr)nullptr);
+
+		//the online outputs
+		//	the digits depend on the faithful roundings of the constant multipliers, so they have no expected value
+		//	(simulateBitAccurate() checks the digits of the composition against the digits of the lanes)
+		//	the valid signals are X_valid, and the test bench checks all the outputs at the last cycle of the pipeline,
+		//	so the ones written at that cycle (all of them, when not pipelined) are expected
+		if(onlineOutput)
+			for(auto& output : onlineValidCycles)
+				if(output.second == getPipelineDepth())
+					tc->addExpectedOutput(output.first, tc->getInputValue("X_valid"));
+	}
+
+	void FixEMethodEvaluator::checkOnlineComposition(map<string, mpz_class>& outputs)
+	{
+		int N = nbIter-1;
+		int wD = msbD-lsbD+1;
+		mpz_class a = 0, b = 0, s = 0, err;
+
+		//the digits of the outputs, as signed numbers
+		auto digit = [&](string name) -> mpz_class
+		{
+			mpz_class d = outputs[name];
+
+			if(d >= (mpz_class(1) << (wD-1)))
+				d -= (mpz_class(1) << wD);
+			return d;
+		};
+
+		//the values of the digit streams, in units of 2^-N
+		for(int k=1; k<=N; k++)
+		{
+			a += digit(laneOutputName(0) + join("_D_", k)) << (N-k);
+			b += digit(laneOutputName(1) + join("_D_", k)) << (N-k);
+		}
+		for(int j=firstComposedDigit; j<=N; j++)
+			s += digit(join("S_D_", vhdlize(j))) << (N-j);
+
+		//the online addition is exact, while the online product is within one unit of the last digit
+		if(onlineCompose == "add")
+		{
+			if(s != a+b)
+				THROWERROR("checkOnlineComposition: the digits of the online sum give " << s
+						<< " instead of " << a+b << " (in units of 2^-" << N << ")");
+		}
+		else
+		{
+			err = abs((s << N) - a*b);
+			if(err >= (mpz_class(1) << N))
+				THROWERROR("checkOnlineComposition: the digits of the online product give " << s
+						<< " for the product of " << a << " and " << b << " (in units of 2^-" << N << ")");
+		}
+	}
+
+	bool FixEMethodEvaluator::hasThreadSafeEmulate()
+	{
+		return true;
+	}
+
+	bool FixEMethodEvaluator::hasBitAccurateModel()
+	{
+		return true;
+	}
+
+	void FixEMethodEvaluator::simulateBitAccurate(TestCase * tc, map<string, mpz_class>& outputs)
+	{
+		int log2Radix = ceil(log2(radix));
+		int msbInt = maxInt(3, msbW, msbX, msbD);
+		int lsbInt = minInt(3, lsbW, lsbX, lsbD);
+		int wW = msbW-lsbW+1;
+		int wD = msbD-lsbD+1;
+		int wHatSize = msbWHat-lsbWHat+1;
+		int iterLimit;
+
+		//the model keeps all the residuals on the LSB of W, which is also the one of the computation units
+		if((lsbInt != lsbW) || (lsbDiMX != lsbW))
+			THROWERROR("simulateBitAccurate: the model requires X and W to have the same LSB");
+
+		//the value of the bits of a signal of the given width, as a signed number
+		auto wrap = [](mpz_class v, int width) -> mpz_class
+		{
+			mpz_class r;
+
+			mpz_fdiv_r_2exp(r.get_mpz_t(), v.get_mpz_t(), width);
+			if(r >= (mpz_class(1) << (width-1)))
+				r -= (mpz_class(1) << width);
+			return r;
+		};
+		//a value of weight lsbFrom moved to weight lsbTo, truncated if lsbTo>lsbFrom
+		auto align = [](mpz_class v, int lsbFrom, int lsbTo) -> mpz_class
+		{
+			mpz_class r;
+
+			if(lsbTo > lsbFrom)
+				mpz_fdiv_q_2exp(r.get_mpz_t(), v.get_mpz_t(), lsbTo-lsbFrom);
+			else
+				r = v << (lsbFrom-lsbTo);
+			return r;
+		};
+		//x rounded to the nearest multiple of 2^lsb, in ulps
+		auto roundToLsb = [](mpfr_t x, int lsb) -> mpz_class
+		{
+			mpz_class r;
+			mpfr_t mpTmp;
+
+			mpfr_init2(mpTmp, mpfr_get_prec(x));
+			mpfr_mul_2si(mpTmp, x, -lsb, GMP_RNDN);
+			mpfr_get_z(r.get_mpz_t(), mpTmp, GMP_RNDN);
+			mpfr_clear(mpTmp);
+			return r;
+		};
+
+		//the selection function: W^ is the top bits of W, and the digit is round(W^/2),
+		//	saturated to the digit set (the table of the hardware is undefined out of its range)
+		if(((1<<wHatSize)-1) > (int)(maxDigit+1))
+			iterLimit = (maxDigit+1) << 1;
+		else
+			iterLimit = (1 << wHatSize) - 1;
+		auto select = [&](mpz_class w) -> mpz_class
+		{
+			mpz_class wHat = wrap(align(w, lsbW, msbW-wHatSize+1), wHatSize);
+			mpz_class d;
+
+			if(wHat > iterLimit)
+				wHat = iterLimit;
+			else if(wHat < -iterLimit)
+				wHat = -iterLimit;
+			mpz_fdiv_q_2exp(d.get_mpz_t(), mpz_class(wHat+1).get_mpz_t(), 1);
+			if(d > (long)maxDigit)
+				d = (long)maxDigit;
+			else if(d < -(long)maxDigit)
+				d = -(long)maxDigit;
+			return d;
+		};
+		//	with carry-save residuals, the estimate is the sum of the top bits of W and WC, and of 1/2, rounded down
+		int lsbEstimate = std::max(GenericSimpleSelectionFunction::getCarrySaveEstimateLsb(delta), msbWHat-(msbW-lsbW));
+		auto selectCarrySave = [&](mpz_class w, mpz_class wc) -> mpz_class
+		{
+			mpz_class wHat = wrap(align(w, lsbW, lsbEstimate) + align(wc, lsbW, lsbEstimate) + (mpz_class(1) << (-1-lsbEstimate)),
+					msbWHat-lsbEstimate+1);
+			mpz_class d;
+
+			mpz_fdiv_q_2exp(d.get_mpz_t(), wHat.get_mpz_t(), -lsbEstimate);
+			if(d > (long)maxDigit)
+				d = (long)maxDigit;
+			else if(d < -(long)maxDigit)
+				d = -(long)maxDigit;
+			return d;
+		};
+
+		//get the input, and split it in segmented mode
+		mpz_class svX = tc->getInputValue("X");
+		size_t segment = 0;
+		if(segmentBits > 0)
+		{
+			int offsetSize = msbInOut-lsbInOut+1-segmentBits;
+
+			segment = mpz_class(svX >> offsetSize).get_ui();
+			svX -= (mpz_class(segment) << offsetSize);
+		}
+		else
+			svX = wrap(svX, msbInOut-lsbInOut+1);
+
+		//scale the input, by the constant given to the multiplier as a string
+		if(scaleInput)
+		{
+			mpfr_t mpX, mpFactor;
+
+			mpfr_inits2(LARGEPREC, mpX, mpFactor, (mpfr_ptr)nullptr);
+			mpfr_set_str(mpFactor, std::to_string(inputScaleFactor).c_str(), 10, GMP_RNDN);
+			mpfr_set_z(mpX, svX.get_mpz_t(), GMP_RNDN);
+			mpfr_mul_2si(mpX, mpX, lsbInOut, GMP_RNDN);
+			mpfr_mul(mpX, mpX, mpFactor, GMP_RNDN);
+			svX = wrap(roundToLsb(mpX, lsbX), msbX-lsbX+1);
+			mpfr_clears(mpX, mpFactor, (mpfr_ptr)nullptr);
+		}
+
+		//the multiples of X by the digits
+		vector<mpz_class> xMult(2*maxDigit+1);
+		for(int i=-(int)maxDigit; i<=(int)maxDigit; i++)
+			xMult[i+maxDigit] = wrap(wrap(mpz_class(abs(i))*svX, msbDiMX-lsbDiMX+1) * (i < 0 ? -1 : 1), msbDiMX-lsbDiMX+1);
+		auto digitTimesX = [&](mpz_class d) -> mpz_class
+		{
+			if((d > (long)maxDigit) || (d < -(long)maxDigit))
+				THROWERROR("simulateBitAccurate: digit " << d << " out of the digit set");
+			return xMult[d.get_si()+maxDigit];
+		};
+
+		//the datapath of each of the lanes
+		//	the coefficients are read directly (no selectLane), so that the model can run on several threads
+		vector<vector<mpz_class>> laneDigits(nbLanes);
+		for(size_t lane=0; lane<nbLanes; lane++)
+		{
+			size_t coeffsLane = (segmentBits > 0 ? segment : lane);
+			size_t laneDegree = std::max(lanesN[coeffsLane], lanesM[coeffsLane]);
+			mpfr_t *laneMpCoeffsP = lanesMpCoeffsP[coeffsLane];
+			mpfr_t *laneMpCoeffsQ = lanesMpCoeffsQ[coeffsLane];
+			const vector<vector<int>>& laneCuLsbTrunc = lanesCuLsbTrunc[lane];
+			vector<mpz_class> W(laneDegree), WC(laneDegree), D(laneDegree), Qv(laneDegree), digits(nbIter+1);
+			mpfr_t mpTmp, mpSum;
+
+			mpfr_inits2(LARGEPREC+64, mpTmp, mpSum, (mpfr_ptr)nullptr);
+
+			//one iteration done by the computation units and the selection functions
+			auto iteration = [&](size_t iter)
+			{
+				vector<mpz_class> nextW(laneDegree), nextWC(laneDegree);
+
+				for(size_t i=0; i<laneDegree; i++)
+				{
+					int specialCase = (i == 0 ? -1 : (i == laneDegree-1 ? +1 : 0));
+					int lsbTrunc = lsbInt;
+					mpz_class sum;
+
+					if((iter < laneCuLsbTrunc.size()) && (i < laneCuLsbTrunc[iter].size())
+							&& (laneCuLsbTrunc[iter][i] != CU_NO_TRUNCATION) && (laneCuLsbTrunc[iter][i] > lsbInt))
+						lsbTrunc = laneCuLsbTrunc[iter][i];
+
+					//in carry-save form, the terms are reduced bit by bit, as by the rows of full adders of the unit
+					if(carrySave)
+					{
+						int width = msbInt-lsbTrunc+1;
+						vector<mpz_class> terms;
+						mpz_class s, c;
+						auto addTerm = [&](mpz_class v)
+						{
+							mpz_class r;
+
+							mpz_fdiv_r_2exp(r.get_mpz_t(), v.get_mpz_t(), width);
+							terms.push_back(r);
+						};
+
+						addTerm(align(W[i], lsbW, lsbTrunc));
+						addTerm(align(WC[i], lsbW, lsbTrunc));
+						addTerm((-D[i]-1) << (lsbD-lsbTrunc));
+						if(specialCase != 1)
+							addTerm(align(digitTimesX(D[i+1]), lsbDiMX, lsbTrunc));
+						sum = mpz_class(1) << (lsbD-lsbTrunc);
+						if(specialCase != -1)
+						{
+							mpfr_mul_si(mpTmp, laneMpCoeffsQ[i], -D[0].get_si(), GMP_RNDN);
+							mpfr_mul_2si(mpTmp, mpTmp, lsbD, GMP_RNDN);
+							sum += roundToLsb(mpTmp, lsbTrunc);
+						}
+						addTerm(sum);
+						GenericComputationUnit::reduceCarrySave(terms, width, &s, &c);
+
+						//multiply by the radix, the bits below lsbTrunc being zero
+						nextW[i] = align(wrap(s << log2Radix, width), lsbTrunc, lsbInt);
+						nextWC[i] = align(wrap(c << log2Radix, width), lsbTrunc, lsbInt);
+						continue;
+					}
+
+					//w_i[j-1], truncated to lsbTrunc
+					sum = align(W[i], lsbW, lsbTrunc);
+					//-d_0[j-1]*q_i
+					if((specialCase != -1) && (segmentBits > 0))
+					{
+						int lsbQTrunc = (lsbQ < lsbTrunc ? lsbTrunc : lsbQ);
+
+						sum -= align(D[0] * align(Qv[i], lsbQ, lsbQTrunc), lsbQTrunc+lsbD, lsbTrunc);
+					}
+					else if(specialCase != -1)
+					{
+						mpfr_mul_si(mpTmp, laneMpCoeffsQ[i], -D[0].get_si(), GMP_RNDN);
+						mpfr_mul_2si(mpTmp, mpTmp, lsbD, GMP_RNDN);
+						sum += roundToLsb(mpTmp, lsbTrunc);
+					}
+					//-d_i[j-1]
+					sum -= align(D[i], lsbD, lsbTrunc);
+					//+d_{i+1}[j-1]*x
+					if(specialCase != 1)
+						sum += align(digitTimesX(D[i+1]), lsbDiMX, lsbTrunc);
+
+					//multiply by the radix, the bits below lsbTrunc being zero
+					sum = wrap(sum, msbInt-lsbTrunc+1);
+					nextW[i] = align(wrap(sum << log2Radix, msbInt-lsbTrunc+1), lsbTrunc, lsbInt);
+				}
+				for(size_t i=0; i<laneDegree; i++)
+				{
+					W[i] = nextW[i];
+					WC[i] = nextWC[i];
+					D[i] = (carrySave ? selectCarrySave(W[i], WC[i]) : select(W[i]));
+				}
+			};
+
+			//iteration 1, from the constants or the table of the coefficients
+			for(size_t i=0; i<laneDegree; i++)
+			{
+				mpfr_mul_ui(mpTmp, laneMpCoeffsP[i], radix, GMP_RNDN);
+				W[i] = wrap(roundToLsb(mpTmp, lsbW), wW);
+				D[i] = wrap(roundToLsb(mpTmp, lsbD), wD);
+				if((segmentBits > 0) && (i > 0))
+					Qv[i] = wrap(roundToLsb(laneMpCoeffsQ[i], lsbQ), msbQ-lsbQ+1);
+			}
+			digits[1] = D[0];
+
+			//iteration 2, precomputed except for the terms in X, or done by computation units in segmented mode
+			if((nbIter >= 2) && (segmentBits == 0))
+			{
+				vector<mpz_class> d1(laneDegree);
+
+				for(size_t i=0; i<laneDegree; i++)
+				{
+					mpfr_mul_ui(mpTmp, laneMpCoeffsP[i], radix, GMP_RNDN);
+					d1[i] = roundToLsb(mpTmp, 0);
+				}
+				for(size_t i=0; i<laneDegree; i++)
+				{
+					mpz_class w2;
+
+					//	w_i^{j-1} - d_0^{j-1}*q_i - d_i^{j-1}
+					mpfr_mul_ui(mpSum, laneMpCoeffsP[i], radix, GMP_RNDN);
+					if(i > 0)
+					{
+						mpfr_mul_si(mpTmp, laneMpCoeffsQ[i], d1[0].get_si(), GMP_RNDN);
+						mpfr_sub(mpSum, mpSum, mpTmp, GMP_RNDN);
+					}
+					mpfr_sub_si(mpSum, mpSum, d1[i].get_si(), GMP_RNDN);
+					w2 = wrap(roundToLsb(mpSum, lsbW), wW);
+					//	+ x*d_{i+1}^{j-1}
+					if(i < laneDegree-1)
+						w2 = wrap(w2 + wrap(align(digitTimesX(d1[i+1]), lsbDiMX, lsbW), wW), wW);
+					W[i] = wrap(w2 << log2Radix, wW);
+					D[i] = (carrySave ? selectCarrySave(W[i], 0) : select(W[i]));
+				}
+				digits[2] = D[0];
+			}
+			else if(nbIter >= 2)
+			{
+				iteration(2);
+				digits[2] = D[0];
+			}
+
+			//iterations 3 to nbIter
+			for(size_t iter=3; iter<=nbIter; iter++)
+			{
+				iteration(iter);
+				digits[iter] = D[0];
+			}
+
+			//the sum of the digits, most significant first
+			mpz_class sum = 0, y;
+			for(size_t i=1; i<nbIter; i++)
+				sum += digits[i] << ((nbIter+g-1-i)*log2Radix);
+			sum = wrap(sum, wW);
+			mpz_fdiv_q_2exp(y.get_mpz_t(), sum.get_mpz_t(), g);
+			mpz_fdiv_r_2exp(y.get_mpz_t(), y.get_mpz_t(), msbInOut-lsbInOut+1);
+			outputs[laneOutputName(lane)] = y;
+
+			//the online outputs of the digits
+			if(onlineOutput)
+				for(size_t i=1; i<nbIter; i++)
+				{
+					mpz_fdiv_r_2exp(y.get_mpz_t(), digits[i].get_mpz_t(), wD);
+					outputs[laneOutputName(lane) + join("_D_", i)] = y;
+					outputs[laneOutputName(lane) + join("_D_", i, "_valid")] = tc->getInputValue("X_valid");
+				}
+			laneDigits[lane] = digits;
+
+			mpfr_clears(mpTmp, mpSum, (mpfr_ptr)nullptr);
+		}
+
+		//the online composition of the digits of lanes 0 and 1, as done by generateOnlineComposition()
+		if(onlineOutput && (onlineCompose != "none"))
+		{
+			int N = nbIter-1;
+			const vector<mpz_class>& a = laneDigits[0];
+			const vector<mpz_class>& b = laneDigits[1];
+			map<int, mpz_class> composed;
+
+			if(onlineCompose == "add")
+			{
+				vector<long> t(N+2, 0), w(N+2, 0), t2(N+2, 0), w2(N+2, 0);
+
+				//	z_k = a_k + b_k = 2*t_k + w_k
+				for(int k=1; k<=N; k++)
+				{
+					long z = a[k].get_si() + b[k].get_si();
+
+					t[k] = (z > 0 ? 1 : (z == -2 ? -1 : 0));
+					w[k] = ((z == 1) || (z == -1) ? -1 : 0);
+				}
+				//	z2_k = w_k + t_{k+1} = 2*t2_k + w2_k
+				for(int k=0; k<=N; k++)
+				{
+					long z2 = (k > 0 ? w[k] : 0) + (k < N ? t[k+1] : 0);
+
+					t2[k] = (z2 < 0 ? -1 : 0);
+					w2[k] = ((z2 == 1) || (z2 == -1) ? 1 : 0);
+				}
+				//	s_k = w2_k + t2_{k+1}
+				for(int k=-1; k<=N; k++)
+					composed[k] = (k >= 0 ? w2[k] : 0) + (k < N ? t2[k+1] : 0);
+			}
+			else
+			{
+				int delay = 3;
+				int msbV = 1;
+				int lsbV = -(N+delay);
+				int wV = msbV-lsbV+1;
+				vector<mpz_class> qA(N+1), qmA(N+1), qB(N+1), qmB(N+1);
+				mpz_class v, wRes = 0, vHat;
+
+				//the prefixes of the inputs and the prefixes minus one ulp, by on-the-fly conversion, in units of 2^-N
+				auto convert = [&](const vector<mpz_class>& d, vector<mpz_class>& q, vector<mpz_class>& qm)
+				{
+					q[0] = 0;
+					qm[0] = -(mpz_class(1) << N);
+					for(int k=1; k<=N; k++)
+					{
+						mpz_class ulp = mpz_class(1) << (N-k);
+
+						if(d[k] == 1)
+						{
+							q[k]  = q[k-1] + ulp;
+							qm[k] = q[k-1];
+						}
+						else if(d[k] == 0)
+						{
+							q[k]  = q[k-1];
+							qm[k] = qm[k-1] + ulp;
+						}
+						else
+						{
+							q[k]  = qm[k-1] + ulp;
+							qm[k] = qm[k-1];
+						}
+						q[k]  = wrap(q[k], N+1);
+						qm[k] = wrap(qm[k], N+1);
+					}
+				};
+				convert(a, qA, qmA);
+				convert(b, qB, qmB);
+
+				//	v[j] = 2*w[j-1] + (A[k-1]*b_k + B[k]*a_k)*2^-3, with k=j+3
+				for(int j=-delay+1; j<=N; j++)
+				{
+					int k = j+delay;
+
+					v = (j > -delay+1 ? mpz_class(wRes << 1) : mpz_class(0));
+					if(k <= N)
+						v += wrap(b[k]*qA[k-1], N+1) + wrap(a[k]*qB[k], N+1);
+					v = wrap(v, wV);
+					if(j >= 0)
+					{
+						//	p_j = SEL(v[j]), on the top 4 bits of v[j]
+						mpz_fdiv_q_2exp(vHat.get_mpz_t(), v.get_mpz_t(), wV-4);
+						composed[j] = (vHat >= 2 ? 1 : (vHat < -2 ? -1 : 0));
+						wRes = wrap(v - (composed[j] << -lsbV), wV);
+					}
+					else
+						wRes = v;
+				}
+			}
+
+			for(auto& d : composed)
+			{
+				mpz_class bits;
+
+				mpz_fdiv_r_2exp(bits.get_mpz_t(), d.second.get_mpz_t(), wD);
+				outputs[join("S_D_", vhdlize(d.first))] = bits;
+				outputs[join("S_D_", vhdlize(d.first), "_valid")] = tc->getInputValue("X_valid");
+			}
+			checkOnlineComposition(outputs);
+		}
+	}
+
+	void FixEMethodEvaluator::buildStandardTestCases(TestCaseList* tcl)
+	{
+		int offsetSize = (segmentBits > 0 ? msbInOut-lsbInOut+1-segmentBits : msbInOut-lsbInOut+1);
+		//the range of the value of X (the offset inside a segment, in segmented mode), as an integer
+		mpz_class xMin = (segmentBits > 0 ? mpz_class(0) : -(mpz_class(1) << (offsetSize-1)));
+		mpz_class xMax = (segmentBits > 0 ? (mpz_class(1) << offsetSize) : (mpz_class(1) << (offsetSize-1))) - 1;
+		set<mpz_class> tested;
+		size_t nbTests = 0;
+
+		//add the test case of the value x of X, in the given segment
+		auto addTest = [&](mpz_class x, size_t segment, string comment)
+		{
+			mpz_class svX;
+			TestCase *tc;
+
+			if((x < xMin) || (x > xMax))
+				return;
+			//the input as a bit vector
+			if(segmentBits > 0)
+				svX = (mpz_class(segment) << offsetSize) + x;
+			else
+				svX = (x < 0 ? x + (mpz_class(1) << offsetSize) : x);
+			if(tested.count(svX) > 0)
+				return;
+			tested.insert(svX);
+
+			tc = new TestCase(this);
+			tc->addInput("X", svX);
+			if(onlineOutput)
+				tc->addInput("X_valid", mpz_class(1));
+			tc->addComment(comment);
+			emulate(tc);
+			tcl->add(tc);
+			nbTests++;
+		};
+		//add the test cases of the inputs on both sides of the point t of the domain of the rational function
+		auto addPoint = [&](mpfr_t t, size_t segment, string comment)
+		{
+			mpfr_t mpU;
+			mpz_class u;
+
+			mpfr_init2(mpU, LARGEPREC);
+			if(scaleInput)
+				mpfr_div_d(mpU, t, inputScaleFactor, GMP_RNDN);
+			else
+				mpfr_set(mpU, t, GMP_RNDN);
+			mpfr_mul_2si(mpU, mpU, -lsbInOut, GMP_RNDN);
+			//the range check also avoids converting huge values
+			if((mpfr_cmp_z(mpU, mpz_class(xMin-1).get_mpz_t()) > 0) && (mpfr_cmp_z(mpU, mpz_class(xMax+1).get_mpz_t()) < 0))
+			{
+				mpfr_get_z(u.get_mpz_t(), mpU, GMP_RNDD);
+				addTest(u, segment, comment);
+				addTest(u+1, segment, comment);
+			}
+			mpfr_clear(mpU);
+		};
+
+		for(size_t segment=0; segment<(segmentBits > 0 ? nbSegments : 1); segment++)
+		{
+			string where = (segmentBits > 0 ? join(" of segment ", segment) : "");
+
+			//the ends of the domain, which are also the largest values of |x| checked by checkX()
+			addTest(0, segment, "x=0" + where);
+			addTest(1, segment, "smallest positive x" + where);
+			addTest(xMax, segment, "largest x" + where);
+			addTest(xMax-1, segment, "largest x-1ulp" + where);
+			if(segmentBits == 0)
+			{
+				addTest(-1, segment, "largest negative x");
+				addTest(xMin, segment, "smallest x");
+				addTest(xMin+1, segment, "smallest x+1ulp");
+			}
+		}
+
+		//the thresholds of the selection functions of the second iteration
+		//	w_i[2] = r*(r*p_i - d_0[1]*q_i - d_i[1] + d_{i+1}[1]*x) is affine in x, and the digit selected from it
+		//	changes when w_i[2] crosses (2k+1)*2^lsbWHat, so these thresholds give the inputs analytically
+		//	(the residuals of the later iterations depend on x through the digits, and are left to the random tests)
+		mpfr_t mpTmp, mpConst, mpT;
+		int log2Radix = ceil(log2(radix));
+
+		mpfr_inits2(LARGEPREC, mpTmp, mpConst, mpT, (mpfr_ptr)nullptr);
+		for(size_t coeffsLane=0; coeffsLane<(segmentBits > 0 ? nbSegments : nbLanes); coeffsLane++)
+		{
+			size_t laneDegree = std::max(lanesN[coeffsLane], lanesM[coeffsLane]);
+			mpfr_t *laneMpCoeffsP = lanesMpCoeffsP[coeffsLane];
+			mpfr_t *laneMpCoeffsQ = lanesMpCoeffsQ[coeffsLane];
+			size_t segment = (segmentBits > 0 ? coeffsLane : 0);
+			vector<long> d1(laneDegree);
+
+			//the digits of the first iteration
+			for(size_t i=0; i<laneDegree; i++)
+			{
+				mpfr_mul_ui(mpTmp, laneMpCoeffsP[i], radix, GMP_RNDN);
+				d1[i] = mpfr_get_si(mpTmp, GMP_RNDN);
+			}
+
+			for(size_t i=0; i+1<laneDegree; i++)
+			{
+				if(d1[i+1] == 0)
+					continue;
+
+				//the part of w_i[2]/r which does not depend on x
+				mpfr_mul_ui(mpConst, laneMpCoeffsP[i], radix, GMP_RNDN);
+				if(i > 0)
+				{
+					mpfr_mul_si(mpTmp, laneMpCoeffsQ[i], d1[0], GMP_RNDN);
+					mpfr_sub(mpConst, mpConst, mpTmp, GMP_RNDN);
+				}
+				mpfr_sub_si(mpConst, mpConst, d1[i], GMP_RNDN);
+
+				//x = ((2k+1)*2^lsbWHat/r - const) / d_{i+1}
+				for(int k=-(int)maxDigit; k<(int)maxDigit; k++)
+				{
+					mpfr_set_si(mpT, 2*k+1, GMP_RNDN);
+					mpfr_mul_2si(mpT, mpT, lsbWHat-log2Radix, GMP_RNDN);
+					mpfr_sub(mpT, mpT, mpConst, GMP_RNDN);
+					mpfr_div_si(mpT, mpT, d1[i+1], GMP_RNDN);
+					ostringstream comment;
+
+					comment << "selection threshold between digits " << k << " and " << k+1 << " of w_" << i << "[2]"
+							<< (segmentBits > 0 ? join(" of segment ", segment) : (nbLanes > 1 ? join(" of lane ", coeffsLane) : ""));
+					addPoint(mpT, segment, comment.str());
+				}
+			}
+		}
+
+		//the points given by the user, such as the extrema of the approximation error
+		for(size_t i=0; i<testPoints.size(); i++)
+		{
+			mpfr_set_d(mpT, testPoints[i], GMP_RNDN);
+			addPoint(mpT, testPointSegments[i], testPointComments[i]);
+		}
+		mpfr_clears(mpTmp, mpConst, mpT, (mpfr_ptr)nullptr);
+
+		REPORT(INFO, "Built " << nbTests << " corner-case test cases");
+	}
+
+	void FixEMethodEvaluator::addTestPoint(double x, size_t segment, string comment)
+	{
+		if((segmentBits > 0) && (segment >= nbSegments))
+			THROWERROR("addTestPoint: segment " << segment << " out of the " << nbSegments << " segments");
+
+		testPoints.push_back(x);
+		testPointSegments.push_back(segment);
+		testPointComments.push_back(comment == "" ? join("test point ", x) : comment);
+	}
+
+	ResourceEstimate FixEMethodEvaluator::estimateOwnResources()
+	{
+		ResourceEstimate r = Operator::estimateOwnResources();
+		Target *target = getTarget();
+		int wW = msbW-lsbW+1;
+		int wD = msbD-lsbD+1;
+
+		//the sum of the digits of the result, for each lane
+		r.lut = nbLanes * wW * target->getLUTPerAdderSubtracter(wW, wW);
+		//the first row of a folded architecture selects between the initial values and the fed back residuals
+		if(foldingFactor > 1)
+			r.lut += maxDegree * (wW+wD) * target->getLUTFromMux(2);
+
+		return r;
+	}
+
+	const vector<string>& FixEMethodEvaluator::firstCoefficientSet(const vector<vector<string>>& sets, string name)
+	{
+		//called from the initializer list, before the safety checks of the constructor
+		if(sets.empty())
+			throw string("FixEMethodEvaluator: no coefficient set given for " + name);
+		for(size_t i=0; i<sets.size(); i++)
+			if(sets[i].empty())
+				throw string("FixEMethodEvaluator: the coefficient set " + to_string(i) + " of " + name + " is empty");
+		return sets[0];
+	}
+
+	vector<vector<string>> FixEMethodEvaluator::parseCoefficientSets(string in)
+	{
+		vector<vector<string>> result;
+
+		//the coefficient sets of the different lanes are separated by '|'
+		//	the coefficients of a set by ':', from the highest degree
+		stringstream ssLanes(in);
+		string laneStr, substr;
+		while(std::getline(ssLanes, laneStr, '|'))
+		{
+			vector<string> laneCoeffs;
+			stringstream ss(laneStr);
+			while(std::getline(ss, substr, ':'))
+			{
+				laneCoeffs.insert(laneCoeffs.begin(), std::string(substr));
+			}
+			result.push_back(laneCoeffs);
+		}
+
+		return result;
 	}
 
 	OperatorPtr FixEMethodEvaluator::parseArguments(Target *target, std::vector<std::string> &args) {
@@ -957,11 +2991,19 @@ namespace flopoco {
 		int maxDigit;
 		int msbIn;
 		int lsbIn;
-		vector<string> coeffsP;
-		vector<string> coeffsQ;
+		vector<vector<string>> coeffsP;
+		vector<vector<string>> coeffsQ;
 		double delta;
 		bool scaleInput;
 		double inputScaleFactor;
+		int foldingFactor;
+		int segmentBits;
+		bool onlineOutput;
+		string onlineCompose;
+		bool trimWidths;
+		string selection;
+		bool carrySave;
+		string multiples;
 		string in, in2;
 
 		UserInterface::parseStrictlyPositiveInt(args, "radix", &radix);
@@ -973,24 +3015,28 @@ namespace flopoco {
 		UserInterface::parseFloat(args, "delta", &delta);
 		UserInterface::parseBoolean(args, "scaleInput", &scaleInput);
 		UserInterface::parseFloat(args, "inputScaleFactor", &inputScaleFactor);
-
-		stringstream ss(in);
-		string substr;
-		while(std::getline(ss, substr, ':'))
+		UserInterface::parseStrictlyPositiveInt(args, "foldingFactor", &foldingFactor);
+		UserInterface::parsePositiveInt(args, "segmentBits", &segmentBits);
+		UserInterface::parseBoolean(args, "onlineOutput", &onlineOutput);
+		UserInterface::parseString(args, "onlineCompose", &onlineCompose);
+		UserInterface::parseBoolean(args, "trimWidths", &trimWidths);
+		UserInterface::parseString(args, "selection", &selection);
+		UserInterface::parseBoolean(args, "carrySave", &carrySave);
+		UserInterface::parseString(args, "multiples", &multiples);
+
+		coeffsP = parseCoefficientSets(in);
+		coeffsQ = parseCoefficientSets(in2);
+
+		if((coeffsP.size() == 0) || (coeffsP.size() != coeffsQ.size()))
 		{
-			coeffsP.insert(coeffsP.begin(), std::string(substr));
-			//coeffsP.push_back(std::string(substr));
-		}
-
-		stringstream ss2(in2);
-		while(std::getline(ss2, substr, ':'))
-		{
-			coeffsQ.insert(coeffsQ.begin(), std::string(substr));
-			//coeffsQ.push_back(std::string(substr));
+			ostringstream error;
+			error << "FixEMethodEvaluator: coeffsP and coeffsQ must contain the same number of '|'-separated coefficient sets";
+			throw error.str();
 		}
 
 		OperatorPtr result = new FixEMethodEvaluator(target, radix, maxDigit, msbIn, lsbIn,
-				coeffsP, coeffsQ, delta, scaleInput, inputScaleFactor);
+				coeffsP, coeffsQ, delta, scaleInput, inputScaleFactor, foldingFactor, segmentBits,
+				onlineOutput, onlineCompose, trimWidths, selection, carrySave, multiples);
 
 		return result;
 	}
@@ -1005,10 +3051,20 @@ namespace flopoco {
 				 msbIn(int): MSB of the input;\
 				 lsbIn(int): LSB of the input;\
 				 coeffsP(string): colon-separated list of real coefficients of polynomial P, using Sollya syntax. Example: coeff=\"1.234567890123:sin(3*pi/8)\";\
-				 coeffsQ(string): colon-separated list of real coefficients of polynomial Q, using Sollya syntax. Example: coeff=\"1.234567890123:sin(3*pi/8)\";\
+				 coeffsQ(string): colon-separated list of real coefficients of polynomial Q, using Sollya syntax. Example: coeff=\"1.234567890123:sin(3*pi/8)\". \
+				   Several lanes sharing the same input can be generated by giving '|'-separated lists for coeffsP and coeffsQ, with outputs Y_0, Y_1 etc.;\
 				 delta(real)=0.5: the value for the delta parameter in the E-method algorithm;\
 				 scaleInput(bool)=false: flag showing if the input is to be scaled by the factor delta;\
-				 inputScaleFactor(real)=-1: the factor by which the input is scaled"
+				 inputScaleFactor(real)=-1: the factor by which the input is scaled;\
+				 foldingFactor(int)=1: the number of cycles for which a row of computation units is reused, 1 meaning fully unrolled;\
+				 segmentBits(int)=0: when positive, the '|'-separated coefficient sets are the 2^segmentBits segments of an unsigned input, indexed by its top bits;\
+				 onlineOutput(bool)=false: output the digits of the result as soon as they are computed, with a valid signal;\
+				 onlineCompose(string)=none: combine the digits of two lanes online, one of none, add or mul (radix 2 only);\
+				 trimWidths(bool)=false: truncate the computation units of the last iterations, using an error analysis;\
+				 selection(string)=auto: the implementation of the selection functions, one of auto, logic, compressed or rom (see GenericSimpleSelectionFunction);\
+				 carrySave(bool)=false: keep the residuals in carry-save form, so that the delay of an iteration does not depend on the width of the residuals (requires delta>0);\
+				 multiples(string)=mcm: the implementation of the multiples of X by the digits, one of mcm (a multiple constant multiplier sharing the intermediate sums), \
+				   single (a constant multiplier for each multiple) or table (a table indexed by X, for large radices and inputs of at most 12 bits)"
 				"",
 				"",
 				FixEMethodEvaluator::parseArguments,
@@ -1023,7 +3079,93 @@ namespace flopoco {
 		TestList testStateList;
 		vector<pair<string,string>> paramList;
 
+		if(index==-1)
+		{ // The unit tests
+			// the parameters of emethodHW: x in [-1,1), scaled by 1/32, delta=1/8
+			//	the coefficients of Q satisfy checkQCoeffs() up to radix 8, where alpha-1/32 > 1/64
+			string coeffsP = "0.0625:0.125:0.25:0.5";
+			string coeffsQ = "0.015625:0.015625:0.015625:1";
+			auto addTest = [&](size_t radix, size_t maxDigit, int lsbIn, vector<pair<string,string>> options)
+			{
+				paramList.push_back(make_pair("radix", to_string(radix)));
+				paramList.push_back(make_pair("maxDigit", to_string(maxDigit)));
+				paramList.push_back(make_pair("msbIn", to_string(0)));
+				paramList.push_back(make_pair("lsbIn", to_string(lsbIn)));
+				paramList.push_back(make_pair("delta", "0.125"));
+				paramList.push_back(make_pair("scaleInput", "true"));
+				// the options may replace the coefficients and the scale factor
+				bool hasCoeffs = false, hasScaleFactor = false;
+				for(auto& option : options)
+				{
+					hasCoeffs |= (option.first == "coeffsP");
+					hasScaleFactor |= (option.first == "inputScaleFactor");
+				}
+				if(!hasScaleFactor)
+					paramList.push_back(make_pair("inputScaleFactor", "0.03125"));
+				if(!hasCoeffs)
+				{
+					paramList.push_back(make_pair("coeffsP", coeffsP));
+					paramList.push_back(make_pair("coeffsQ", coeffsQ));
+				}
+				paramList.insert(paramList.end(), options.begin(), options.end());
+				testStateList.push_back(paramList);
+				paramList.clear();
+			};
 
+			// the radices and digit sets, on two input widths
+			for(int lsbIn=-8; lsbIn>=-16; lsbIn-=8)
+			{
+				addTest(2, 1, lsbIn, {});
+				addTest(4, 2, lsbIn, {});
+				addTest(4, 3, lsbIn, {});
+				addTest(8, 7, lsbIn, {});
+			}
+			// radices 16 and 32, where alpha < 1/32: smaller coefficients of Q and input, scaled by 1/256
+			vector<pair<string,string>> smallAlpha = {make_pair("coeffsP", coeffsP),
+					make_pair("coeffsQ", "0.00390625:0.00390625:0.00390625:1"), make_pair("inputScaleFactor", "0.00390625")};
+			addTest(16, 15, -16, smallAlpha);
+			addTest(32, 31, -16, smallAlpha);
+			// the implementations of the selection functions
+			for(string selection : {"logic", "compressed", "rom"})
+			{
+				auto options = smallAlpha;
+				options.push_back(make_pair("selection", selection));
+				addTest(8, 7, -16, {make_pair("selection", selection)});
+				addTest(32, 31, -16, options);
+			}
+			// a polynomial (Q=1)
+			addTest(2, 1, -16, {make_pair("coeffsP", coeffsP), make_pair("coeffsQ", "1")});
+			// the variants of the architecture
+			addTest(2, 1, -16, {make_pair("foldingFactor", "2"), make_pair("pipeline", "true")});
+			addTest(4, 3, -16, {make_pair("foldingFactor", "2"), make_pair("pipeline", "true")});
+			addTest(2, 1, -16, {make_pair("trimWidths", "true")});
+			addTest(4, 3, -24, {make_pair("trimWidths", "true")});
+			addTest(2, 1, -16, {make_pair("coeffsP", coeffsP + "|0.125:0.25:0.5:0.25"),
+					make_pair("coeffsQ", coeffsQ + "|0:0.015625:0:1")});
+			addTest(2, 1, -16, {make_pair("coeffsP", coeffsP + "|0.125:0.25:0.5:0.25"),
+					make_pair("coeffsQ", coeffsQ + "|0:0.015625:0:1"), make_pair("segmentBits", "1")});
+			// lanes of different degrees
+			for(string trim : {"false", "true"})
+				addTest(2, 1, -16, {make_pair("coeffsP", coeffsP + "|0.25:0.5"),
+						make_pair("coeffsQ", coeffsQ + "|0.015625:1"), make_pair("trimWidths", trim)});
+			addTest(2, 1, -16, {make_pair("onlineOutput", "true")});
+			for(string compose : {"add", "mul"})
+				addTest(2, 1, -16, {make_pair("coeffsP", coeffsP + "|0.125:0.25:0.5:0.25"),
+						make_pair("coeffsQ", coeffsQ + "|0:0.015625:0:1"), make_pair("onlineOutput", "true"),
+						make_pair("onlineCompose", compose)});
+			addTest(2, 1, -16, {make_pair("carrySave", "true")});
+			addTest(8, 7, -16, {make_pair("carrySave", "true")});
+			addTest(4, 3, -24, {make_pair("carrySave", "true"), make_pair("trimWidths", "true")});
+			smallAlpha.push_back(make_pair("carrySave", "true"));
+			addTest(32, 31, -16, smallAlpha);
+			// the implementations of the multiples of X
+			addTest(8, 7, -16, {make_pair("multiples", "single")});
+			addTest(8, 7, -8, {make_pair("multiples", "table")});
+		}
+		else
+		{
+				// finite number of random test computed out of index
+		}
 
 		return testStateList;
 	}
@@ -15,6 +15,9 @@
 #include <iostream>
 #include <sstream>
 #include <iterator>
+#include <map>
+#include <set>
+#include <functional>
 
 #include <sollya.h>
 #include <gmpxx.h>
@@ -23,9 +26,11 @@
 #include "Signal.hpp"
 
 #include "ConstMult/IntConstMult.hpp"
+#include "ConstMult/IntConstMCM.hpp"
 #include "BitHeap/BitHeap.hpp"
 
 #include "FixFunctions/FixFunction.hpp"
+#include "FixFunctions/GenericTable.hpp"
 #include "FixConstant.hpp"
 #include "FixFunctions/E-method/GenericSimpleSelectionFunction.hpp"
 #include "FixFunctions/E-method/GenericComputationUnit.hpp"
@@ -81,6 +86,43 @@ namespace flopoco {
 	 *		w_0[j] = r * (w_0[j-1] - d_0[j-1] + d_1[j-1]*x)
 	 *	For i=n, the iteration step is:
 	 *		w_n[j] = r * (w_n[j-1] - d_0[j-1]*q_n - d_n[j-1])
+	 *
+	 *	By default, all the iterations are unrolled, which gives a circuit accepting a new input every cycle.
+	 *	When a folding factor F>1 is given, iterations 3 to nbIter-1 are computed by
+	 *	ceil((nbIter-3)/F) rows of computation units, which are reused for F cycles.
+	 *	A new input is then accepted every F cycles (the initiation interval of the operator).
+	 *
+	 *	Several rational functions of the same input can be evaluated by a single operator (lanes).
+	 *	The lanes share the scaling of the input and the multiples of X by the digits,
+	 *	while each of them has its own computation units and outputs Y_0, Y_1 etc.
+	 *
+	 *	In segmented mode, the (unsigned) input domain is split into 2^k segments, each with its own
+	 *	rational approximation. The top k bits of X index a table holding the coefficients of each
+	 *	segment, and the rest of X is the input of the approximation. The computation units then use
+	 *	generic multipliers for q_i, instead of multipliers by constants.
+	 *
+	 *	The digits of the result are produced most significant first, one per iteration.
+	 *	In online output mode, each digit D_i (i=1..nbIter-1, of weight radix^(nbIter-1-i) ulps of Y)
+	 *	is also output as soon as it is computed, on Y_D_i, along with a valid signal Y_D_i_valid
+	 *	which is the input X_valid delayed accordingly. The digits depend on the faithful roundings
+	 *	of the constant multipliers, so the test bench only checks Y and the valid signals written
+	 *	at the last cycle of the pipeline (all of them, when the operator is not pipelined).
+	 *	For two lanes in radix 2, the digits can also be combined by an online adder (online delay 2)
+	 *	or an online multiplier (online delay 3), whose digits S_D_j are output as soon as they are computed:
+	 *		Y_0 + Y_1 = 2^msbInOut     * sum(S_D_j * 2^-j), j=-1..nbIter-1
+	 *		Y_0 * Y_1 = 2^(2*msbInOut) * sum(S_D_j * 2^-j), j=0..nbIter-1
+	 *
+	 *	When trimming the widths, the computation units of iterations 3 to nbIter are truncated.
+	 *	An error e in w_i[j] changes the result by at most e * r^-j * alpha^i / min|Q(x)|,
+	 *	so each unit is truncated to the largest LSB keeping the sum of these errors
+	 *	under 2^lsbW / (2*r), while leaving the selection enough bits of the residual.
+	 *
+	 *	With carry-save residuals, the w_i[j] are kept as a pair of vectors (W_j_i, WC_j_i) whose sum is the residual.
+	 *	The computation units reduce their terms by rows of full adders instead of a carry-propagate adder,
+	 *	and the selection functions add the top bits of the pair, down to the LSB where the truncation error
+	 *	stays under delta/2: this is the margin of the selection, as |w - d| <= xi = (1+delta)/2.
+	 *	The delay of an iteration then no longer depends on the width of W, for a few more LUTs per unit.
+	 *	The MSBs of W and the format of D are fixed by the convergence bounds and by the digit set.
 	*/
 
   class FixEMethodEvaluator : public Operator
@@ -101,6 +143,8 @@ namespace flopoco {
      *                               set to false by default
      * @param   inputScaleFactor     factor by which to scale the input
      *                               set by default to -1, meaning that the input is scaled by 1/2*alpha
+     * @param   foldingFactor        the number of cycles for which each row of computation units is reused
+     *                               set by default to 1, meaning a fully unrolled architecture
      */
 	FixEMethodEvaluator(Target* target,
 			size_t radix,
@@ -112,6 +156,49 @@ namespace flopoco {
 			double delta = 0.5,
 			bool scaleInput = false,
 			double inputScaleFactor = -1,
+			size_t foldingFactor = 1,
+			map<string, double> inputDelays = emptyDelayMap);
+
+    /**
+     * A constructor for several lanes, evaluating different rational functions on the same input,
+     * or for a segmented evaluator, evaluating a different rational function on each segment of the input.
+     * @param   coeffsP              vector holding, for each lane (or segment), the coefficients of polynomial P
+     * @param   coeffsQ              vector holding, for each lane (or segment), the coefficients of polynomial Q
+     * @param   segmentBits          the number of top bits of the input indexing the segments
+     *                               set by default to 0, meaning that the coefficient sets are lanes
+     * @param   onlineOutput         flag showing if the digits of the result are output as soon as they are computed
+     *                               set to false by default
+     * @param   onlineCompose        the online operation combining the digits of two lanes: "none", "add" or "mul"
+     *                               set to "none" by default
+     * @param   trimWidths           flag showing if the computation units are truncated using an error analysis
+     *                               set to false by default
+     * @param   selection            the implementation of the selection functions: "auto", "logic", "compressed" or "rom"
+     *                               (see GenericSimpleSelectionFunction), set to "auto" by default
+     * @param   carrySave            flag showing if the residuals are kept in carry-save form, which requires delta > 0
+     *                               set to false by default
+     * @param   multiples            the implementation of the multiples of X by the digits: "mcm" (a multiple constant
+     *                               multiplier), "single" (a constant multiplier for each multiple) or "table"
+     *                               set to "mcm" by default
+     * The other parameters are the same as for the single lane constructor.
+     */
+	FixEMethodEvaluator(Target* target,
+			size_t radix,
+			size_t maxDigit,
+			int msbInOut,
+			int lsbInOut,
+			vector<vector<string>> coeffsP,
+			vector<vector<string>> coeffsQ,
+			double delta = 0.5,
+			bool scaleInput = false,
+			double inputScaleFactor = -1,
+			size_t foldingFactor = 1,
+			int segmentBits = 0,
+			bool onlineOutput = false,
+			string onlineCompose = "none",
+			bool trimWidths = false,
+			string selection = "auto",
+			bool carrySave = false,
+			string multiples = "mcm",
 			map<string, double> inputDelays = emptyDelayMap);
 
 	/**
@@ -124,6 +211,67 @@ namespace flopoco {
      */
     void emulate(TestCase * tc);
 
+    /** emulate() only reads the operator, so the test cases can be generated on several threads */
+    bool hasThreadSafeEmulate();
+
+    /** simulateBitAccurate() is implemented */
+    bool hasBitAccurateModel();
+
+    /**
+     * The outputs Y of the architecture, computed with the recurrence on the formats of the signals:
+     * the iterations, the selection functions and the sum of the digits are computed bit for bit,
+     * as are the online outputs of the digits and of their composition, whose consistency it checks.
+     * The faithful multipliers by constants (the scaling of X and d_0*q_i) are modelled by a rounding
+     * to nearest, which is one of the two values they may return.
+     */
+    void simulateBitAccurate(TestCase * tc, map<string, mpz_class>& outputs);
+
+    /**
+     * The corner cases of the input, derived from the parameters of the architecture:
+     * the ends of the input domain (of each segment), the inputs on both sides of the thresholds
+     * of the selection functions of the second iteration, and the points given with addTestPoint()
+     */
+    void buildStandardTestCases(TestCaseList* tcl);
+
+    /**
+     * Add a point at which the operator is to be tested, such as an extremum of the approximation error
+     * @param   x                    the point, in the domain of the rational function (after the scaling of the input)
+     * @param   segment              the segment of the point, in segmented mode
+     * @param   comment              the comment of the test cases of the point
+     */
+    void addTestPoint(double x, size_t segment = 0, string comment = "");
+
+    /**
+     * The LUTs of the logic outside the computation units and the selection functions:
+     * the sum of the digits of each lane, and the feedback multiplexers of a folded architecture
+     */
+    ResourceEstimate estimateOwnResources();
+
+    /**
+     * The parameters xi and alpha of the E-method, for a given radix and delta,
+     * as used by setAlgorithmParameters()
+     */
+    static void getAlgorithmParameters(int radix, double delta, double *xi, double *alpha);
+
+    /**
+     * The number of adders of the multiples of X by the digits 1 to maxDigit, without the negations:
+     * for "single", an adder per non-zero digit of each multiple in CSD but the first,
+     * for "mcm", the lower bound of one adder per odd multiple, the even ones being shifts
+     */
+    static int countMultiplesAdders(int maxDigit, string method);
+
+    /**
+     * Split the '|'-separated coefficient sets of the coeffsP and coeffsQ parameters,
+     * each of them a ':'-separated list from the highest degree, into lists from the lowest degree
+     */
+    static vector<vector<string>> parseCoefficientSets(string in);
+
+    /**
+     * The first of the coefficient sets of P or Q, which gives the coefficients of a single lane;
+     * throws if there is no set, or if one of them is empty
+     */
+    static const vector<string>& firstCoefficientSet(const vector<vector<string>>& sets, string name);
+
     // User-interface stuff
     /**
      * Factory method
@@ -140,6 +288,105 @@ namespace flopoco {
      */
     void copyVectors();
 
+    /**
+     * Make the coefficients of the given lane the current ones
+     */
+    void selectLane(size_t lane);
+
+    /**
+     * The prefix of the signals of the given lane (empty when there is a single lane)
+     */
+    string lanePrefixName(size_t lane);
+
+    /**
+     * The name of the output of the given lane
+     */
+    string laneOutputName(size_t lane);
+
+    /**
+     * Generate the datapath of the current lane, from iteration 0 to the sum of the result digits
+     */
+    void generateLane(GenericSimpleSelectionFunction *sel);
+
+    /**
+     * Generate one iteration of the unrolled datapath of the current lane
+     */
+    void generateIteration(size_t iter, GenericComputationUnit *cu0, GenericComputationUnit **cuI,
+    		GenericComputationUnit *cuN, GenericSimpleSelectionFunction *sel);
+
+    /**
+     * Create (and add as a sub-component) the computation unit of the given index and special case, for the current lane,
+     * truncated to lsbTrunc (CU_NO_TRUNCATION for none)
+     */
+    GenericComputationUnit* createComputationUnit(size_t index, int specialCase, int lsbTrunc);
+
+    /**
+     * The computation unit to use at the given iteration and index: either the given unit,
+     * or a truncated version of it, when the widths are trimmed
+     */
+    GenericComputationUnit* getComputationUnit(size_t iter, size_t index, int specialCase, GenericComputationUnit *cu);
+
+    /**
+     * Compute the LSB to which each computation unit of each lane can be truncated, and report the savings
+     */
+    void computeTruncatedWidths();
+
+    /**
+     * Compute the LSB to which each computation unit of the selected lane can be truncated, in cuLsbTrunc
+     */
+    void computeLaneTruncatedWidths(size_t lane);
+
+    /**
+     * Generate the table of the coefficients of the segments, and the residual vector
+     * and the digits of iteration 1 out of it
+     */
+    void generateCoefficientTable();
+
+    /**
+     * Generate the multiples X_Mult_i of the scaled input by the digits 0 to maxDigit, using the method in multiples,
+     * and report their number of adders
+     * @param   startCycle           the cycle of the scaled input
+     * @param   startCriticalPath    the critical path of the scaled input
+     */
+    void generateMultiplesOfX(int startCycle, double startCriticalPath);
+
+    /**
+     * Declare the signed multiple X_Mult_c out of the unsigned product c*U of the bits U of X
+     * @param   product              the name of the unsigned product
+     * @param   productWidth         the width of the unsigned product
+     */
+    void generateSignedMultiple(size_t c, string product, int productWidth);
+
+    /**
+     * Output the digits of the result of the current lane, each as soon as it is computed
+     */
+    void generateOnlineDigits();
+
+    /**
+     * Instantiate the selection units of the residuals wPrefix<i>, for the given indices i, with outputs dPrefix<i>
+     * @param   inputCriticalPath    when positive, each unit starts at the cycle of its inputs, with this critical path
+     * @param   wcPrefix             the prefix of the carry bits of the residuals, in carry-save form
+     */
+    void instanceSelections(GenericSimpleSelectionFunction *sel, vector<size_t> indices,
+    		string wPrefix, string dPrefix, string instancePrefix, double inputCriticalPath = -1, string wcPrefix = "");
+
+    /**
+     * Report the estimated delay and LUTs of an iteration, with the residuals in carry-save
+     * and in non-redundant form, from the cost functions of the units
+     */
+    void reportResidualForm();
+
+    /**
+     * Combine the digits of the results of lanes 0 and 1 using an online adder or multiplier
+     */
+    void generateOnlineComposition(GenericSimpleSelectionFunction *sel);
+
+    /**
+     * Check the digits of the online composition against the digits of the lanes, as given by simulateBitAccurate():
+     * the online sum is exact, and the online product is within 2^-(nbIter-1) of the product of the lanes
+     */
+    void checkOnlineComposition(map<string, mpz_class>& outputs);
+
     /**
      * Set the parameters of the algorithm that depend on delta and Q's coefficients
      */
@@ -163,18 +410,24 @@ namespace flopoco {
      */
     void checkX();
 
+    /**
+     * Generate the folded datapath for iterations 3 to nbIter-1,
+     * along with its controller and the accumulation of the result digits
+     */
+    void generateFoldedIterations(GenericComputationUnit *cu0, GenericComputationUnit **cuI,
+    		GenericComputationUnit *cuN, GenericSimpleSelectionFunction *sel);
 
   private:
     size_t radix;                     /**< the radix used for the implementation */
     size_t maxDigit;                  /**< the radix used for the implementation */
-    size_t n;                         /**< degree of the polynomial P */
-    size_t m;                         /**< degree of the polynomial Q */
+    size_t n;                         /**< degree of the polynomial P (of the current lane) */
+    size_t m;                         /**< degree of the polynomial Q (of the current lane) */
     int msbInOut;                     /**< MSB of the input/output */
     int lsbInOut;                     /**< LSB of the input/output */
-    vector<string> coeffsP;           /**< vector of the coefficients of P */
-    vector<string> coeffsQ;           /**< vector of the coefficients of Q */
-    mpfr_t mpCoeffsP[10000];          /**< vector of the coefficients of P */
-    mpfr_t mpCoeffsQ[10000];          /**< vector of the coefficients of Q */
+    vector<string> coeffsP;           /**< vector of the coefficients of P (of the current lane) */
+    vector<string> coeffsQ;           /**< vector of the coefficients of Q (of the current lane) */
+    mpfr_t *mpCoeffsP;                /**< vector of the coefficients of P (of the current lane) */
+    mpfr_t *mpCoeffsQ;                /**< vector of the coefficients of Q (of the current lane) */
 
     double delta;                     /**< the parameter delta in the E-Method algorithm */
     double alpha;                     /**< the parameter alpha in the E-Method algorithm */
@@ -183,7 +436,37 @@ namespace flopoco {
     bool scaleInput;                  /**< flag showing whether the input X to the circuit will be scaled, or not */
     double inputScaleFactor;          /**< the factor by which the input is scaled */
 
-    size_t maxDegree;                 /**< the maximum between the degrees of the polynomials P and Q */
+    size_t foldingFactor;             /**< the number of cycles for which a row of computation units is reused */
+    size_t nbFoldedRows;              /**< the number of rows of computation units in the folded architecture */
+
+    size_t maxDegree;                 /**< the maximum between the degrees of the polynomials P and Q (of the current lane) */
+
+    size_t nbLanes;                   /**< the number of rational functions evaluated on the same input */
+    vector<vector<string>> lanesCoeffsP; /**< the coefficients of P, for each lane */
+    vector<vector<string>> lanesCoeffsQ; /**< the coefficients of Q, for each lane */
+    vector<mpfr_t*> lanesMpCoeffsP;   /**< the coefficients of P, as mp numbers, for each lane */
+    vector<mpfr_t*> lanesMpCoeffsQ;   /**< the coefficients of Q, as mp numbers, for each lane */
+    vector<size_t> lanesN;            /**< the degree of P, for each lane */
+    vector<size_t> lanesM;            /**< the degree of Q, for each lane */
+    string lanePrefix;                /**< the prefix of the signals of the current lane */
+    string laneOutput;                /**< the name of the output of the current lane */
+
+    int segmentBits;                  /**< the number of top bits of the input indexing the segments (0 when not segmented) */
+    size_t nbSegments;                /**< the number of segments of the input domain */
+
+    bool onlineOutput;                /**< flag showing whether the digits of the result are output as soon as they are computed */
+    string onlineCompose;             /**< the online operation combining the digits of two lanes ("none", "add" or "mul") */
+    int firstComposedDigit;           /**< the index of the most significant digit of the online composition */
+    map<string, int> onlineValidCycles; /**< the cycle at which each valid signal of the online outputs is written */
+
+    bool trimWidths;                  /**< flag showing whether the computation units are truncated */
+    string selection;                 /**< the implementation of the selection functions */
+    bool carrySave;                   /**< flag showing whether the residuals are kept in carry-save form */
+    string multiples;                 /**< the implementation of the multiples of X: "mcm", "single" or "table" */
+    vector<vector<int>> cuLsbTrunc;   /**< the LSB of each computation unit of the current lane, indexed by iteration and index (CU_NO_TRUNCATION if not truncated) */
+    vector<vector<vector<int>>> lanesCuLsbTrunc; /**< cuLsbTrunc, for each lane */
+    map<string, GenericComputationUnit*> laneTruncatedCUs; /**< the truncated computation units of the current lane, by index, special case and LSB */
+
     size_t nbIter;                    /**< the number of iterations */
     int g;                            /**< number of guard bits */
 
@@ -203,6 +486,13 @@ namespace flopoco {
     int msbDiMX;                      /**< the MSB of the DiMultX signals */
     int lsbDiMX;                      /**< the LSB of the DiMultX signals */
     Signal *dDiMX;                    /**< dummy signal for DiMultX */
+    int msbQ;                         /**< the MSB of the Q signals, in segmented mode */
+    int lsbQ;                         /**< the LSB of the Q signals, in segmented mode */
+    Signal *dQ;                       /**< dummy signal for Q */
+
+    vector<double> testPoints;        /**< the points added with addTestPoint(), in the domain of the rational function */
+    vector<size_t> testPointSegments; /**< the segment of each of the test points */
+    vector<string> testPointComments; /**< the comment of each of the test points */
 
     int currentCycle;                 /**< used for pipelining to store the current cycle */
     double currentCriticalPath;       /**< used for pipelining to store the current critical path */
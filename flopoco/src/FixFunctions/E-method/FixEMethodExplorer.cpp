@@ -0,0 +1,356 @@
+/*
+
+  A design-space explorer for the E-method: the radix, digit set, delta and form of the residuals
+  of FixEMethodEvaluator, without generating any VHDL.
+
+*/
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+#include <sollya.h>
+
+#include "FixEMethodExplorer.hpp"
+#include "FixEMethodEvaluator.hpp"
+#include "GenericComputationUnit.hpp"
+#include "GenericSimpleSelectionFunction.hpp"
+#include "UserInterface.hpp"
+#include "utils.hpp"
+#include "profiler.h"
+
+using namespace std;
+
+namespace flopoco {
+
+	FixEMethodExplorer::FixEMethodExplorer(Target* target, int msbIn, int lsbIn,
+			vector<vector<string>> coeffsP, vector<vector<string>> coeffsQ,
+			int segmentBits, double inputScaleFactor) :
+		target_(target), msbIn_(msbIn), lsbIn_(lsbIn), segmentBits_(segmentBits), inputScaleFactor_(inputScaleFactor),
+		maxDegree_(0), maxP_(0), maxQ_(0)
+	{
+		srcFileName = "FixEMethodExplorer";
+		uniqueName_ = "FixEMethodExplorer";
+
+		if((coeffsP.size() == 0) || (coeffsP.size() != coeffsQ.size()))
+			THROWERROR("coeffsP and coeffsQ must contain the same number of coefficient sets");
+		if((segmentBits > 0) && (coeffsP.size() != ((size_t)1 << segmentBits)))
+			THROWERROR("in segmented mode, there must be 2^segmentBits=" << (1 << segmentBits) << " coefficient sets");
+		if(msbIn-lsbIn+1 <= segmentBits)
+			THROWERROR("the input has no bits left after the " << segmentBits << " segment bits");
+		nbLanes_ = (segmentBits > 0 ? 1 : coeffsP.size());
+
+		//the coefficients are parsed here, once: Sollya is not thread-safe
+		mpfr_t mpCoeff;
+		mpfr_init2(mpCoeff, LARGEPREC);
+		auto parseCoeff = [&](string coeff) {
+			sollya_obj_t node = sollya_lib_parse_string(coeff.c_str());
+			if(sollya_lib_obj_is_error(node))
+				THROWERROR("Unable to parse string " << coeff << " as a numeric constant");
+			sollya_lib_get_constant(mpCoeff, node);
+			sollya_lib_clear_obj(node);
+			return mpfr_get_d(mpCoeff, GMP_RNDN);
+		};
+		for(size_t lane=0; lane<coeffsP.size(); lane++)
+		{
+			maxDegree_ = std::max(maxDegree_, std::max(coeffsP[lane].size(), coeffsQ[lane].size()));
+			for(size_t i=0; i<coeffsP[lane].size(); i++)
+				maxP_ = std::max(maxP_, fabs(parseCoeff(coeffsP[lane][i])));
+			for(size_t i=0; i<coeffsQ[lane].size(); i++)
+			{
+				double q = parseCoeff(coeffsQ[lane][i]);
+
+				if((i == 0) && (q != 1.0))
+					THROWERROR("coefficient coeffsQ[0]=" << coeffsQ[lane][0] << " must be 1");
+				if(i > 0)
+					maxQ_ = std::max(maxQ_, fabs(q));
+			}
+		}
+		mpfr_clear(mpCoeff);
+	}
+
+
+	FixEMethodExplorer::DesignPoint FixEMethodExplorer::evaluate(int radix, int maxDigit, double delta, bool carrySave)
+	{
+		DesignPoint p;
+		ostringstream reason;
+
+		p.radix = radix;
+		p.maxDigit = maxDigit;
+		p.delta = delta;
+		p.carrySave = carrySave;
+		p.valid = false;
+		p.nbIter = p.wHatSize = p.widthDiMX = p.cycles = 0;
+		p.lut = p.iterationDelay = p.latency = p.throughputPerLUT = 0;
+
+		//the parameters accepted by the constructor of FixEMethodEvaluator
+		if((radix < 2) || ((radix & (radix-1)) != 0))
+		{
+			p.reason = "the radix is not a power of 2";
+			return p;
+		}
+		if((2*maxDigit < radix) || (maxDigit > radix-1))
+		{
+			p.reason = "the digit set is not redundant, or has digits larger than r-1";
+			return p;
+		}
+		if((delta < 0) || (delta >= 1))
+		{
+			p.reason = "delta is not in [0,1)";
+			return p;
+		}
+		if(carrySave && (delta == 0))
+		{
+			p.reason = "carry-save residuals require delta > 0";
+			return p;
+		}
+		if(carrySave && (segmentBits_ > 0))
+		{
+			p.reason = "carry-save residuals are not supported in segmented mode";
+			return p;
+		}
+
+		//the constraints, as checked by FixEMethodEvaluator
+		FixEMethodEvaluator::getAlgorithmParameters(radix, delta, &p.xi, &p.alpha);
+		p.inputScaleFactor = (inputScaleFactor_ == -1 ? p.alpha-maxQ_ : inputScaleFactor_);
+		int msbX = (segmentBits_ > 0 ? msbIn_-segmentBits_+1 : msbIn_);
+		double maxX = (intpow2(msbX) - intpow2(lsbIn_)) * p.inputScaleFactor;
+		if(maxP_ > p.xi)
+			reason << "max|p_i|=" << maxP_ << " > xi=" << p.xi;
+		else if(p.inputScaleFactor <= 0)
+			reason << "max|q_i|=" << maxQ_ << " >= alpha=" << p.alpha << ", no input scaling is possible";
+		else if(maxQ_ > p.alpha-p.inputScaleFactor)
+			reason << "max|q_i|=" << maxQ_ << " > alpha-inputScaleFactor=" << p.alpha-p.inputScaleFactor;
+		else if(maxX > p.alpha-maxQ_)
+			reason << "max|x|*inputScaleFactor=" << maxX << " > alpha-max|q_i|=" << p.alpha-maxQ_;
+		//the residuals must be rounded to digits of the digit set
+		//	|w[j]| <= r * (1/2 + a*|x| + a*|q_i|) <= a + 1/2
+		else if(radix*(0.5 + maxDigit*(maxX+maxQ_)) > maxDigit+0.5)
+			reason << "the residuals exceed the digit set, r*(1/2+a*(max|x|+max|q_i|))="
+				<< radix*(0.5 + maxDigit*(maxX+maxQ_)) << " > a+1/2";
+		p.reason = reason.str();
+		p.valid = (p.reason == "");
+
+		//the formats of the signals, as in the constructor of FixEMethodEvaluator
+		int msbWHat, lsbWHat;
+		int msbD = ceil(log2(radix));
+		int msbDiMX = msbX + (int)ceil(log2(maxDigit));
+		int wW, wD, width, wQ;
+
+		p.nbIter = msbIn_ - lsbIn_ + 1;
+		if(radix > 2)
+			p.nbIter = ceil(1.0*p.nbIter/log2(radix));
+		GenericSimpleSelectionFunction::getWHatFormat(radix, maxDigit, &msbWHat, &lsbWHat);
+		p.wHatSize = msbWHat-lsbWHat+1;
+		p.widthDiMX = msbDiMX-lsbIn_+1;
+		wW = msbWHat-lsbIn_+1;
+		wD = msbD+1;
+		width = maxInt(3, msbWHat, msbX, msbD) - lsbIn_ + 1;
+		//	in segmented mode, the q_i are selected by the segment: |q_i| < alpha <= 1/4
+		wQ = (segmentBits_ > 0 ? -lsbIn_ : 0);
+
+		//the LUTs
+		//	a row of computation units and selection functions, for each iteration of each lane
+		double cuRow = GenericComputationUnit::estimateLUTs(target_, maxDigit, -1, width, p.widthDiMX, wQ, wD, carrySave);
+		if(maxDegree_ > 2)
+			cuRow += (maxDegree_-2) * GenericComputationUnit::estimateLUTs(target_, maxDigit, 0, width, p.widthDiMX, wQ, wD, carrySave);
+		if(maxDegree_ > 1)
+			cuRow += GenericComputationUnit::estimateLUTs(target_, maxDigit, 1, width, p.widthDiMX, wQ, wD, carrySave);
+		double selRow = maxDegree_ * GenericSimpleSelectionFunction::estimateLUTs(target_, radix, maxDigit,
+				(carrySave ? "compressed" : "auto"), carrySave, delta);
+		p.lut = nbLanes_ * p.nbIter * (cuRow + selRow);
+		//	the multiples of X: an adder per odd multiple in the multiple constant multiplier, and a negation
+		double lutPerBitDiMX = p.widthDiMX * target_->getLUTPerAdderSubtracter(p.widthDiMX, p.widthDiMX);
+		p.lut += (FixEMethodEvaluator::countMultiplesAdders(maxDigit, "mcm") + maxDigit) * lutPerBitDiMX;
+		//	the sum of the digits of the result, for each lane
+		p.lut += nbLanes_ * wW * target_->getLUTPerAdderSubtracter(wW, wW);
+
+		//the latency
+		//	an iteration: the selection of D_{i+1}*X among the 2*maxDigit+1 multiples,
+		//	the bitheap and its final adder, then the selection table on W^Hat,
+		//	or in carry-save form, the rows of full adders, then the adder of the estimate of the selection
+		double cuDelay = GenericComputationUnit::estimateDelay(target_, maxDigit, 0, width, carrySave);
+		double selDelay = GenericSimpleSelectionFunction::estimateDelay(target_, radix, maxDigit, carrySave, delta);
+		p.iterationDelay = cuDelay + selDelay + target_->localWireDelay(2*maxDegree_);
+		double multDelay = 2*target_->adderDelay(p.widthDiMX) + target_->localWireDelay();
+		double sumDelay = target_->adderDelay(wW);
+		p.latency = multDelay + p.nbIter*p.iterationDelay + sumDelay;
+
+		//the throughput: one result per cycle when pipelined
+		if(target_->isPipelined())
+		{
+			double period = 1.0/target_->frequency();
+
+			p.cycles = ceil(multDelay/period) + p.nbIter*ceil(p.iterationDelay/period) + ceil(sumDelay/period);
+			p.throughputPerLUT = target_->frequency() / p.lut;
+		}
+		else
+			p.throughputPerLUT = 1.0 / (p.latency * p.lut);
+
+		return p;
+	}
+
+
+	vector<FixEMethodExplorer::DesignPoint> FixEMethodExplorer::explore(vector<int> radices, vector<double> deltas, int nbThreads,
+			bool withCarrySave)
+	{
+		ProfileScope profile("design-space exploration");
+		vector<DesignPoint> points;
+
+		//the combinations, from the minimally to the maximally redundant digit set of each radix
+		for(int radix : radices)
+			for(int maxDigit=(radix+1)/2; maxDigit<=radix-1; maxDigit++)
+				for(double delta : deltas)
+					for(int cs=0; cs<=(withCarrySave ? 1 : 0); cs++)
+					{
+						DesignPoint p;
+						p.radix = radix;
+						p.maxDigit = maxDigit;
+						p.delta = delta;
+						p.carrySave = (cs == 1);
+						points.push_back(p);
+					}
+		int nbPoints = points.size();
+		if(nbThreads > nbPoints)
+			nbThreads = nbPoints;
+		if(nbThreads < 1)
+			nbThreads = 1;
+
+		atomic<int> nextPoint(0);
+		auto worker = [&]() {
+			while(true)
+			{
+				int i = nextPoint++;
+				if(i >= nbPoints)
+					break;
+				points[i] = evaluate(points[i].radix, points[i].maxDigit, points[i].delta, points[i].carrySave);
+			}
+		};
+		REPORT(INFO, "Evaluating " << nbPoints << " combination(s), with " << nbThreads << " thread(s)");
+		vector<thread> workers;
+		for(int t=0; t<nbThreads; t++)
+			workers.push_back(thread(worker));
+		for(auto& w : workers)
+			w.join();
+
+		Profiler::instance().count("explored_points", nbPoints);
+		return points;
+	}
+
+
+	vector<FixEMethodExplorer::DesignPoint> FixEMethodExplorer::paretoFront(const vector<DesignPoint>& points)
+	{
+		vector<DesignPoint> sorted, front;
+
+		for(auto& p : points)
+			if(p.valid)
+				sorted.push_back(p);
+		//by increasing LUTs, then latency: a point is on the front if it is faster than all the smaller ones
+		std::sort(sorted.begin(), sorted.end(), [](const DesignPoint& a, const DesignPoint& b) {
+			return (a.lut < b.lut) || ((a.lut == b.lut) && (a.latency < b.latency));
+		});
+		for(auto& p : sorted)
+			if(front.empty() || (p.latency < front.back().latency))
+				front.push_back(p);
+
+		return front;
+	}
+
+
+	void FixEMethodExplorer::printTable(ostream& s, const vector<DesignPoint>& points)
+	{
+		s << " radix maxDigit  delta residual nbIter wHat wDiMX      LUTs  latency(ns) cycles  results/s/LUT" << endl;
+		for(auto& p : points)
+		{
+			s << setw(6) << p.radix << setw(9) << p.maxDigit << setw(7) << p.delta << setw(9) << (p.carrySave ? "cs" : "nr");
+			if(!p.valid)
+			{
+				s << "  not valid: " << p.reason << endl;
+				continue;
+			}
+			s << setw(7) << p.nbIter << setw(5) << p.wHatSize << setw(6) << p.widthDiMX
+				<< setw(10) << fixed << setprecision(0) << p.lut
+				<< setw(13) << setprecision(2) << p.latency*1e9
+				<< setw(7) << p.cycles
+				<< setw(15) << scientific << setprecision(3) << p.throughputPerLUT << endl;
+			s.unsetf(ios::floatfield);
+			s << setprecision(6);
+		}
+	}
+
+
+	OperatorPtr FixEMethodExplorer::parseArguments(Target *target, vector<string> &args) {
+		int msbIn, lsbIn, segmentBits;
+		double inputScaleFactor;
+		bool carrySave;
+		string in, in2, radicesStr, deltasStr, substr;
+		vector<int> radices;
+		vector<double> deltas;
+
+		UserInterface::parseInt(args, "msbIn", &msbIn);
+		UserInterface::parseInt(args, "lsbIn", &lsbIn);
+		UserInterface::parseString(args, "coeffsP", &in);
+		UserInterface::parseString(args, "coeffsQ", &in2);
+		UserInterface::parseString(args, "radices", &radicesStr);
+		UserInterface::parseString(args, "deltas", &deltasStr);
+		UserInterface::parsePositiveInt(args, "segmentBits", &segmentBits);
+		UserInterface::parseFloat(args, "inputScaleFactor", &inputScaleFactor);
+		UserInterface::parseBoolean(args, "carrySave", &carrySave);
+
+		stringstream ssRadices(radicesStr);
+		while(std::getline(ssRadices, substr, ':'))
+			radices.push_back(stoi(substr));
+		stringstream ssDeltas(deltasStr);
+		while(std::getline(ssDeltas, substr, ':'))
+			deltas.push_back(stod(substr));
+
+		FixEMethodExplorer explorer(target, msbIn, lsbIn,
+				FixEMethodEvaluator::parseCoefficientSets(in), FixEMethodEvaluator::parseCoefficientSets(in2),
+				segmentBits, inputScaleFactor);
+		vector<DesignPoint> points = explorer.explore(radices, deltas, UserInterface::getNumberOfThreads(), carrySave);
+		vector<DesignPoint> front = paretoFront(points);
+
+		if(UserInterface::verbose >= DETAILED)
+		{
+			cerr << "All the combinations:" << endl;
+			printTable(cerr, points);
+		}
+		if(front.empty())
+			throw string("FixEMethodExplorer: no combination of the parameters satisfies the constraints of the E-method");
+		cerr << "Pareto front in (LUTs, latency), on " << target->getID()
+				<< (target->isPipelined() ? join(" at ", target->frequencyMHz(), " MHz") : string(", combinatorial")) << ":" << endl;
+		printTable(cerr, front);
+
+		// this factory only reports, it adds no operator
+		return NULL;
+	}
+
+	void FixEMethodExplorer::registerFactory(){
+		UserInterface::add("FixEMethodExplorer", // name
+				"Explores the radix, digit set and delta of FixEMethodEvaluator for a given input format and coefficients, without generating VHDL, and reports the Pareto front in (LUTs, latency).",
+				"FunctionApproximation", // category
+				"",
+				"msbIn(int): MSB of the input;\
+				 lsbIn(int): LSB of the input;\
+				 coeffsP(string): colon-separated list of real coefficients of polynomial P, as for FixEMethodEvaluator;\
+				 coeffsQ(string): colon-separated list of real coefficients of polynomial Q, as for FixEMethodEvaluator;\
+				 radices(string)=2:4:8: colon-separated list of the radices to explore;\
+				 deltas(string)=0.125:0.25:0.5: colon-separated list of the values of delta to explore;\
+				 segmentBits(int)=0: when positive, the '|'-separated coefficient sets are the 2^segmentBits segments of the input;\
+				 inputScaleFactor(real)=-1: the factor by which the input is scaled, -1 for the largest admissible one;\
+				 carrySave(bool)=true: also evaluate each combination with the residuals in carry-save form (cs) instead of non-redundant (nr)",
+				"For each radix, the digit sets go from the minimally (maxDigit=radix/2) to the maximally (maxDigit=radix-1) redundant one. \
+				 The costs are those of the unrolled architecture, from the cost functions of the target. \
+				 Carry-save residuals trade a few LUTs per unit for an iteration delay independent of the width of the residuals. \
+				 The combinations are evaluated on the threads given by the threads option. \
+				 With verbose=2, the table of all the combinations is printed, with the constraint that rejects the invalid ones.",
+				FixEMethodExplorer::parseArguments
+		) ;
+
+	}
+
+}
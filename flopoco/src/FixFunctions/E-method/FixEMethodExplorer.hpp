@@ -0,0 +1,110 @@
+/*
+
+  A design-space explorer for the E-method: the radix, digit set, delta and form of the residuals
+  of FixEMethodEvaluator, without generating any VHDL.
+
+*/
+
+#ifndef FIXEMETHODEXPLORER_HPP_
+#define FIXEMETHODEXPLORER_HPP_
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "Operator.hpp"
+
+namespace flopoco {
+
+	/**
+	 * Enumerates the (radix, maxDigit, delta) combinations of a FixEMethodEvaluator for a given
+	 * input format and set of coefficients, with the residuals in non-redundant and possibly in carry-save form,
+	 * and for each of them:
+	 * 		checks the constraints of the E-method, as the constructor of FixEMethodEvaluator
+	 * 			|p_i| <= xi, |q_i| <= alpha - inputScaleFactor, |x|*inputScaleFactor <= alpha - max|q_i|
+	 * 		and, for the non-maximal digit sets, that the residuals stay in the range of the digit set:
+	 * 			r/2 + r*a*(|x|*inputScaleFactor + max|q_i|) <= a + 1/2
+	 * 		(implied by the definition of alpha when a=r-1)
+	 * 		estimates the LUTs and the latency of the unrolled architecture from the cost functions
+	 * 		of the target, as Operator::estimateResources() would on the generated operator.
+	 * The combinations are evaluated in parallel, and the ones that are not dominated
+	 * in (LUTs, latency) form the Pareto front.
+	 */
+	class FixEMethodExplorer
+	{
+	public:
+		/** One combination of the parameters, and its estimated cost */
+		struct DesignPoint {
+			int radix;
+			int maxDigit;
+			double delta;
+			bool carrySave;                   /**< true if the residuals are in carry-save form */
+			bool valid;                       /**< true if the E-method converges for these parameters */
+			string reason;                    /**< the first constraint that is not satisfied */
+			double xi;
+			double alpha;
+			double inputScaleFactor;
+			int nbIter;
+			int wHatSize;                     /**< the number of input bits of the selection tables */
+			int widthDiMX;                    /**< the width of the multiples of X */
+			double lut;
+			double iterationDelay;            /**< the critical path of one iteration, in seconds */
+			double latency;                   /**< the latency of the unrolled architecture, in seconds */
+			int cycles;                       /**< the latency in cycles, pipelined at the target frequency */
+			double throughputPerLUT;          /**< results per second and per LUT */
+		};
+
+		/**
+		 * Parses the coefficients, and keeps what the constraints and the cost model need
+		 * @param   msbIn             MSB of the input
+		 * @param   lsbIn             LSB of the input
+		 * @param   coeffsP           the coefficients of P of each lane or segment, lowest degree first
+		 * @param   coeffsQ           the coefficients of Q of each lane or segment, lowest degree first
+		 * @param   segmentBits       when positive, the coefficient sets are segments instead of lanes
+		 * @param   inputScaleFactor  the factor by which the input is scaled, -1 for the largest admissible one
+		 */
+		FixEMethodExplorer(Target* target, int msbIn, int lsbIn,
+				vector<vector<string>> coeffsP, vector<vector<string>> coeffsQ,
+				int segmentBits = 0, double inputScaleFactor = -1);
+
+		/**
+		 * Evaluates all the combinations of the given radices and deltas with the digit sets
+		 * from the minimally (maxDigit = r/2) to the maximally (maxDigit = r-1) redundant one
+		 * @param   nbThreads      the number of threads evaluating the combinations
+		 * @param   withCarrySave  when true, each combination is also evaluated with carry-save residuals
+		 * @return  all the combinations, valid or not
+		 */
+		vector<DesignPoint> explore(vector<int> radices, vector<double> deltas, int nbThreads, bool withCarrySave = false);
+
+		/** Checks the constraints, and estimates the cost of one combination */
+		DesignPoint evaluate(int radix, int maxDigit, double delta, bool carrySave = false);
+
+		/** @return the valid points not dominated by another one in (LUTs, latency), by increasing LUTs */
+		static vector<DesignPoint> paretoFront(const vector<DesignPoint>& points);
+
+		/** Prints a table of the points */
+		static void printTable(ostream& s, const vector<DesignPoint>& points);
+
+		/** Factory method that parses arguments, runs the exploration and reports the Pareto front */
+		static OperatorPtr parseArguments(Target *target, vector<string> &args);
+
+		/** Factory register method */
+		static void registerFactory();
+
+	private:
+		Target* target_;
+		int msbIn_;
+		int lsbIn_;
+		int segmentBits_;
+		double inputScaleFactor_;
+		size_t nbLanes_;                  /**< the number of lanes, 1 in segmented mode */
+		size_t maxDegree_;                /**< the number of computation units per iteration */
+		double maxP_;                     /**< max|p_i| over all the lanes or segments */
+		double maxQ_;                     /**< max|q_i|, i>0, over all the lanes or segments */
+		string srcFileName;               /**< useful only to enable same kind of reporting as for FloPoCo operators. */
+		string uniqueName_;               /**< useful only to enable same kind of reporting as for FloPoCo operators. */
+	};
+
+}
+
+#endif /* FIXEMETHODEXPLORER_HPP_ */
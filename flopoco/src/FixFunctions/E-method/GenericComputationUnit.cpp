@@ -11,21 +11,53 @@ namespace flopoco {
 
 	GenericComputationUnit::GenericComputationUnit(Target* target, int _radix, int _maxDigit,
 			int _index, int _specialCase,
-			Signal *_W, Signal *_X, Signal *_Di, string _qi, map<string, double> inputDelays)
+			Signal *_W, Signal *_X, Signal *_Di, string _qi, int _lsbTrunc, bool _carrySave,
+			map<string, double> inputDelays)
+	: GenericComputationUnit(target, _radix, _maxDigit, _index, _specialCase,
+			_W, _X, _Di, _qi, nullptr, _lsbTrunc, _carrySave, inputDelays)
+	{
+	}
+
+
+	GenericComputationUnit::GenericComputationUnit(Target* target, int _radix, int _maxDigit,
+			int _index, int _specialCase,
+			Signal *_W, Signal *_X, Signal *_Di, Signal *_Qi, int _lsbTrunc, bool _carrySave,
+			map<string, double> inputDelays)
+	: GenericComputationUnit(target, _radix, _maxDigit, _index, _specialCase,
+			_W, _X, _Di, "0", _Qi, _lsbTrunc, _carrySave, inputDelays)
+	{
+	}
+
+
+	GenericComputationUnit::GenericComputationUnit(Target* target, int _radix, int _maxDigit,
+			int _index, int _specialCase,
+			Signal *_W, Signal *_X, Signal *_Di, string _qi, Signal *_Qi, int _lsbTrunc,
+			bool _carrySave, map<string, double> inputDelays)
 	: Operator(target), radix(_radix), maxDigit(_maxDigit),
 	  index(_index), specialCase(_specialCase),
 	  msbW(_W->MSB()), lsbW(_W->LSB()),
 	  msbX(_X->MSB()), lsbX(_X->LSB()),
 	  msbD(_Di->MSB()), lsbD(_Di->LSB()),
-	  qi(_qi)
+	  lsbTrunc(_lsbTrunc),
+	  qi(_qi),
+	  variableQi(_Qi != nullptr),
+	  msbQ(_Qi != nullptr ? _Qi->MSB() : 0), lsbQ(_Qi != nullptr ? _Qi->LSB() : 0),
+	  carrySave(_carrySave), bitheap(nullptr)
 	{
 		ostringstream name;
 
 		srcFileName = "GenericComputationUnit";
 		name << "GenericComputationUnit_radix" << radix
-				<< "_index_" << index
-				<< "_qi_" << std::setprecision(5) << vhdlize(qi, 10)
-				<< "_msbIn_" << vhdlize(msbW) << "_lsbIn_" << vhdlize(lsbW);
+				<< "_index_" << index;
+		if(variableQi)
+			name << "_qi_var_msbQ_" << vhdlize(msbQ) << "_lsbQ_" << vhdlize(lsbQ);
+		else
+			name << "_qi_" << std::setprecision(5) << vhdlize(qi, 10);
+		name << "_msbIn_" << vhdlize(msbW) << "_lsbIn_" << vhdlize(lsbW);
+		if(lsbTrunc != CU_NO_TRUNCATION)
+			name << "_trunc_" << vhdlize(lsbTrunc);
+		if(carrySave)
+			name << "_cs";
 		setName(name.str()+"_uid"+vhdlize(getNewUId()));
 
 		//safety checks
@@ -50,6 +82,25 @@ namespace flopoco {
 
 		REPORT(DEBUG, "using internal format: msbInt=" << msbInt << ", lsbInt=" << lsbInt);
 
+		//the terms of the sum are computed down to lsbTrunc, which can only be above lsbInt
+		if(lsbTrunc < lsbInt)
+			lsbTrunc = lsbInt;
+		if(lsbTrunc > lsbD)
+			THROWERROR("GenericComputationUnit: the truncation LSB must not be larger than the LSB of the digits");
+		if((MULTMODE_CU == 1) && (lsbTrunc > lsbInt))
+			THROWERROR("GenericComputationUnit: truncated computations are not supported when using a multiplier");
+		if(lsbTrunc > lsbInt)
+			REPORT(DEBUG, "computations truncated to lsbTrunc=" << lsbTrunc);
+
+		//the product d_0*q_i must fit in the internal format
+		if(variableQi && ((lsbQ+lsbD < lsbInt) || (msbQ+msbD+1 > msbInt)))
+			THROWERROR("GenericComputationUnit: the format of Qi does not fit in the internal format");
+		//in carry-save form, -d_0*q_i is one of a few constants, added with the other terms
+		if(carrySave && variableQi)
+			THROWERROR("GenericComputationUnit: carry-save residuals are not supported for a variable q_i");
+		if(carrySave && (MULTMODE_CU == 1))
+			THROWERROR("GenericComputationUnit: carry-save residuals are not supported when using a multiplier");
+
 		//determine the MSB and the LSB for the DiMultX signals
 		msbDiMX = msbX+(int)ceil(log2(maxDigit));
 		lsbDiMX = lsbX;
@@ -64,12 +115,19 @@ namespace flopoco {
 		//create the inputs and the output
 		//	the inputs
 		addFixInput("Wi", true, msbW, lsbW);
+		if(carrySave)
+			addFixInput("WiC", true, msbW, lsbW);
 		addFixInput("D0", true, msbD, lsbD);
 		addFixInput("Di", true, msbD, lsbD);
 		if(specialCase != 1)
 		{
 			addFixInput("Dip1", true, msbD, lsbD);
 		}
+		//	the input for q_i, if it is not a constant
+		if(variableQi && (specialCase != -1))
+		{
+			addFixInput("Qi", true, msbQ, lsbQ);
+		}
 		addFixInput("X", true, msbX, lsbX);
 		//	the inputs for D_{i+1}[j-1]*X
 		//		if required
@@ -83,15 +141,41 @@ namespace flopoco {
 		}
 		// the outputs
 		addFixOutput("Wi_next", true, msbInt, lsbInt, 2);
+		if(carrySave)
+			addFixOutput("WiC_next", true, msbInt, lsbInt, 2);
 
 		int currentCycle = getCurrentCycle();
 		double currentCriticalPath = getCriticalPath();
 
+		//parse the constant using Sollya, for further reference
+		//	when q_i is variable, mpQi is only set in emulate
+		mpfr_init2(mpQi, LARGEPREC);
+		if(!variableQi)
+		{
+			//	parse q_i using Sollya
+			sollya_obj_t node;
+			node = sollya_lib_parse_string(qi.c_str());
+			/* If  parse error throw an exception */
+			if (sollya_lib_obj_is_error(node))
+			{
+				THROWERROR("emulate: Unable to parse string "<< qi << " as a numeric constant");
+			}
+			sollya_lib_get_constant(mpQi, node);
+			free(node);
+		}
+
+		//the terms are summed without a bitheap in carry-save form
+		if(carrySave)
+		{
+			generateCarrySaveSum();
+			return;
+		}
+
 		//create the bitheap
 		REPORT(DEBUG, "creating the bitheap");
 		bitheap = new BitHeap(
 								this,											// parent operator
-								msbInt-lsbInt+1,								// maximum weight
+								msbInt-lsbTrunc+1,								// maximum weight
 								false, 											// enable supertiles
 //								join("Bitheap_"+name.str()+"_", getNewUId())	// bitheap name
 								""
@@ -99,33 +183,58 @@ namespace flopoco {
 
 		//add W_i[j-1] to the bitheap
 		REPORT(DEBUG, "add W_i[j-1] to the bitheap");
-		bitheap->addSignedBitVector(
-									lsbW-lsbInt,					//weight
-									"Wi",							//input signal name
-									msbW-lsbW+1						//size
-									);
+		if(lsbTrunc > lsbW)
+		{
+			//	only the bits above lsbTrunc
+			vhdl << tab << declareFixPoint("Wi_trunc", true, msbW, lsbTrunc) << " <= Wi"
+					<< range(msbW-lsbW, lsbTrunc-lsbW) << ";" << endl;
+			bitheap->addSignedBitVector(
+										0,								//weight
+										"Wi_trunc",						//input signal name
+										msbW-lsbTrunc+1					//size
+										);
+		}
+		else
+		{
+			bitheap->addSignedBitVector(
+										lsbW-lsbTrunc,					//weight
+										"Wi",							//input signal name
+										msbW-lsbW+1						//size
+										);
+		}
 
 		//--------- pipelining
 		setCycle(currentCycle, true);
 		setCriticalPath(currentCriticalPath);
 		//--------- pipelining
 
-		//parse the constant using Sollya, for further reference
-		//	parse q_i using Sollya
-		sollya_obj_t node;
-		node = sollya_lib_parse_string(qi.c_str());
-		mpfr_init2(mpQi, LARGEPREC);
-		/* If  parse error throw an exception */
-		if (sollya_lib_obj_is_error(node))
-		{
-			THROWERROR("emulate: Unable to parse string "<< qi << " as a numeric constant");
-		}
-		sollya_lib_get_constant(mpQi, node);
-		free(node);
-
 		//create the multiplication D_0[j-1] * (-1)*q_i
 		//	if required
-		if(specialCase != -1)
+		if((specialCase != -1) && variableQi)
+		{
+			//create the multiplication D_0[j-1] * (-1)*Q_i
+			REPORT(DEBUG, "create the multiplication D_0[j-1] * (-1)*Q_i, using a generic multiplier");
+
+			//	only the bits of Qi above lsbTrunc are used
+			int lsbQTrunc = (lsbQ < lsbTrunc ? lsbTrunc : lsbQ);
+
+			//helper signals
+			vhdl << tab << declare("D0_std_lv", msbD-lsbD+1) << " <= std_logic_vector(D0);" << endl;
+			vhdl << tab << declare("Qi_std_lv", msbQ-lsbQTrunc+1) << " <= std_logic_vector(Qi"
+					<< range(msbQ-lsbQ, lsbQTrunc-lsbQ) << ");" << endl;
+
+			//create the multiplier, which subtracts its result from the bitheap
+			IntMultiplier *multD0Qi = new IntMultiplier(
+														this,							//parent operator
+														bitheap,						//bitheap
+														getSignalByName("Qi_std_lv"),	//signal x
+														getSignalByName("D0_std_lv"),	//signal y
+														lsbQTrunc+lsbD-lsbTrunc,		//lsb weight in bitheap
+														true, 							//negate
+														true							//signed
+														);
+		}
+		else if(specialCase != -1)
 		{
 			//create the multiplication D_0[j-1] * (-1)*q_i
 			REPORT(DEBUG, "create the multiplication D_0[j-1] * (-1)*q_i");
@@ -139,7 +248,7 @@ namespace flopoco {
 													true,						//signedness
 													msbD,						//msbIn
 													lsbD,						//lsbIn
-													lsbInt,						//lsbOut
+													lsbTrunc,					//lsbOut
 													join("(-1)*", qi),			//constant
 													false,						//add round bit
 													1.0							//target ulp error
@@ -162,7 +271,7 @@ namespace flopoco {
 		//subtract D_i[j-1]
 		REPORT(DEBUG, "subtract D_i[j-1]");
 		bitheap->subtractSignedBitVector(
-										lsbD-lsbInt,				//weight
+										lsbD-lsbTrunc,				//weight
 										"Di",						//input signal name
 										msbD-lsbD+1					//size
 										);
@@ -184,31 +293,28 @@ namespace flopoco {
 				//	instead, all the possible products are generated upstream
 				//	and here we only have to choose which one to add
 				REPORT(DEBUG, "create the multiplication D_{i+1}[j-1] * X");
-
-				//--------- pipelining
-				manageCriticalPath(target->lutDelay()+target->localWireDelay(), true);
-				//--------- pipelining
-
-				vhdl << tab << declareFixPoint("Dip1_Mult_X", true, msbDiMX, lsbDiMX) << " <= " << endl;
-				for(int i=(-maxDigit); i<=maxDigit; i++)
-				{
-					mpz_class digitValue = i;
-
-					//handle negative digits
-					if(digitValue < 0)
-						digitValue = mpz_class(1<<intlog2(radix)) + digitValue;
-
-					vhdl << tab << tab << join("X_Mult_", vhdlize(i)) << " when Dip1="
-							<< "\"" << unsignedBinary(digitValue, intlog2(radix)) << "\" else" << endl;
-				}
-				vhdl << tab << tab << "(others => '-');" << endl;
+				generateDigitTimesX();
 				//	add the result of the selection to the bitheap
 				REPORT(DEBUG, "add the result of the selection to the bitheap");
-				bitheap->addSignedBitVector(
-											lsbDiMX-lsbInt,					//weight
-											"Dip1_Mult_X",					//input signal name
-											msbDiMX-lsbDiMX+1				//size
-											);
+				if(lsbTrunc > lsbDiMX)
+				{
+					//	only the bits above lsbTrunc
+					vhdl << tab << declareFixPoint("Dip1_Mult_X_trunc", true, msbDiMX, lsbTrunc) << " <= Dip1_Mult_X"
+							<< range(msbDiMX-lsbDiMX, lsbTrunc-lsbDiMX) << ";" << endl;
+					bitheap->addSignedBitVector(
+												0,								//weight
+												"Dip1_Mult_X_trunc",			//input signal name
+												msbDiMX-lsbTrunc+1				//size
+												);
+				}
+				else
+				{
+					bitheap->addSignedBitVector(
+												lsbDiMX-lsbTrunc,				//weight
+												"Dip1_Mult_X",					//input signal name
+												msbDiMX-lsbDiMX+1				//size
+												);
+				}
 			}
 			else
 			{
@@ -224,7 +330,7 @@ namespace flopoco {
 															bitheap,						//bitheap
 															getSignalByName("X_std_lv"),	//signal x
 															getSignalByName("Dip1_std_lv"),	//signal y
-															lsbDiMX-lsbInt,					//lsb weight in bitheap
+															lsbDiMX-lsbTrunc,				//lsb weight in bitheap
 															false, 							//negate
 															true							//signed
 															);
@@ -253,15 +359,205 @@ namespace flopoco {
 
 		// Retrieve the bits we want from the bit heap
 		REPORT(DEBUG, "Retrieve the bits we want from the bit heap");
-		vhdl << tab << declareFixPoint("sum", true, msbInt, lsbInt) << " <= signed(" <<
-				bitheap->getSumName() << range(msbInt-lsbInt, 0) << ");" << endl;
+		vhdl << tab << declareFixPoint("sum", true, msbInt, lsbTrunc) << " <= signed(" <<
+				bitheap->getSumName() << range(msbInt-lsbTrunc, 0) << ");" << endl;
 
 		REPORT(DEBUG, "write to the output");
 		// multiply by radix, a constant shift by radix positions to the left
-		vhdl << tab << "Wi_next <= sum" << range(msbInt-lsbInt-ceil(log2(radix)), 0)
-				<< " & " << zg(ceil(log2(radix))) << ";" << endl;
+		//	the bits below lsbTrunc are zero
+		vhdl << tab << "Wi_next <= sum" << range(msbInt-lsbTrunc-ceil(log2(radix)), 0)
+				<< " & " << zg(ceil(log2(radix))+lsbTrunc-lsbInt) << ";" << endl;
+
+		outDelayMap["Wi_next"] = getCriticalPath();
+	}
+
+
+	void GenericComputationUnit::generateDigitTimesX()
+	{
+		//--------- pipelining
+		manageCriticalPath(getTarget()->lutDelay()+getTarget()->localWireDelay(), true);
+		//--------- pipelining
+
+		vhdl << tab << declareFixPoint("Dip1_Mult_X", true, msbDiMX, lsbDiMX) << " <= " << endl;
+		for(int i=(-maxDigit); i<=maxDigit; i++)
+		{
+			mpz_class digitValue = i;
+
+			//handle negative digits
+			if(digitValue < 0)
+				digitValue = mpz_class(1<<intlog2(radix)) + digitValue;
+
+			vhdl << tab << tab << join("X_Mult_", vhdlize(i)) << " when Dip1="
+					<< "\"" << unsignedBinary(digitValue, intlog2(radix)) << "\" else" << endl;
+		}
+		vhdl << tab << tab << "(others => '-');" << endl;
+	}
+
+
+	mpz_class GenericComputationUnit::carrySaveConstant(int d)
+	{
+		mpz_class value = mpz_class(1) << (lsbD-lsbTrunc);
+
+		if(specialCase != -1)
+		{
+			mpz_class product;
+			mpfr_t mpTmp;
+
+			mpfr_init2(mpTmp, LARGEPREC);
+			mpfr_mul_si(mpTmp, mpQi, -d, GMP_RNDN);
+			mpfr_mul_2si(mpTmp, mpTmp, lsbD-lsbTrunc, GMP_RNDN);
+			//	rounding takes place here
+			mpfr_get_z(product.get_mpz_t(), mpTmp, GMP_RNDN);
+			mpfr_clear(mpTmp);
+			value += product;
+		}
+
+		//as an unsigned number on the internal format
+		if(value < 0)
+			value += (mpz_class(1) << (msbInt-lsbTrunc+1));
+		return value;
+	}
+
+
+	void GenericComputationUnit::generateCarrySaveSum()
+	{
+		Target *target = getTarget();
+		int width = msbInt-lsbTrunc+1;
+		int shiftD = lsbD-lsbTrunc;
+		int log2Radix = ceil(log2(radix));
+		int currentCycle = getCurrentCycle();
+		double currentCriticalPath = getCriticalPath();
+		vector<string> terms;
+		map<string, int> termLevel;
+		int level, nbLevels, k;
+
+		REPORT(DEBUG, "sum the terms in carry-save form, on " << width << " bits");
+
+		//a term of the sum: a signed signal, sign-extended and aligned on lsbTrunc
+		auto addTerm = [&](string name, string signal, int msb, int lsb)
+		{
+			int lsbUsed = (lsb < lsbTrunc ? lsbTrunc : lsb);
+
+			vhdl << tab << declare(name, width) << " <= std_logic_vector(resize(" << signal << range(msb-lsb, lsbUsed-lsb)
+					<< ", " << width-(lsbUsed-lsbTrunc) << "))";
+			if(lsbUsed > lsbTrunc)
+				vhdl << " & " << zg(lsbUsed-lsbTrunc);
+			vhdl << ";" << endl;
+			terms.push_back(name);
+			termLevel[name] = 0;
+		};
+
+		//the terms, in the order used by reduceCarrySave()
+		//	the ones available at the inputs first, so that the first row does not wait for the multiplexers
+		//	W_i[j-1], both the sum and the carry bits
+		addTerm("Wi_cs", "Wi", msbW, lsbW);
+		addTerm("WiC_cs", "WiC", msbW, lsbW);
+		//	-D_i[j-1]-1
+		REPORT(DEBUG, "subtract D_i[j-1]");
+		vhdl << tab << declare("Di_cs", width) << " <= not(std_logic_vector(resize(Di, " << width-shiftD << ")))";
+		if(shiftD > 0)
+			vhdl << " & " << zg(shiftD);
+		vhdl << ";" << endl;
+		terms.push_back("Di_cs");
+		termLevel["Di_cs"] = 0;
+		//	D_{i+1}[j-1]*X, if required
+		if(specialCase != 1)
+		{
+			REPORT(DEBUG, "create the multiplication D_{i+1}[j-1] * X");
+			generateDigitTimesX();
+			addTerm("Dip1_Mult_X_cs", "Dip1_Mult_X", msbDiMX, lsbDiMX);
+			termLevel["Dip1_Mult_X_cs"] = 1;
+
+			//--------- pipelining
+			setCycle(currentCycle, true);
+			setCriticalPath(currentCriticalPath);
+			//--------- pipelining
+		}
+		//	-D_0[j-1]*q_i, chosen among the constants for each digit, plus the 1 completing the negation of D_i[j-1]
+		REPORT(DEBUG, "create the multiplication D_0[j-1] * (-1)*q_i, as a choice between constants");
+		vhdl << tab << declare("D0Qi_cs", width) << " <= ";
+		if(specialCase != -1)
+		{
+			vhdl << endl;
+			for(int d=(-maxDigit); d<=maxDigit; d++)
+			{
+				mpz_class digitValue = d;
+
+				//handle negative digits
+				if(digitValue < 0)
+					digitValue = mpz_class(1<<intlog2(radix)) + digitValue;
+
+				vhdl << tab << tab << "\"" << unsignedBinary(carrySaveConstant(d), width) << "\" when D0="
+						<< "\"" << unsignedBinary(digitValue, intlog2(radix)) << "\" else" << endl;
+			}
+			vhdl << tab << tab << "(others => '-');" << endl;
+			termLevel["D0Qi_cs"] = 1;
+		}
+		else
+		{
+			vhdl << "\"" << unsignedBinary(carrySaveConstant(0), width) << "\";" << endl;
+			termLevel["D0Qi_cs"] = 0;
+		}
+		terms.push_back("D0Qi_cs");
+
+		//reduce the terms by rows of full adders, three terms into two
+		//	each row adds a LUT to the critical path, whatever the width
+		k = 0;
+		nbLevels = 0;
+		while(terms.size() > 2)
+		{
+			string a = terms[0], b = terms[1], c = terms[2];
+			string sum = join("sum_cs_", k), carry = join("carry_cs_", k);
+
+			level = 1 + max(termLevel[a], max(termLevel[b], termLevel[c]));
+			//--------- pipelining
+			while(nbLevels < level)
+			{
+				manageCriticalPath(target->lutDelay()+target->localWireDelay(), true);
+				nbLevels++;
+			}
+			//--------- pipelining
+
+			vhdl << tab << declare(sum, width) << " <= " << a << " xor " << b << " xor " << c << ";" << endl;
+			vhdl << tab << declare(join("majority_cs_", k), width) << " <= (" << a << " and " << b << ") or ("
+					<< a << " and " << c << ") or (" << b << " and " << c << ");" << endl;
+			vhdl << tab << declare(carry, width) << " <= majority_cs_" << k << range(width-2, 0) << " & '0';" << endl;
+
+			terms.erase(terms.begin(), terms.begin()+3);
+			terms.push_back(sum);
+			terms.push_back(carry);
+			termLevel[sum] = termLevel[carry] = level;
+			k++;
+		}
+		REPORT(DEBUG, k << " rows of full adders, " << nbLevels << " levels of LUTs");
+
+		REPORT(DEBUG, "write to the outputs");
+		// multiply by radix, a constant shift by radix positions to the left
+		//	the bits below lsbTrunc are zero
+		vhdl << tab << "Wi_next <= signed(" << terms[0] << range(width-1-log2Radix, 0) << ")"
+				<< " & " << zg(log2Radix+lsbTrunc-lsbInt) << ";" << endl;
+		vhdl << tab << "WiC_next <= signed(" << terms[1] << range(width-1-log2Radix, 0) << ")"
+				<< " & " << zg(log2Radix+lsbTrunc-lsbInt) << ";" << endl;
 
 		outDelayMap["Wi_next"] = getCriticalPath();
+		outDelayMap["WiC_next"] = getCriticalPath();
+	}
+
+
+	void GenericComputationUnit::reduceCarrySave(vector<mpz_class> terms, int width, mpz_class *sum, mpz_class *carry)
+	{
+		mpz_class mask = (mpz_class(1) << width) - 1;
+
+		while(terms.size() > 2)
+		{
+			mpz_class a = terms[0], b = terms[1], c = terms[2];
+
+			terms.erase(terms.begin(), terms.begin()+3);
+			terms.push_back(a ^ b ^ c);
+			terms.push_back((((a & b) | (a & c) | (b & c)) << 1) & mask);
+		}
+		*sum = terms[0];
+		*carry = terms[1];
 	}
 
 
@@ -278,7 +574,13 @@ namespace flopoco {
 		mpz_class svDi   = tc->getInputValue("Di");
 		mpz_class svDip1 = tc->getInputValue("Dip1");
 		mpz_class svX    = tc->getInputValue("X");
+		mpz_class svQi;
 		mpz_class svXMultDip1[2*maxDigit+1];
+		// this input only exists for a variable q_i
+		if(variableQi && (specialCase != -1))
+		{
+			svQi = tc->getInputValue("Qi");
+		}
 		// these inputs do not exist for iteration n
 		if(specialCase != 1)
 		{
@@ -297,6 +599,8 @@ namespace flopoco {
 		mpz_class big1Xp     = (mpz_class(1) << (msbX-lsbX));
 		mpz_class big1Xmult  = (mpz_class(1) << (msbDiMX-lsbDiMX+1));
 		mpz_class big1Xmultp = (mpz_class(1) << (msbDiMX-lsbDiMX));
+		mpz_class big1Q      = (mpz_class(1) << (msbQ-lsbQ+1));
+		mpz_class big1Qp     = (mpz_class(1) << (msbQ-lsbQ));
 		mpz_class big1out    = (mpz_class(1) << (msbInt-lsbInt+1));
 		mpz_class big1outp   = (mpz_class(1) << (msbInt-lsbInt));
 
@@ -311,6 +615,14 @@ namespace flopoco {
 			svDip1 -= big1D;
 		if(svX >= big1Xp)
 			svX -= big1X;
+		if(variableQi && (specialCase != -1))
+		{
+			if(svQi >= big1Qp)
+				svQi -= big1Q;
+			//	the value of q_i, scaled appropriately, by the amount given by lsbQ
+			mpfr_set_z(mpQi, svQi.get_mpz_t(), GMP_RNDN);
+			mpfr_mul_2si(mpQi, mpQi, lsbQ, GMP_RNDN);
+		}
 		// these inputs do not exist for iteration n
 		if(specialCase != 1)
 		{
@@ -321,6 +633,38 @@ namespace flopoco {
 			}
 		}
 
+		//truncate the inputs, as done by the hardware
+		//	the product D_0[j-1]*q_i is truncated below, for a constant q_i
+		if(lsbTrunc > lsbW)
+			svWi = (svWi >> (lsbTrunc-lsbW)) << (lsbTrunc-lsbW);
+		if(variableQi && (specialCase != -1) && (lsbTrunc > lsbQ))
+		{
+			svQi = (svQi >> (lsbTrunc-lsbQ)) << (lsbTrunc-lsbQ);
+			mpfr_set_z(mpQi, svQi.get_mpz_t(), GMP_RNDN);
+			mpfr_mul_2si(mpQi, mpQi, lsbQ, GMP_RNDN);
+		}
+		if((specialCase != 1) && (lsbTrunc > lsbDiMX))
+		{
+			for(int i=(-maxDigit); i<=maxDigit; i++)
+				svXMultDip1[i+maxDigit] = (svXMultDip1[i+maxDigit] >> (lsbTrunc-lsbDiMX)) << (lsbTrunc-lsbDiMX);
+		}
+
+		//the multiplexers of the unit are undefined for the digits out of the digit set
+		if(((specialCase != 1) && (MULTMODE_CU == 0) && (abs(svDip1) > maxDigit)) || (carrySave && (abs(svD0) > maxDigit)))
+			return;
+
+		//in carry-save form, the outputs are the sum and the carry bits of the rows of full adders,
+		//	so they are the ones computed bit by bit by the model of the hardware
+		if(carrySave)
+		{
+			map<string, mpz_class> outputs;
+
+			simulateBitAccurate(tc, outputs);
+			for(auto& output : outputs)
+				tc->addExpectedOutput(output.first, output.second);
+			return;
+		}
+
 		// compute the multiple-precision output
 		mpz_class svW_next, svW_nextRd, svW_nextRu;
 		mpfr_t mpW_next, mpSum, mpX, mpDip1, mpTmp;
@@ -387,15 +731,33 @@ namespace flopoco {
 			}
 		}
 
-		//multiply by radix
-		mpfr_mul_si(mpSum, mpSum, radix, GMP_RNDN);
+		if(lsbTrunc > lsbInt)
+		{
+			//the sum is computed on lsbTrunc, then multiplied by radix
+			mpfr_mul_2si(mpSum, mpSum, -lsbTrunc, GMP_RNDN);
+
+			//round the result
+			mpfr_get_z(svW_nextRd.get_mpz_t(), mpSum, GMP_RNDD);
+			mpfr_get_z(svW_nextRu.get_mpz_t(), mpSum, GMP_RNDU);
+
+			//multiply by radix, and scale the result back to lsbInt
+			svW_nextRd = svW_nextRd * radix;
+			svW_nextRd <<= (lsbTrunc-lsbInt);
+			svW_nextRu = svW_nextRu * radix;
+			svW_nextRu <<= (lsbTrunc-lsbInt);
+		}
+		else
+		{
+			//multiply by radix
+			mpfr_mul_si(mpSum, mpSum, radix, GMP_RNDN);
 
-		//scale the result back to an integer
-		mpfr_mul_2si(mpSum, mpSum, -lsbInt, GMP_RNDN);
+			//scale the result back to an integer
+			mpfr_mul_2si(mpSum, mpSum, -lsbInt, GMP_RNDN);
 
-		//round the result
-		mpfr_get_z(svW_nextRd.get_mpz_t(), mpSum, GMP_RNDD);
-		mpfr_get_z(svW_nextRu.get_mpz_t(), mpSum, GMP_RNDU);
+			//round the result
+			mpfr_get_z(svW_nextRd.get_mpz_t(), mpSum, GMP_RNDD);
+			mpfr_get_z(svW_nextRu.get_mpz_t(), mpSum, GMP_RNDU);
+		}
 
 		//handle the signed outputs
 		if(svW_nextRd < 0)
@@ -415,11 +777,160 @@ namespace flopoco {
 		mpfr_clears(mpW_next, mpSum, mpX, mpDip1, mpTmp, (mpfr_ptr)nullptr);
 	}
 
+	bool GenericComputationUnit::hasBitAccurateModel()
+	{
+		return true;
+	}
+
+	void GenericComputationUnit::simulateBitAccurate(TestCase * tc, map<string, mpz_class>& outputs)
+	{
+		int width = msbInt-lsbTrunc+1;
+		int log2Radix = ceil(log2(radix));
+		vector<mpz_class> terms;
+		mpz_class svSum, svCarry;
+
+		//an input, as a signed number
+		auto input = [&](string name, int size) -> mpz_class
+		{
+			mpz_class v = tc->getInputValue(name);
+
+			if(v >= (mpz_class(1) << (size-1)))
+				v -= (mpz_class(1) << size);
+			return v;
+		};
+		//a term of the sum, of weight lsb, truncated to lsbTrunc, as an unsigned number on the internal format
+		auto addTerm = [&](mpz_class v, int lsb)
+		{
+			mpz_class r;
+
+			if(lsb >= lsbTrunc)
+				v <<= (lsb-lsbTrunc);
+			else
+				v >>= (lsbTrunc-lsb);
+			mpz_fdiv_r_2exp(r.get_mpz_t(), v.get_mpz_t(), width);
+			terms.push_back(r);
+		};
+		//multiply by radix, the bits below lsbTrunc being zero, and scale the result back to lsbInt
+		auto output = [&](mpz_class v) -> mpz_class
+		{
+			mpz_fdiv_r_2exp(v.get_mpz_t(), mpz_class(v << log2Radix).get_mpz_t(), width);
+			return v << (lsbTrunc-lsbInt);
+		};
+
+		mpz_class svD0   = input("D0", msbD-lsbD+1);
+		mpz_class svDi   = input("Di", msbD-lsbD+1);
+		mpz_class svDip1 = (specialCase != 1 ? input("Dip1", msbD-lsbD+1) : mpz_class(0));
+
+		//the multiplexers of the unit are undefined for the digits out of the digit set
+		if(((specialCase != 1) && (MULTMODE_CU == 0) && (abs(svDip1) > maxDigit)) || (carrySave && (abs(svD0) > maxDigit)))
+			return;
+
+		//the terms, in the order of the rows of full adders in carry-save form
+		//	W_i[j-1], both the sum and the carry bits in carry-save form
+		addTerm(input("Wi", msbW-lsbW+1), lsbW);
+		if(carrySave)
+			addTerm(input("WiC", msbW-lsbW+1), lsbW);
+		//	-D_i[j-1], whose negation is completed by the constant in carry-save form
+		addTerm(carrySave ? mpz_class(-svDi-1) : mpz_class(-svDi), lsbD);
+		//	D_{i+1}[j-1]*X
+		if((specialCase != 1) && (MULTMODE_CU == 0))
+			addTerm(input(join("X_Mult_", vhdlize((int)svDip1.get_si())), msbDiMX-lsbDiMX+1), lsbDiMX);
+		else if(specialCase != 1)
+			addTerm(input("X", msbX-lsbX+1) * svDip1, lsbX+lsbD);
+		//	-D_0[j-1]*q_i
+		//	the faithful multiplier by the constant q_i is modelled by a rounding to nearest, one of the values it may return
+		if(carrySave)
+			terms.push_back(carrySaveConstant(specialCase != -1 ? svD0.get_si() : 0));
+		else if((specialCase != -1) && variableQi)
+		{
+			int lsbQTrunc = (lsbQ < lsbTrunc ? lsbTrunc : lsbQ);
+
+			addTerm(-svD0 * (input("Qi", msbQ-lsbQ+1) >> (lsbQTrunc-lsbQ)), lsbQTrunc+lsbD);
+		}
+		else if(specialCase != -1)
+		{
+			mpz_class product;
+			mpfr_t mpTmp;
+
+			mpfr_init2(mpTmp, LARGEPREC);
+			mpfr_mul_si(mpTmp, mpQi, -svD0.get_si(), GMP_RNDN);
+			mpfr_mul_2si(mpTmp, mpTmp, lsbD-lsbTrunc, GMP_RNDN);
+			mpfr_get_z(product.get_mpz_t(), mpTmp, GMP_RNDN);
+			mpfr_clear(mpTmp);
+			addTerm(product, lsbTrunc);
+		}
+
+		if(carrySave)
+		{
+			reduceCarrySave(terms, width, &svSum, &svCarry);
+			outputs["Wi_next"] = output(svSum);
+			outputs["WiC_next"] = output(svCarry);
+			return;
+		}
+
+		//the bitheap returns the sum of its terms, on the internal format
+		svSum = 0;
+		for(auto& term : terms)
+			svSum += term;
+		outputs["Wi_next"] = output(svSum);
+	}
+
+	ResourceEstimate GenericComputationUnit::estimateOwnResources()
+	{
+		//the registers and the critical path are those of the signals
+		ResourceEstimate r = Operator::estimateOwnResources();
+
+		r.lut = estimateLUTs(getTarget(), maxDigit, specialCase, msbInt-lsbTrunc+1,
+				msbDiMX-max(lsbDiMX, lsbTrunc)+1, (variableQi ? msbQ-max(lsbQ, lsbTrunc)+1 : 0), msbD-lsbD+1, carrySave);
+
+		return r;
+	}
+
+	double GenericComputationUnit::estimateLUTs(Target *target, int maxDigit, int specialCase,
+			int width, int widthDiMX, int widthQ, int widthD, bool carrySave)
+	{
+		int nbTerms = 2 + (specialCase != -1 ? 1 : 0) + (specialCase != 1 ? 1 : 0);
+		double lut;
+
+		//the bitheap reduces the terms to a single one: about one adder per additional term
+		//	in carry-save form, the carry bits of W_i are one more term, and the terms are reduced to two
+		//	by rows of full adders, one LUT per bit each (the constant of iteration 0 is also a term)
+		if(carrySave)
+			lut = (nbTerms + (specialCase == -1 ? 2 : 1) - 2) * width;
+		else
+			lut = (nbTerms-1) * width * target->getLUTPerAdderSubtracter(width, width);
+		//the selection of D_{i+1}[j-1]*X among the 2*maxDigit+1 multiples of X
+		if(specialCase != 1)
+			lut += widthDiMX * target->getLUTFromMux(2*maxDigit+1);
+		//the product D_0[j-1]*q_i
+		//	by a constant: D_0 fits in the input of a LUT, so about one LUT per bit of the product
+		//	by a variable: the partial products, two per LUT
+		if((specialCase != -1) && (widthQ > 0))
+			lut += ceil(2.0 * widthQ * widthD / target->lutInputs());
+		else if(specialCase != -1)
+			lut += width;
+
+		return lut;
+	}
+
+	double GenericComputationUnit::estimateDelay(Target *target, int maxDigit, int specialCase, int width, bool carrySave)
+	{
+		//the selection of D_{i+1}[j-1]*X among the 2*maxDigit+1 multiples (4 inputs per LUT level)
+		double delay = target->lutDelay() * std::max(1, (int)ceil(log2(2*maxDigit+1)/2.0)) + target->localWireDelay();
+
+		//the rows of full adders, the first one on the inputs of the unit, in parallel with the multiplexers
+		if(carrySave)
+			return delay + (specialCase == 1 ? 1 : 2) * (target->lutDelay() + target->localWireDelay());
+		//the compression of the bitheap, then its final adder
+		return delay + target->lutDelay() + target->adderDelay(width);
+	}
+
 	OperatorPtr GenericComputationUnit::parseArguments(Target *target, std::vector<std::string> &args) {
 		int radix, index, maxDigit;
 		int msbW, lsbW, msbX, lsbX, msbD, lsbD;
 		string qi;
 		int specialCase;
+		bool carrySave;
 
 		UserInterface::parseInt(args, "radix", &radix);
 		UserInterface::parseInt(args, "maxDigit", &maxDigit);
@@ -432,12 +943,14 @@ namespace flopoco {
 		UserInterface::parseInt(args, "msbD", &msbD);
 		UserInterface::parseInt(args, "lsbD", &lsbD);
 		UserInterface::parseString(args, "q_i", &qi);
+		UserInterface::parseBoolean(args, "carrySave", &carrySave);
 
 		Signal *W  = new Signal("W", Signal::wire, true, msbW, lsbW);
 		Signal *X  = new Signal("X", Signal::wire, true, msbX, lsbX);
 		Signal *Di = new Signal("D", Signal::wire, true, msbD, lsbD);
 
-		return new GenericComputationUnit(target, radix, maxDigit, index, specialCase, W, X, Di, qi);
+		return new GenericComputationUnit(target, radix, maxDigit, index, specialCase, W, X, Di, qi,
+				CU_NO_TRUNCATION, carrySave);
 	}
 
 	void GenericComputationUnit::registerFactory(){
@@ -455,7 +968,8 @@ namespace flopoco {
 				 lsbX(int): LSB of the X input signal;\
 				 msbD(int): MSB of the D input signals;\
 				 lsbD(int): LSB of the D input signals;\
-				 q_i(string): the q_i constant, given in arbitrary-precision decimal, or as a Sollya expression, e.g \"log(2)\""
+				 q_i(string): the q_i constant, given in arbitrary-precision decimal, or as a Sollya expression, e.g \"log(2)\";\
+				 carrySave(bool)=false: keep W in carry-save form, as the inputs Wi and WiC and the outputs Wi_next and WiC_next"
 				"",
 				"",
 				GenericComputationUnit::parseArguments,
@@ -470,6 +984,37 @@ namespace flopoco {
 		TestList testStateList;
 		vector<pair<string,string>> paramList;
 
+		if(index==-1)
+		{ // The unit tests
+			// the formats used by FixEMethodEvaluator for lsbIn=-16, for the three kinds of units
+			for(int radix=2; radix<=8; radix*=2)
+			{
+				for(int specialCase=-1; specialCase<=1; specialCase++)
+				{
+					paramList.push_back(make_pair("radix", to_string(radix)));
+					paramList.push_back(make_pair("maxDigit", to_string(radix-1)));
+					paramList.push_back(make_pair("index", to_string(specialCase == -1 ? 0 : (specialCase == 0 ? 1 : 3))));
+					paramList.push_back(make_pair("specialCase", to_string(specialCase)));
+					paramList.push_back(make_pair("msbW", to_string(7)));
+					paramList.push_back(make_pair("lsbW", to_string(-16)));
+					paramList.push_back(make_pair("msbX", to_string(0)));
+					paramList.push_back(make_pair("lsbX", to_string(-16)));
+					paramList.push_back(make_pair("msbD", to_string((int)ceil(log2(radix)))));
+					paramList.push_back(make_pair("lsbD", to_string(0)));
+					paramList.push_back(make_pair("q_i", "0.015625"));
+					testStateList.push_back(paramList);
+					//	the same units, in carry-save form
+					paramList.push_back(make_pair("carrySave", "true"));
+					testStateList.push_back(paramList);
+					paramList.clear();
+				}
+			}
+		}
+		else
+		{
+				// finite number of random test computed out of index
+		}
+
 		return testStateList;
 	}
 
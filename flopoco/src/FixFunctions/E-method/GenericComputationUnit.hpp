@@ -13,6 +13,7 @@
 #include <iostream>
 #include <iomanip>
 #include <string>
+#include <climits>
 
 #include <sollya.h>
 #include <gmpxx.h>
@@ -29,6 +30,9 @@
 //	MULTIMODE = 1 - using a multiplier, by multiplying the inputs
 #define MULTMODE_CU 0
 
+//the value of the truncation LSB meaning that the computations are not truncated
+#define CU_NO_TRUNCATION INT_MIN
+
 //the precision used to parse the constant
 #define LARGEPREC 10000
 
@@ -63,6 +67,14 @@ namespace flopoco {
 		 * @param   X              the input signal X
 		 * @param   Di             the input signal Di
 		 * @param   qi             the coefficient q_i
+		 * @param   lsbTrunc       the LSB to which the computations are truncated (CU_NO_TRUNCATION for none)
+		 *                           the terms of the sum are truncated to lsbTrunc, and the bits of
+		 *                           Wi_next below lsbTrunc+log2(radix) are zero
+		 * @param   carrySave      when true, w_i is kept in carry-save form: the unit has the inputs Wi and WiC,
+		 *                           and the outputs Wi_next and WiC_next, whose sum is w_i[j].
+		 *                           The terms are reduced by rows of full adders instead of a bitheap
+		 *                           ending with a carry-propagate adder, so that the delay of the unit
+		 *                           does not depend on its width.
 		 */
 		GenericComputationUnit(Target* target,
 				int    radix,
@@ -73,6 +85,29 @@ namespace flopoco {
 				Signal *X,
 				Signal *Di,
 				string qi,
+				int    lsbTrunc = CU_NO_TRUNCATION,
+				bool   carrySave = false,
+				map<string, double> inputDelays = emptyDelayMap);
+
+		/**
+		 * A constructor for a variable coefficient q_i.
+		 *
+		 * Performs the same computation as the simple constructor, but q_i is
+		 * an input of the unit (Qi), multiplied by d_0 using a generic multiplier.
+		 * @param   Qi             the input signal Qi, giving the format of q_i
+		 * The other parameters are the same as for the simple constructor.
+		 */
+		GenericComputationUnit(Target* target,
+				int    radix,
+				int    maxDigit,
+				int    index,
+				int    specialCase,
+				Signal *W,
+				Signal *X,
+				Signal *Di,
+				Signal *Qi,
+				int    lsbTrunc = CU_NO_TRUNCATION,
+				bool   carrySave = false,
 				map<string, double> inputDelays = emptyDelayMap);
 
 		/**
@@ -86,6 +121,50 @@ namespace flopoco {
 		 */
 		void emulate(TestCase * tc);
 
+		/** simulateBitAccurate() is implemented */
+		bool hasBitAccurateModel();
+
+		/**
+		 * The outputs of the unit, computed on the internal format: the terms are truncated to lsbTrunc,
+		 * summed, or reduced by rows of full adders in carry-save form, then multiplied by the radix.
+		 * The faithful multiplier by a constant q_i is modelled by a rounding to nearest.
+		 */
+		void simulateBitAccurate(TestCase * tc, map<string, mpz_class>& outputs);
+
+		/**
+		 * The LUTs of the sum of the terms in the bitheap, of the selection of D_{i+1}*X
+		 * and of the product D_0*q_i, from the cost functions of the target
+		 */
+		ResourceEstimate estimateOwnResources();
+
+		/**
+		 * The LUTs of estimateOwnResources(), from the formats only, so that they can be
+		 * estimated without building the unit
+		 * @param   width          the width of the internal format, after truncation
+		 * @param   widthDiMX      the width of the multiples of X, after truncation
+		 * @param   widthQ         the width of a variable q_i, 0 when q_i is a constant
+		 * @param   widthD         the width of a digit
+		 */
+		static double estimateLUTs(Target *target, int maxDigit, int specialCase,
+				int width, int widthDiMX, int widthQ, int widthD, bool carrySave = false);
+
+		/**
+		 * The delay of a unit, from W_i[j-1] and the digits to W_i[j]: the selection of D_{i+1}[j-1]*X,
+		 * then either the bitheap and its final adder, or the rows of full adders in carry-save form
+		 * @param   width          the width of the internal format, after truncation
+		 */
+		static double estimateDelay(Target *target, int maxDigit, int specialCase, int width, bool carrySave = false);
+
+		/**
+		 * The reduction of the terms of the sum by rows of full adders, as done by the hardware in carry-save form:
+		 * the first three terms of the list are replaced by their sum and carry bits, appended to the list,
+		 * until two terms remain
+		 * @param   terms          the terms, as unsigned numbers on width bits
+		 * @param   sum            the sum bits of the result
+		 * @param   carry          the carry bits of the result
+		 */
+		static void reduceCarrySave(vector<mpz_class> terms, int width, mpz_class *sum, mpz_class *carry);
+
 		// User-interface stuff
 		/**
 		 * Factory method
@@ -97,6 +176,40 @@ namespace flopoco {
 		static TestList unitTest(int index);
 
 	private:
+		/**
+		 * The constructor doing the actual work, for either a constant (qi) or a variable (Qi) coefficient
+		 */
+		GenericComputationUnit(Target* target,
+				int    radix,
+				int    maxDigit,
+				int    index,
+				int    specialCase,
+				Signal *W,
+				Signal *X,
+				Signal *Di,
+				string qi,
+				Signal *Qi,
+				int    lsbTrunc,
+				bool   carrySave,
+				map<string, double> inputDelays);
+
+		/**
+		 * The selection of D_{i+1}[j-1]*X among the multiples of X, in the signal Dip1_Mult_X
+		 */
+		void generateDigitTimesX();
+
+		/**
+		 * The sum of the terms in carry-save form: the terms are reduced to Wi_next and WiC_next
+		 * by rows of full adders, as computed by reduceCarrySave()
+		 */
+		void generateCarrySaveSum();
+
+		/**
+		 * The constant added to the carry-save sum for the value d of D_0[j-1]: -d*q_i rounded to lsbTrunc,
+		 * plus the 1 completing the negation of D_i[j-1], in units of 2^lsbTrunc
+		 */
+		mpz_class carrySaveConstant(int d);
+
 		int radix;                            /**< the radix of the digit set being used */
 		int maxDigit;                         /**< the maximum digit in the used digit set */
 
@@ -113,12 +226,20 @@ namespace flopoco {
 		int msbInt;                           /**< MSB used for the internal computations */
 		int lsbInt;                           /**< LSB used for the internal computations */
 
+		int lsbTrunc;                         /**< LSB to which the terms of the sum are truncated, lsbInt if not truncated */
+
 		int msbDiMX;                          /**< MSB used of the DiMultX signals */
 		int lsbDiMX;                          /**< LSB used of the DiMultX signals */
 
 		string qi;                            /**< the q_i coefficient */
 		mpfr_t mpQi;                          /**< the q_i coefficient as an MPFR number */
 
+		bool variableQi;                      /**< flag showing whether q_i is an input of the unit, or a constant */
+		int msbQ;                             /**< MSB of the Qi signal, when q_i is variable */
+		int lsbQ;                             /**< LSB of the Qi signal, when q_i is variable */
+
+		bool carrySave;                       /**< true if W_i is kept in carry-save form, as Wi and WiC */
+
 		BitHeap *bitheap;                     /**< the bitheap used for the computations */
 	};
 
@@ -7,18 +7,19 @@
 
 #include "GenericSimpleSelectionFunction.hpp"
 
+#include "FixFunctions/GenericTable.hpp"
+
 namespace flopoco {
 
 		GenericSimpleSelectionFunction::GenericSimpleSelectionFunction(Target* target, int _radix, int maxDigit_,
-				Signal *_W, map<string, double> inputDelays)
-		: Operator(target), radix(_radix), maxDigit(maxDigit_), msbIn(_W->MSB()), lsbIn(_W->LSB())
+				Signal *_W, string _method, bool _carrySave, double delta, map<string, double> inputDelays)
+		: Operator(target), radix(_radix), maxDigit(maxDigit_), msbIn(_W->MSB()), lsbIn(_W->LSB()),
+		  method(_method), carrySave(_carrySave), lsbEstimate(0)
 		{
 			ostringstream name;
 			mpz_class iterLimit;
 
 			srcFileName = "GenericSimpleSelectionFunction";
-			name << "GenericSimpleSelectionFunction_radix" << radix << "_msbIn_" << vhdlize(msbIn) << "_lsbIn_" << vhdlize(lsbIn);
-			setName(name.str()+"_uid"+vhdlize(getNewUId()));
 
 			//safety checks
 			if(maxDigit < 0)
@@ -29,12 +30,32 @@ namespace flopoco {
 				THROWERROR("maximum digit larger than the maximum digit in the redundant digit set!");
 			if(intlog2(abs(maxDigit)) >= (1<<msbIn))
 				THROWERROR("maximum digit not representable on the given input format!");
+			//in carry-save form, the estimate is already the output of an adder
+			if(carrySave && (delta <= 0))
+				THROWERROR("the selection of a residual in carry-save form requires delta > 0");
+			if(carrySave && (method != "auto") && (method != "compressed"))
+				THROWERROR("the selection of a residual in carry-save form only supports the compressed method");
+			if(carrySave)
+				method = "compressed";
+			if(method == "auto")
+				method = chooseMethod(target, radix, maxDigit);
+			if((method != "logic") && (method != "compressed") && (method != "rom"))
+				THROWERROR("unknown selection method " << method << ", should be one of auto, logic, compressed or rom");
+
+			name << "GenericSimpleSelectionFunction_radix" << radix << "_msbIn_" << vhdlize(msbIn) << "_lsbIn_" << vhdlize(lsbIn);
+			if(method != "logic")
+				name << "_" << method;
+			if(carrySave)
+				name << "_cs";
+			setName(name.str()+"_uid"+vhdlize(getNewUId()));
 
 			setCopyrightString("Matei Istoan, 2017");
 
 			useNumericStd_Signed();
 
-			setCombinatorial();
+			//a ROM in a memory block may be pipelined by the Table
+			if(method != "rom")
+				setCombinatorial();
 
 			//get the format of the W^ signal
 			getWHatFormat(radix, maxDigit, &msbWHat, &lsbWHat);
@@ -50,47 +71,124 @@ namespace flopoco {
 			setCriticalPath(getMaxInputDelays(inputDelays));
 			//--------- pipelining
 
-			//add the inputs
+			//add the inputs and the output
 			addFixInput("W", true, msbIn, lsbIn);
-			//add the outputs
+			if(carrySave)
+				addFixInput("WC", true, msbIn, lsbIn);
 			addFixOutput("D", true, outputSize-1, 0);
 
+			if(carrySave)
+			{
+				//the estimate of the residual, from the top bits of W and WC
+				//	the top bit of W has the weight of the MSB of W^Hat, as for a non-redundant residual
+				lsbEstimate = getCarrySaveEstimateLsb(delta);
+				if(lsbEstimate < msbWHat-(msbIn-lsbIn))
+					lsbEstimate = msbWHat-(msbIn-lsbIn);
+				int wEstimate = msbWHat-lsbEstimate+1;
+
+				REPORT(DEBUG, "estimate of the carry-save residual on " << wEstimate << " bits, lsb=" << lsbEstimate);
+
+				vhdl << tab << declareFixPoint("WHat", true, msbWHat, lsbEstimate)
+						<< " <= W" << range(msbIn-lsbIn, msbIn-lsbIn-wEstimate+1) << ";" << endl;
+				vhdl << tab << declareFixPoint("WHatC", true, msbWHat, lsbEstimate)
+						<< " <= WC" << range(msbIn-lsbIn, msbIn-lsbIn-wEstimate+1) << ";" << endl;
+
+				//--------- pipelining
+				manageCriticalPath(target->adderDelay(wEstimate)+target->lutDelay()+target->localWireDelay(), true);
+				//--------- pipelining
+
+				//	the sum of the estimates and of 1/2, rounded down to an integer, is the nearest integer
+				//	the residuals are bounded, so the sum does not overflow
+				vhdl << tab << declareFixPoint("WHat_round", true, msbWHat, lsbEstimate)
+						<< " <= WHat + WHatC + " << (1 << (-1-lsbEstimate)) << ";" << endl;
+				vhdl << tab << declareFixPoint("WHat_int", true, msbWHat, 0)
+						<< " <= WHat_round" << range(wEstimate-1, -lsbEstimate) << ";" << endl;
+				vhdl << tab << "D <= "
+						<< "std_logic_vector(to_signed(" << maxDigit << ", " << outputSize << ")) when WHat_int > " << maxDigit
+						<< " else std_logic_vector(to_signed(" << -maxDigit << ", " << outputSize << ")) when WHat_int < " << -maxDigit
+						<< " else std_logic_vector(WHat_int" << range(outputSize-1, 0) << ");" << endl;
+
+				outDelayMap["D"] = getCriticalPath();
+				return;
+			}
+
 			vhdl << tab << declareFixPoint("WHat", true, msbWHat, lsbWHat)
 					<< " <= W" << range(msbIn-lsbIn, msbIn-lsbIn-wHatSize+1) << ";" << endl;
 
-			//--------- pipelining
-			manageCriticalPath(target->lutDelay()+target->localWireDelay(), true);
-			//--------- pipelining
+			if(method == "logic")
+			{
+				//--------- pipelining
+				manageCriticalPath(target->lutDelay()+target->localWireDelay(), true);
+				//--------- pipelining
 
-			vhdl << tab << "with WHat select D <= \n";
-			if(((1<<wHatSize)-1) > (maxDigit+1))
-				// maxDigit+1 so as to avoid possible overflows
-				iterLimit = (maxDigit+1) << 1;
+				if(((1<<wHatSize)-1) > (maxDigit+1))
+					// maxDigit+1 so as to avoid possible overflows
+					iterLimit = (maxDigit+1) << 1;
+				else
+					// maximum allowed number in this radix
+					iterLimit = (1 << wHatSize) - 1;
+				vhdl << tab << "with WHat select D <= \n";
+				for(mpz_class i=-iterLimit; i<=iterLimit; i++)
+				{
+					mpz_class digitValue = selectDigit(i);
+					mpz_class iAbs = i;
+
+					//handle negative digits at the output
+					if(digitValue < 0)
+						digitValue = mpz_class(1<<outputSize) + digitValue;
+					//handle negative indices
+					if(i < 0)
+						iAbs = mpz_class(1<<wHatSize) + i;
+					//create the corresponding output line
+					vhdl << tab << tab << "\"" << unsignedBinary(digitValue, outputSize) << "\" when \""
+							<< unsignedBinary(iAbs, wHatSize) << "\", \n";
+				}
+				vhdl << tab << tab << "\"" << std::string(outputSize, '-') << "\" when others;\n" << endl;
+			}
+			else if(method == "compressed")
+			{
+				//the table only rounds W^Hat to the nearest integer, then saturates to the digit set:
+				//	an incrementer and two comparisons instead of 2^wHatSize entries
+				//--------- pipelining
+				manageCriticalPath(target->adderDelay(wHatSize+1)+target->lutDelay()+target->localWireDelay(), true);
+				//--------- pipelining
+
+				vhdl << tab << declareFixPoint("WHat_round", true, msbWHat+1, lsbWHat)
+						<< " <= resize(WHat, " << wHatSize+1 << ") + 1;" << endl;
+				vhdl << tab << declareFixPoint("WHat_int", true, msbWHat+1, 0)
+						<< " <= WHat_round" << range(wHatSize, 1) << ";" << endl;
+				vhdl << tab << "D <= "
+						<< "std_logic_vector(to_signed(" << maxDigit << ", " << outputSize << ")) when WHat_int > " << maxDigit
+						<< " else std_logic_vector(to_signed(" << -maxDigit << ", " << outputSize << ")) when WHat_int < " << -maxDigit
+						<< " else std_logic_vector(WHat_int" << range(outputSize-1, 0) << ");" << endl;
+			}
 			else
-				// maximum allowed number in this radix
-				iterLimit = (1 << wHatSize) - 1;
-			for(mpz_class i=-iterLimit; i<=iterLimit; i++)
 			{
-				mpz_class digitValue = (i+1) >> 1;
-				mpz_class iAbs = i;
-
-				//corner cases at the end of the intervals
-				//	in order to keep the resulting digit in the allowed digit set
-				if(digitValue > maxDigit)
-					digitValue = maxDigit;
-				else if(digitValue < -maxDigit)
-					digitValue = -maxDigit;
-				//handle negative digits at the output
-				if(digitValue < 0)
-					digitValue = mpz_class(1<<outputSize) + digitValue;
-				//handle negative indices
-				if(i < 0)
-					iAbs = mpz_class(1<<wHatSize) + i;
-				//create the corresponding output line
-				vhdl << tab << tab << "\"" << unsignedBinary(digitValue, outputSize) << "\" when \""
-						<< unsignedBinary(iAbs, wHatSize) << "\", \n";
+				//the table of all the 2^wHatSize values of W^Hat, indexed by their two's complement representation
+				vector<mpz_class> values;
+				for(int x=0; x<(1<<wHatSize); x++)
+				{
+					mpz_class digitValue = selectDigit(x < (1<<(wHatSize-1)) ? x : x-(1<<wHatSize));
+
+					if(digitValue < 0)
+						digitValue += mpz_class(1<<outputSize);
+					values.push_back(digitValue);
+				}
+
+				vhdl << tab << declare("WHat_slv", wHatSize) << " <= std_logic_vector(WHat);" << endl;
+
+				GenericTable *rom = new GenericTable(target, wHatSize, outputSize, values);
+
+				addSubComponent(rom);
+				inPortMap(rom, "X", "WHat_slv");
+				outPortMap(rom, "Y", "D_rom");
+				vhdl << tab << instance(rom, "SelectionROM");
+				//--------- pipelining
+				syncCycleFromSignal("D_rom");
+				setCriticalPath(rom->getOutDelayMap()["Y"]);
+				//--------- pipelining
+				vhdl << tab << "D <= D_rom;" << endl;
 			}
-			vhdl << tab << tab << "\"" << std::string(outputSize, '-') << "\" when others;\n" << endl;
 
 			outDelayMap["D"] = getCriticalPath();
 		}
@@ -102,11 +200,57 @@ namespace flopoco {
 		}
 
 
+		mpz_class GenericSimpleSelectionFunction::selectDigit(mpz_class wHat)
+		{
+			//round to nearest: W^Hat has one fractional bit
+			mpz_class digitValue = (wHat+1) >> 1;
+
+			//corner cases at the end of the intervals
+			//	in order to keep the resulting digit in the allowed digit set
+			if(digitValue > maxDigit)
+				digitValue = maxDigit;
+			else if(digitValue < -maxDigit)
+				digitValue = -maxDigit;
+
+			return digitValue;
+		}
+
+
+		int GenericSimpleSelectionFunction::getCarrySaveEstimateLsb(double delta)
+		{
+			return floor(log2(delta)) - 2;
+		}
+
+
+		string GenericSimpleSelectionFunction::getMethod()
+		{
+			return method;
+		}
+
+
+		string GenericSimpleSelectionFunction::chooseMethod(Target *target, int radix, int maxDigit, bool allowMemory)
+		{
+			int msb, lsb, wHat;
+
+			getWHatFormat(radix, maxDigit, &msb, &lsb);
+			wHat = msb-lsb+1;
+			//one LUT per output bit: nothing is cheaper
+			if(wHat <= target->lutInputs())
+				return "logic";
+			//the rule of Table for memory blocks
+			if(allowMemory && (intlog2(radix) * intpow2(wHat) >= 0.5*target->sizeOfMemoryBlock()))
+				return "rom";
+			return (estimateLUTs(target, radix, maxDigit, "compressed") < estimateLUTs(target, radix, maxDigit, "logic")
+					? "compressed" : "logic");
+		}
+
+
 		void GenericSimpleSelectionFunction::getWHatFormat(int _radix, int _maxDigit, int *_msb, int *_lsb)
 		{
 			size_t wHSize = 0;
 
 			//W^ is an estimation of W, made out of only a few MSBs of W
+			//	it holds the residuals up to maxDigit+1/2, with one fractional bit and one guard bit
 			if(_radix == 2)
 			{
 				//only the 4 top MSBs are needed
@@ -119,13 +263,13 @@ namespace flopoco {
 			{
 				//only the 6 top MSBs are needed
 				wHSize = 6;
-			}if(_radix == 16)
+			}else if(_radix == 16)
 			{
-				//only the 6 top MSBs are needed
+				//only the 7 top MSBs are needed
 				wHSize = 7;
-			}if(_radix == 32)
+			}else if(_radix == 32)
 			{
-				//only the 6 top MSBs are needed
+				//only the 8 top MSBs are needed
 				wHSize = 8;
 			}else
 			{
@@ -144,66 +288,209 @@ namespace flopoco {
 
 		void GenericSimpleSelectionFunction::emulate(TestCase * tc)
 		{
+			if(carrySave)
+			{
+				int wEstimate = msbWHat-lsbEstimate+1;
+				int shift = (msbIn-lsbIn+1) - wEstimate;
+				mpz_class svW = tc->getInputValue("W");
+				mpz_class svWC = tc->getInputValue("WC");
+				mpz_class svEstimate, svD;
+
+				// the sum of the top bits of W and WC, and of 1/2, on wEstimate bits
+				svEstimate = (svW >> shift) + (svWC >> shift) + (mpz_class(1) << (-1-lsbEstimate));
+				svEstimate &= ((mpz_class(1) << wEstimate) - 1);
+				if(svEstimate >= (mpz_class(1) << (wEstimate-1)))
+					svEstimate -= (mpz_class(1) << wEstimate);
+
+				// rounded down to an integer, and limited to the allowed digit set
+				mpz_fdiv_q_2exp(svD.get_mpz_t(), svEstimate.get_mpz_t(), -lsbEstimate);
+				if(svD > maxDigit)
+					svD = maxDigit;
+				else if(svD < -maxDigit)
+					svD = -maxDigit;
+
+				// manage two's complement at the output
+				if(svD < 0)
+					svD += (mpz_class(1) << outputSize);
+				tc->addExpectedOutput("D", svD);
+				return;
+			}
+
 			// get the inputs from the TestCase
 			mpz_class svW = tc->getInputValue("W");
 
-			// manage signed digits
-			mpz_class big1int = (mpz_class(1) << wHatSize);
-			mpz_class big1intP = (mpz_class(1) << (wHatSize-1));
-			mpz_class big1out = (mpz_class(1) << outputSize);
+			// keep the top wHatSize bits, as a signed number
+			svW = svW >> ((msbIn-lsbIn+1) - wHatSize);
+			if(svW >= (mpz_class(1) << (wHatSize-1)))
+				svW -= (mpz_class(1) << wHatSize);
+
+			// the logic table leaves the values of W^Hat beyond maxDigit+1 unspecified
+			if((method == "logic") && (((1<<wHatSize)-1) > (maxDigit+1)) && (abs(svW) > 2*(maxDigit+1)))
+				return;
+
+			// round to nearest, and limit the output digit to the allowed digit set
+			mpz_class svD = selectDigit(svW);
 
-			if((msbIn-(int)wHatSize+1) > lsbIn)
+			// manage two's complement at the output
+			if(svD < 0)
+				svD += (mpz_class(1) << outputSize);
+
+			// complete the TestCase with this expected output
+			tc->addExpectedOutput("D", svD);
+		}
+
+		bool GenericSimpleSelectionFunction::hasBitAccurateModel()
+		{
+			return true;
+		}
+
+		void GenericSimpleSelectionFunction::simulateBitAccurate(TestCase * tc, map<string, mpz_class>& outputs)
+		{
+			// the top bits of an input, as a signed number
+			auto topBits = [&](string name, int size) -> mpz_class
 			{
-				if((msbIn-wHatSize) < 0)
-					svW = svW >> abs((long int)((msbIn-wHatSize+1)-lsbIn));
-				else
-					svW = svW << abs((long int)((msbIn-wHatSize+1)-lsbIn));
-			}
+				mpz_class v = tc->getInputValue(name) >> ((msbIn-lsbIn+1) - size);
+
+				if(v >= (mpz_class(1) << (size-1)))
+					v -= (mpz_class(1) << size);
+				return v;
+			};
+			// the saturation of the compressed method: the integer itself, or the largest digit of its sign
+			auto saturate = [&](mpz_class v) -> mpz_class
+			{
+				if(v > maxDigit)
+					return maxDigit;
+				else if(v < -maxDigit)
+					return -maxDigit;
+				return v;
+			};
+			// the digit on the output, as its two's complement bits
+			auto toOutput = [&](mpz_class d) -> mpz_class
+			{
+				mpz_class r;
+
+				mpz_fdiv_r_2exp(r.get_mpz_t(), d.get_mpz_t(), outputSize);
+				return r;
+			};
 
-			if(svW >= big1intP)
-				svW -= big1int;
+			if(carrySave)
+			{
+				int wEstimate = msbWHat-lsbEstimate+1;
+				mpz_class svEstimate, svInt;
+
+				// the adder of the estimate, and of 1/2, on wEstimate bits, then its integer part
+				svEstimate = topBits("W", wEstimate) + topBits("WC", wEstimate) + (mpz_class(1) << (-1-lsbEstimate));
+				mpz_fdiv_r_2exp(svEstimate.get_mpz_t(), svEstimate.get_mpz_t(), wEstimate);
+				if(svEstimate >= (mpz_class(1) << (wEstimate-1)))
+					svEstimate -= (mpz_class(1) << wEstimate);
+				mpz_fdiv_q_2exp(svInt.get_mpz_t(), svEstimate.get_mpz_t(), -lsbEstimate);
+				outputs["D"] = toOutput(saturate(svInt));
+				return;
+			}
 
-			// compute the multiple-precision output
+			mpz_class svWHat = topBits("W", wHatSize);
 			mpz_class svD;
-			// round down
-			/*
-			if(abs(svW) <= ((radix-1)<<1))
-				svD = sgn(svW)*(abs(svW) + mpz_class(1)) >> 1;
-			else
-				svD = sgn(svW)*abs(svW) >> 1;
-			*/
-			// round to nearest
-			if(abs(svW) <= ((radix-1)<<1))
-				svD = (svW + mpz_class(1)) >> 1;
+
+			if(method == "logic")
+			{
+				// the cases of the table, the others being unspecified
+				mpz_class iterLimit = (((1<<wHatSize)-1) > (maxDigit+1) ? (maxDigit+1) << 1 : (1 << wHatSize) - 1);
+
+				if(abs(svWHat) > iterLimit)
+					return;
+				svD = selectDigit(svWHat);
+			}
+			else if(method == "compressed")
+			{
+				// the incrementer, on wHatSize+1 bits, then the integer part and the saturation
+				mpz_fdiv_q_2exp(svD.get_mpz_t(), mpz_class(svWHat+1).get_mpz_t(), 1);
+				svD = saturate(svD);
+			}
 			else
-				svD = sgn(svW)*abs(radix-1);
+			{
+				// the entry of the ROM at the address W^Hat
+				svD = selectDigit(svWHat);
+			}
 
-			// limit the output digit to the allowed digit set
-			if(abs(svW) > maxDigit)
-				svD = sgn(svW) * mpz_class(maxDigit);
+			outputs["D"] = toOutput(svD);
+		}
 
-			// manage two's complement at the output
-			if(svD < 0)
-				//svD += big1out;
-				svD += big1int;
-			//only use radix bits at the output
-			svD = svD & ((1<<outputSize)-1);
+		ResourceEstimate GenericSimpleSelectionFunction::estimateOwnResources()
+		{
+			ResourceEstimate r = Operator::estimateOwnResources();
 
-			// complete the TestCase with this expected output
-			tc->addExpectedOutput("D", svD);
+			if(carrySave)
+				r.lut = estimateLUTs(getTarget(), radix, maxDigit, method, true, intpow2(lsbEstimate+2));
+			//the ROM is a Table, which estimates itself
+			else if(method != "rom")
+				r.lut = estimateLUTs(getTarget(), radix, maxDigit, method);
+
+			return r;
+		}
+
+		double GenericSimpleSelectionFunction::estimateLUTs(Target *target, int radix, int maxDigit, string method,
+				bool carrySave, double delta)
+		{
+			int msb, lsb, wHat;
+			int outSize = intlog2(radix);
+
+			getWHatFormat(radix, maxDigit, &msb, &lsb);
+			wHat = msb-lsb+1;
+			if(carrySave)
+			{
+				int wEstimate = msb-getCarrySaveEstimateLsb(delta)+1;
+
+				//the adder of the estimate, which also rounds it, then the comparisons and the selection of compressed
+				return wEstimate * target->getLUTPerAdderSubtracter(wEstimate, wEstimate)
+						+ 2 * ceil(2.0 * (msb+1) / target->lutInputs())
+						+ outSize * target->getLUTFromMux(3);
+			}
+			if(method == "auto")
+				method = chooseMethod(target, radix, maxDigit);
+
+			if(method == "compressed")
+				//the rounding incrementer, the two comparisons with constants (a carry chain, lutInputs/2 bits per LUT)
+				//	and the selection between the rounded value and the two saturated ones
+				return (wHat+1) * target->getLUTPerAdderSubtracter(wHat+1, wHat+1)
+						+ 2 * ceil(2.0 * (wHat+1) / target->lutInputs())
+						+ outSize * target->getLUTFromMux(3);
+			//a ROM in a memory block uses no LUT
+			if((method == "rom") && (chooseMethod(target, radix, maxDigit) == "rom"))
+				return 0;
+			//a table of 2^wHatSize entries of outputSize bits
+			return outSize * ceil(intpow2(wHat - target->lutInputs()));
+		}
+
+		double GenericSimpleSelectionFunction::estimateDelay(Target *target, int radix, int maxDigit, bool carrySave, double delta)
+		{
+			int msb, lsb;
+
+			getWHatFormat(radix, maxDigit, &msb, &lsb);
+			if(carrySave)
+				return target->localWireDelay() + target->adderDelay(msb-getCarrySaveEstimateLsb(delta)+1) + target->lutDelay();
+			//a logic table, on two levels of LUTs when W^Hat does not fit in a LUT
+			if(msb-lsb+1 > target->lutInputs())
+				return target->localWireDelay(intlog2(radix)) + 2*target->lutDelay() + target->localWireDelay();
+			return target->localWireDelay(intlog2(radix)) + target->lutDelay();
 		}
 
 		OperatorPtr GenericSimpleSelectionFunction::parseArguments(Target *target, std::vector<std::string> &args) {
 			int radix, maxDigit, msbIn, lsbIn;
+			string method;
+			bool carrySave;
+			double delta;
 
 			UserInterface::parseInt(args, "radix", &radix);
 			UserInterface::parseInt(args, "maxDigit", &maxDigit);
 			UserInterface::parseInt(args, "msbIn", &msbIn);
 			UserInterface::parseInt(args, "lsbIn", &lsbIn);
+			UserInterface::parseString(args, "method", &method);
+			UserInterface::parseBoolean(args, "carrySave", &carrySave);
+			UserInterface::parseFloat(args, "delta", &delta);
 
 			Signal *W = new Signal("W", Signal::wire, true, msbIn, lsbIn);
 
-			return new GenericSimpleSelectionFunction(target, radix, maxDigit, W);
+			return new GenericSimpleSelectionFunction(target, radix, maxDigit, W, method, carrySave, delta);
 		}
 
 		void GenericSimpleSelectionFunction::registerFactory(){
@@ -214,7 +501,10 @@ namespace flopoco {
 					"radix(int): the radix of the digit set being used;\
 						maxDigit(int): the maximum digit in the redundant digit set;\
 						msbIn(int): MSB of the input;\
-						lsbIn(int): LSB of the input"
+						lsbIn(int): LSB of the input;\
+						method(string)=auto: the implementation of the selection, one of auto, logic (a table), compressed (rounding and saturation) or rom (a Table, possibly in a memory block);\
+						carrySave(bool)=false: the residual is given in carry-save form, as the inputs W and WC;\
+						delta(real)=0.125: the delta of the E-method, which sets the width of the estimate of a residual in carry-save form"
 					"",
 					"",
 					GenericSimpleSelectionFunction::parseArguments,
@@ -231,33 +521,48 @@ namespace flopoco {
 
 			if(index==-1)
 			{ // The unit tests
-				paramList.push_back(make_pair("radix", to_string(2)));
-				paramList.push_back(make_pair("maxDigit", to_string(1)));
-				paramList.push_back(make_pair("msbIn", to_string(1)));
-				paramList.push_back(make_pair("lsbIn", to_string(-1)));
-				testStateList.push_back(paramList);
-				paramList.clear();
-
-				paramList.push_back(make_pair("radix", to_string(4)));
-				paramList.push_back(make_pair("maxDigit", to_string(2)));
-				paramList.push_back(make_pair("msbIn", to_string(2)));
-				paramList.push_back(make_pair("lsbIn", to_string(-1)));
-				testStateList.push_back(paramList);
-				paramList.clear();
-
-				paramList.push_back(make_pair("radix", to_string(4)));
-				paramList.push_back(make_pair("maxDigit", to_string(3)));
-				paramList.push_back(make_pair("msbIn", to_string(2)));
-				paramList.push_back(make_pair("lsbIn", to_string(-1)));
-				testStateList.push_back(paramList);
-				paramList.clear();
-
-				paramList.push_back(make_pair("radix", to_string(8)));
-				paramList.push_back(make_pair("maxDigit", to_string(7)));
-				paramList.push_back(make_pair("msbIn", to_string(3)));
-				paramList.push_back(make_pair("lsbIn", to_string(-1)));
-				testStateList.push_back(paramList);
-				paramList.clear();
+				// W^Hat is the whole input: msbIn is the MSB given by getWHatFormat()
+				auto addTest = [&](int radix, int maxDigit, string method)
+				{
+					int msb, lsb;
+
+					getWHatFormat(radix, maxDigit, &msb, &lsb);
+					paramList.push_back(make_pair("radix", to_string(radix)));
+					paramList.push_back(make_pair("maxDigit", to_string(maxDigit)));
+					paramList.push_back(make_pair("msbIn", to_string(msb)));
+					paramList.push_back(make_pair("lsbIn", to_string(lsb)));
+					paramList.push_back(make_pair("method", method));
+					testStateList.push_back(paramList);
+					paramList.clear();
+				};
+
+				addTest(2, 1, "auto");
+				addTest(4, 2, "auto");
+				addTest(4, 3, "auto");
+				addTest(8, 7, "auto");
+				addTest(16, 15, "auto");
+				addTest(32, 31, "auto");
+				// the implementations, on the largest tables
+				for(string method : {"logic", "compressed", "rom"})
+				{
+					addTest(16, 15, method);
+					addTest(32, 31, method);
+				}
+				// the residuals in carry-save form, with a few more bits than the estimate
+				for(int radix=2; radix<=32; radix*=4)
+				{
+					int msb, lsb;
+
+					getWHatFormat(radix, radix-1, &msb, &lsb);
+					paramList.push_back(make_pair("radix", to_string(radix)));
+					paramList.push_back(make_pair("maxDigit", to_string(radix-1)));
+					paramList.push_back(make_pair("msbIn", to_string(msb)));
+					paramList.push_back(make_pair("lsbIn", to_string(getCarrySaveEstimateLsb(0.125)-2)));
+					paramList.push_back(make_pair("carrySave", "true"));
+					paramList.push_back(make_pair("delta", "0.125"));
+					testStateList.push_back(paramList);
+					paramList.clear();
+				}
 			}
 			else
 			{
@@ -29,16 +29,28 @@ namespace flopoco {
 	public:
 		/**
 		 * A simple constructor.
-		 * Currently only implementing radix 2.
-		 * Higher radixes (4, 8 etc.) to come.
+		 * The digit is W^Hat, the top bits of W, rounded to the nearest integer
+		 * and saturated to the digit set.
 		 * @param   radix          the radix being used
 		 * @param   maxDigit       the maximum digit in the redundant digit set
 		 * @param   W              the input signal
+		 * @param   method         the implementation of the selection:
+		 *                           logic: a table of 2^wHatSize entries, as a case statement
+		 *                           compressed: the rounding adder and the saturation the table encodes
+		 *                           rom: a Table, in LUTs or in a memory block, as decided by the target
+		 *                           auto: chosen by chooseMethod()
+		 * @param   carrySave      when true, the residual is given in carry-save form, as the inputs W and WC:
+		 *                         W^Hat is the sum of their top bits, down to getCarrySaveEstimateLsb(delta),
+		 *                         and the selection uses the compressed method on it
+		 * @param   delta          the delta of the E-method, which bounds the error of the estimate in carry-save form
 		 */
 		GenericSimpleSelectionFunction(Target* target,
 				int    radix,
 				int    maxDigit,
 				Signal *W,
+				string method = "auto",
+				bool   carrySave = false,
+				double delta = 0.0,
 				map<string, double> inputDelays = emptyDelayMap);
 
 		/**
@@ -52,11 +64,51 @@ namespace flopoco {
 		 */
 		static void getWHatFormat(int radix, int maxDigit, int *msb, int *lsb);
 
+		/**
+		 * The LSB of the estimate of a residual in carry-save form.
+		 * Truncating the sum and the carry bits below it underestimates the residual by less than 2^(lsb+1),
+		 * which must not exceed delta/2 for the digits to keep the residuals bounded
+		 */
+		static int getCarrySaveEstimateLsb(double delta);
+
 		/**
 		 * Test case generator
 		 */
 		void emulate(TestCase * tc);
 
+		/** simulateBitAccurate() is implemented */
+		bool hasBitAccurateModel();
+
+		/**
+		 * The digits given by the implementation of the selection: the cases of the logic table,
+		 * the rounding adder and the saturation of the compressed method, or the entries of the ROM
+		 */
+		void simulateBitAccurate(TestCase * tc, map<string, mpz_class>& outputs);
+
+		/** The LUTs of the selection table, indexed by W^Hat (the ROM is a Table, which estimates itself) */
+		ResourceEstimate estimateOwnResources();
+
+		/** The LUTs of estimateOwnResources(), without building the unit */
+		static double estimateLUTs(Target *target, int radix, int maxDigit, string method = "auto",
+				bool carrySave = false, double delta = 0.0);
+
+		/**
+		 * The delay of the selection, from W to D: a table on W^Hat, or in carry-save form,
+		 * the adder of the estimate, then the rounding and the saturation
+		 */
+		static double estimateDelay(Target *target, int radix, int maxDigit, bool carrySave = false, double delta = 0.0);
+
+		/**
+		 * The implementation of the selection with the least LUTs, from the cost functions of the target:
+		 * the logic table when W^Hat fits in a LUT, a ROM when the target would put the table in a memory block,
+		 * and otherwise the cheapest of the logic table and of its compressed form
+		 * @param   allowMemory    false when the selection must remain combinatorial
+		 */
+		static string chooseMethod(Target *target, int radix, int maxDigit, bool allowMemory = true);
+
+		/** The implementation used, once auto has been resolved */
+		string getMethod();
+
 		// User-interface stuff
 		/**
 		 * Factory method
@@ -68,6 +120,12 @@ namespace flopoco {
 		static TestList unitTest(int index);
 
 	private:
+		/**
+		 * The digit selected for W^Hat, in units of its LSB:
+		 * the nearest integer, saturated to the digit set
+		 */
+		mpz_class selectDigit(mpz_class wHat);
+
 		int radix;                            /**< the radix of the digit set being used */
 		int maxDigit;                         /**< the maximum digit in the redundant digit set */
 		int msbIn;                            /**< MSB of the input */
@@ -79,6 +137,10 @@ namespace flopoco {
 
 		int outputSize;                       /**< size of the output */
 
+		string method;                        /**< the implementation of the selection: logic, compressed or rom */
+		bool carrySave;                       /**< true if the residual is given in carry-save form */
+		int lsbEstimate;                      /**< LSB of the estimate of W^Hat, in carry-save form */
+
 	};
 
 } /* namespace flopoco */
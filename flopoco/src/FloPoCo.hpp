@@ -40,6 +40,7 @@
 #include "Targets/CycloneV.hpp"
 
 #include "TestBenches/TestBench.hpp"
+#include "TestBenches/CoSimulation.hpp"
 
 /* regular pipelined integer adder/ adder+subtracter --------- */
 #include "IntAddSubCmp/IntAdder.hpp" // includes several other .hpp
@@ -72,6 +73,7 @@
 #include "FixFunctions/E-method/GenericSimpleSelectionFunction.hpp"
 #include "FixFunctions/E-method/GenericComputationUnit.hpp"
 #include "FixFunctions/E-method/FixEMethodEvaluator.hpp"
+#include "FixFunctions/E-method/FixEMethodExplorer.hpp"
 
 // AutoTest
 #include "AutoTest/AutoTest.hpp"
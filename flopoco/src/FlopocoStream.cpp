@@ -22,8 +22,10 @@
 #include <gmp.h>
 #include <mpfr.h>
 #include <cstdlib>
+#include <cctype>
 #include <gmpxx.h>
 #include "utils.hpp"
+#include "profiler.h"
 #include "FlopocoStream.hpp"
 
 
@@ -88,6 +90,7 @@ namespace flopoco{
 	}
 
 	string FlopocoStream::annotateIDs( int currentCycle ){
+		ProfileScope profile("lexing");
 		//				vhdlCode << "-- CurrentCycle is = " << currentCycle << endl;
 		ostringstream vhdlO;
 		istringstream in( vhdlCodeBuffer.str() );
@@ -103,6 +106,7 @@ namespace flopoco{
 		   class useTable */
 
 		updateUseMap(lexer);
+		delete lexer;
 		/* the annotated string is returned */
 		return vhdlO.str();
 	}
@@ -128,6 +132,61 @@ namespace flopoco{
 	}
 
 
+	void FlopocoStream::addUse(string id, int cycle){
+		flush(cycle);
+		if(disabledParsing){
+			vhdlCode << id;
+		}else{
+			/* the same annotation and use as the lexer */
+			vhdlCode << "__" << id << "__" << cycle << "__";
+			useTable.push_back(make_pair(id, cycle));
+		}
+	}
+
+
+	void FlopocoStream::addCode(string code, int cycle){
+		flush(cycle);
+		vhdlCode << code;
+	}
+
+
+	bool FlopocoStream::isSignalID(string s){
+		/* the reserved words, as matched by the lexer: all lower case or all upper case */
+		static const char* reservedWords[] = {
+			"abs", "access", "after", "alias", "all", "and", "architecture", "array", "assert", "attribute",
+			"begin", "block", "body", "buffer", "bus", "case", "component", "configuration", "constant",
+			"disconnect", "downto", "else", "elsif", "end", "entity", "exit", "file", "for", "function",
+			"generate", "generic", "guarded", "if", "in", "inout", "is", "label", "library", "linkage",
+			"loop", "map", "mod", "nand", "new", "next", "nor", "not", "null", "of", "on", "open", "or",
+			"others", "out", "package", "port", "procedure", "process", "range", "record", "register",
+			"rem", "report", "return", "select", "severity", "signal", "subtype", "then", "to", "transport",
+			"type", "units", "until", "use", "variable", "wait", "when", "while", "with", "xor"};
+
+		/* letter ( [_] letter_or_digit )* */
+		if(s.empty() || !isalpha(s[0]))
+			return false;
+		for(size_t i=1; i<s.size(); i++){
+			if(s[i] == '_'){
+				if(i+1 == s.size() || !isalnum(s[i+1]))
+					return false;
+			}else if(!isalnum(s[i]))
+				return false;
+		}
+
+		string lower = to_lowercase(s);
+		string upper = s;
+		for(size_t i=0; i<upper.size(); i++)
+			upper[i] = toupper(upper[i]);
+		if((s != lower) && (s != upper))
+			return true;
+		for(size_t i=0; i<sizeof(reservedWords)/sizeof(reservedWords[0]); i++){
+			if(lower == reservedWords[i])
+				return false;
+		}
+		return true;
+	}
+
+
 	void FlopocoStream::setSecondLevelCode(string code){
 		vhdlCode.str("");
 		vhdlCode << code;
@@ -152,4 +211,11 @@ namespace flopoco{
 	bool FlopocoStream::isEmpty(){
 		return ((vhdlCode.str()).length() == 0 && (vhdlCodeBuffer.str()).length() == 0 );
 	}
+
+	void FlopocoStream::release(){
+		/* swap with empty objects, so that the memory is actually given back */
+		ostringstream().swap(vhdlCode);
+		ostringstream().swap(vhdlCodeBuffer);
+		vector<pair<string, int> >().swap(useTable);
+	}
 }
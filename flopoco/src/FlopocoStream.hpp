@@ -123,6 +123,31 @@ namespace flopoco{
 			
 			void setCycle(int cycle);
 
+			/**
+			 * Structured emission, bypassing the lexer: appends the ID of a signal
+			 * used at the given cycle, annotated and recorded in the useTable
+			 * exactly as the lexer would have done.
+			 * The free-form code still in the buffer is flushed (lexed) first.
+			 * @param[in] id    the signal ID
+			 * @param[in] cycle the cycle at which the signal is used
+			 */
+			void addUse(string id, int cycle);
+
+			/**
+			 * Structured emission, bypassing the lexer: appends code that contains
+			 * no signal ID (operators, literals, comments, end of lines).
+			 * The free-form code still in the buffer is flushed (lexed) first.
+			 * @param[in] code  the code
+			 * @param[in] cycle the current cycle, used to flush the buffer
+			 */
+			void addCode(string code, int cycle);
+
+			/**
+			 * Returns true if the lexer would annotate s as a single signal ID,
+			 * i.e. if s is a VHDL basic identifier that is not a reserved word
+			 */
+			static bool isSignalID(string s);
+
 			/**
 			 * member function used to set the code resulted after a second parsing
 			 * was perfromed
@@ -142,6 +167,12 @@ namespace flopoco{
 			
 			bool isEmpty();
 
+			/**
+			 * Frees the code and the useTable, once the VHDL of the operator
+			 * has been written out
+			 */
+			void release();
+
 
 			ostringstream vhdlCode;              /**< the vhdl code afte */
 			ostringstream vhdlCodeBuffer;        /**< the vhdl code buffer */
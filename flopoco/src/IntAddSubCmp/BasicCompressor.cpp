@@ -98,6 +98,24 @@ namespace flopoco{
 	BasicCompressor::~BasicCompressor(){
 	}
 
+
+	map<pair<Target*, vector<int> >, BasicCompressor*> BasicCompressor::registry;
+	mutex BasicCompressor::registryMutex;
+
+	BasicCompressor* BasicCompressor::getCompressor(Target * target, vector<int> h)
+	{
+		lock_guard<mutex> lock(registryMutex);
+		pair<Target*, vector<int> > key = make_pair(target, h);
+		map<pair<Target*, vector<int> >, BasicCompressor*>::iterator it = registry.find(key);
+
+		if(it != registry.end())
+			return it->second;
+
+		BasicCompressor* bc = new BasicCompressor(target, h);
+		registry[key] = bc;
+		return bc;
+	}
+
 	unsigned BasicCompressor::getColumnSize(int column)
 	{
 		if (column>=(signed)height.size())
@@ -8,6 +8,8 @@
 #include "gmp.h"
 #include "mpfr.h"
 #include <vector>
+#include <map>
+#include <mutex>
 #include <gmpxx.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -31,6 +33,13 @@ namespace flopoco
 		/** constructor **/
 		BasicCompressor(Target * target, vector<int> h);
 
+		/**
+		 * Returns the compressor of heights h for the given target, building it on the first request.
+		 * The compressors are shared by all the bit heaps of the design, so that each
+		 * of them is generated only once, however many bit heaps use it.
+		 */
+		static BasicCompressor* getCompressor(Target * target, vector<int> h);
+
 
 		/** destructor**/
 		~BasicCompressor();
@@ -48,6 +57,10 @@ namespace flopoco
 		static OperatorPtr parseArguments(Target *target ,const vector<string> &args);
 
 		static void registerFactory();
+
+	private:
+		static map<pair<Target*, vector<int> >, BasicCompressor*> registry; /**< the compressors already built, by target and heights */
+		static mutex registryMutex;                                          /**< protects the registry, for bit heaps built concurrently */
 	};
 }
 
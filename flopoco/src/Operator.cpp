@@ -15,9 +15,11 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <iomanip>
 #include <cstdlib>
 #include "Operator.hpp"  // Useful only for reporting. TODO split out the REPORT and THROWERROR #defines from Operator to another include.
 #include "utils.hpp"
+#include "profiler.h"
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/variate_generator.hpp>
 #include <boost/random/normal_distribution.hpp>
@@ -29,10 +31,11 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 
 	// global variables used through most of FloPoCo,
 	// to be encapsulated in something, someday?
-	int Operator::uid = 0; //init of the uid static member of Operator
+	std::atomic<int> Operator::uid(0); //init of the uid static member of Operator
 	int verbose=0;
 
 	Operator::Operator(Target* target, map<string, double> inputDelays){
+		Profiler::instance().count("operators_built");
 		stdLibType_                 = 0; // unfortunately this is the historical default.
 		target_                     = target;
 		numberOfInputs_             = 0;
@@ -42,6 +45,7 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 		hasRegistersWithSyncReset_  = false;
 		hasClockEnable_             = false;
 		pipelineDepth_              = 0;
+		initiationInterval_         = 1;
 		currentCycle_               = 0;
 		criticalPath_               = 0;
 		needRecirculationSignal_    = false;
@@ -94,6 +98,8 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 
 	void Operator::addSubComponent(OperatorPtr op) {
 		subComponents_.push_back(op);
+		// op is complete: in streaming mode, it goes to the output file right now
+		UserInterface::outputFinishedOperator(op);
 		// In newPipeline, we deprecate this function and replace it with the following message.
 		// REPORT(INFO, "addSubComponent() is deprecated, instance() does it automatically. Remove it from the source code to get rid of this annoying message.");
 	}
@@ -363,31 +369,29 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 			}
 		}
 
-		ostringstream e;
-		if(signalMap_.find(name) ==  signalMap_.end()) {
+		unordered_map<string, Signal*>::iterator it = signalMap_.find(name);
+		if(it ==  signalMap_.end()) {
+			ostringstream e;
 			e << srcFileName << " (" << uniqueName_ << "): ERROR in getDelayedSignalByName, signal " << name<< " not declared";
 			throw e.str();
 		}
-		return signalMap_[name];
+		return it->second;
 	}
 
 
 
 	Signal * Operator::getSignalByName(string name) {
-		ostringstream e;
-		if(signalMap_.find(name) ==  signalMap_.end()) {
+		unordered_map<string, Signal*>::iterator it = signalMap_.find(name);
+		if(it ==  signalMap_.end()) {
+			ostringstream e;
 			e << srcFileName << " (" << uniqueName_ << "): ERROR in getSignalByName, signal " << name<< " not declared";
 			throw e.str();
 		}
-		return signalMap_[name];
+		return it->second;
 	}
 
 	bool Operator::isSignalDeclared(string name){
-		ostringstream e;
-		if(signalMap_.find(name) ==  signalMap_.end()) {
-			return false;
-		}
-		return true;
+		return (signalMap_.find(name) !=  signalMap_.end());
 	}
 
 
@@ -444,8 +448,7 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 	}
 
 	int Operator::getNewUId(){
-		Operator::uid++;
-		return Operator::uid;
+		return ++Operator::uid;
 	}
 
 	int Operator::getIOListSize() const{
@@ -670,6 +673,14 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 		pipelineDepth_ = d;
 	}
 
+	int Operator::getInitiationInterval() {
+		return initiationInterval_;
+	}
+
+	void Operator::setInitiationInterval(int ii) {
+		initiationInterval_ = ii;
+	}
+
 	void Operator::outputFinalReport(ostream&s, int level) {
 		if (getIndirectOperator()!=NULL){ // interface operator
 			if(getSubComponents().size()!=1){
@@ -702,7 +713,62 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 				s << ctabs.str() << tab << "Pipeline depth = " << getPipelineDepth() << endl;
 			else
 				s << ctabs.str() << tab << "Not pipelined"<< endl;
+			if(this->getInitiationInterval()!=1)
+				s << ctabs.str() << tab << "Initiation interval = " << getInitiationInterval() << endl;
+		}
+	}
+
+
+	double Operator::estimatePipelineRegisters() {
+		double ff = 0;
+		for(auto s: signalList_)
+			ff += (double)s->width() * s->getLifeSpan();
+		return ff;
+	}
+
+
+	ResourceEstimate Operator::estimateOwnResources() {
+		ResourceEstimate r;
+		r.ff = estimatePipelineRegisters();
+		for(auto s: signalList_) {
+			if(s->type() == Signal::wire)
+				r.lut += s->width();
+			if(s->getDelay() > r.criticalPath)
+				r.criticalPath = s->getDelay();
 		}
+		return r;
+	}
+
+
+	ResourceEstimate Operator::estimateResources(ostream& s, int level) {
+		ResourceEstimate own, total;
+		ostringstream subReports;
+
+		if (getIndirectOperator()!=NULL) // interface operator
+			return getSubComponents()[0]->estimateResources(s, level);
+
+		own = estimateOwnResources();
+		total = own;
+		for (auto i: getSubComponents()) {
+			// the sub-components added but never instantiated are counted once
+			int count = (instanceCount_[i] > 0 ? instanceCount_[i] : 1);
+			ResourceEstimate sub = i->estimateResources(subReports, level+1);
+			for (int k=0; k<count; k++)
+				total += sub;
+		}
+
+		ostringstream tabs;
+		for (int i=0; i<level; i++)
+			tabs << "|" << tab;
+		streamsize precision = s.precision();
+		s << tabs.str() << "Entity " << uniqueName_ << fixed << setprecision(0)
+			<< ": LUT=" << total.lut << " FF=" << total.ff << " DSP=" << total.dsp << " BRAM=" << total.bram
+			<< " (own LUT=" << own.lut << " FF=" << own.ff << ")"
+			<< setprecision(3) << ", critical path=" << total.criticalPath*1e9 << " ns" << endl;
+		s.unsetf(ios::floatfield);
+		s.precision(precision);
+		s << subReports.str();
+		return total;
 	}
 
 
@@ -1158,6 +1224,86 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 
 	#endif
 
+
+	void Operator::emitUse(string name) {
+		vhdl.addUse(name, currentCycle_);
+	}
+
+
+	void Operator::emitCode(string code) {
+		vhdl.addCode(code, currentCycle_);
+	}
+
+
+	void Operator::emitAssignment(string lhs, string rhs, string comment) {
+		// split rhs into signal IDs (true) and code the lexer would leave untouched (false)
+		vector<pair<bool, string> > tokens;
+		bool structured = FlopocoStream::isSignalID(lhs) && (comment.find('\n') == string::npos);
+		size_t i = 0;
+
+		while(structured && (i < rhs.size())) {
+			char c = rhs[i];
+			if(isalpha(c)) {
+				size_t j = i+1;
+				while(j < rhs.size()) {
+					if(isalnum(rhs[j]))
+						j++;
+					else if((rhs[j] == '_') && (j+1 < rhs.size()) && isalnum(rhs[j+1]))
+						j += 2;
+					else
+						break;
+				}
+				string id = rhs.substr(i, j-i);
+				// reserved words (such as not) are not signals
+				tokens.push_back(make_pair(FlopocoStream::isSignalID(id), id));
+				i = j;
+			}
+			else if(isdigit(c)) {
+				size_t j = i+1;
+				while((j < rhs.size()) && isdigit(rhs[j]))
+					j++;
+				// leave the other literals (based, real, with exponent) to the lexer
+				if((j < rhs.size()) && (isalpha(rhs[j]) || rhs[j] == '_' || rhs[j] == '.' || rhs[j] == '#' || rhs[j] == ':'))
+					structured = false;
+				tokens.push_back(make_pair(false, rhs.substr(i, j-i)));
+				i = j;
+			}
+			else if((c == '\'') && (i+2 < rhs.size()) && (rhs[i+2] == '\'') && (rhs[i+1] == '0' || rhs[i+1] == '1')) {
+				tokens.push_back(make_pair(false, rhs.substr(i, 3)));
+				i += 3;
+			}
+			else if((c == ' ') || (c == '&') || (c == '(') || (c == ')') || (c == ',')) {
+				tokens.push_back(make_pair(false, rhs.substr(i, 1)));
+				i++;
+			}
+			else
+				structured = false;
+		}
+
+		if(!structured) {
+			// free-form code, left to the lexer
+			vhdl << tab << lhs << " <= " << rhs << ";";
+			if(comment.size())
+				vhdl << " -- " << comment;
+			vhdl << endl;
+			return;
+		}
+
+		emitCode(tab);
+		emitUse(lhs);
+		emitCode(" <= ");
+		for(size_t k=0; k<tokens.size(); k++) {
+			if(tokens[k].first)
+				emitUse(tokens[k].second);
+			else
+				emitCode(tokens[k].second);
+		}
+		emitCode(";");
+		if(comment.size())
+			emitCode(" -- " + comment);
+		emitCode("\n");
+	}
+
 	void Operator::outPortMap(Operator* op, string componentPortName, string actualSignalName, bool newSignal){
 		Signal* formal;
 		Signal* s;
@@ -1284,6 +1430,7 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 
 	string Operator::instance(Operator* op, string instanceName){
 		ostringstream o;
+		instanceCount_[op]++;
 		// TODO add checks here? Check that all the signals are covered for instance
 
 		o << tab << instanceName << ": " << op->getName();
@@ -1712,7 +1859,7 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 		return outDelayMap;
 	}
 
-	map<string, int> Operator::getDeclareTable(){
+	unordered_map<string, int>& Operator::getDeclareTable(){
 		return declareTable;
 	}
 
@@ -1739,15 +1886,22 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 	}
 
 	void Operator::parse2(){
+		ProfileScope profile("parse2");
 		REPORT(DEBUG, "Starting second-level parsing for operator "<<srcFileName);
 		vector<pair<string,int> >:: iterator iterUse;
-		map<string, int>::iterator iterDeclare;
+		unordered_map<string, int>::iterator iterDeclare;
 
 		string name;
 		int declareCycle, useCycle;
 
 		string str (vhdl.str());
 
+		/* the replacement of each annotated ID __name__cycle__; the first one wins,
+		   as if the replacements were applied one after the other */
+		map<string, string> replacements;
+		/* the declared names by their lower case version, built on the first undeclared use */
+		unordered_map<string, string> lowercaseDeclared;
+
 		/* parse the useTable and check that the declarations are ok */
 		for (iterUse = (vhdl.useTable).begin(); iterUse!=(vhdl.useTable).end();++iterUse){
 			name     = (*iterUse).first;
@@ -1761,9 +1915,9 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 			string searchString (tSearch.str());
 
 			iterDeclare = declareTable.find(name);
-			declareCycle = iterDeclare->second;
 
 			if (iterDeclare != declareTable.end()){
+				declareCycle = iterDeclare->second;
 				tReplace << use(name, useCycle - declareCycle);
 				replaceString = tReplace.str();
 				if (useCycle<declareCycle){
@@ -1778,18 +1932,18 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 					}
 				}
 			}else{
-				/* parse the declare by hand and check lower/upper case */
-				bool found = false;
-				string tmp;
-				for (iterDeclare = declareTable.begin(); iterDeclare!=declareTable.end();++iterDeclare){
-					tmp = iterDeclare->first;
-					if ( (to_lowercase(tmp)).compare(to_lowercase(name))==0){
-						found = true;
-						break;
-					}
-				}
-
-				if (found == true){
+				/* the check below is the same for all the uses of a name */
+				if(replacements.find(searchString) != replacements.end())
+					continue;
+
+				/* check lower/upper case against the declared names */
+				if (lowercaseDeclared.empty())
+					for (iterDeclare = declareTable.begin(); iterDeclare!=declareTable.end();++iterDeclare)
+						lowercaseDeclared.insert(make_pair(to_lowercase(iterDeclare->first), iterDeclare->first));
+				unordered_map<string, string>::iterator iterLowercase = lowercaseDeclared.find(to_lowercase(name));
+
+				if (iterLowercase != lowercaseDeclared.end()){
+					string tmp = iterLowercase->second;
 					cerr  << srcFileName << " (" << uniqueName_ << "): ERROR: Clash on signal:"<<name<<". Definition used signal name "<<tmp<<". Check signal case!"<<endl;
 					exit(-1);
 				}
@@ -1798,13 +1952,7 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 				replaceString = tReplace.str();
 			}
 
-			if ( searchString != replaceString ){
-				string::size_type pos = 0;
-				while ( (pos = str.find(searchString, pos)) != string::npos ) {
-					str.replace( pos, searchString.size(), replaceString );
-					pos++;
-				}
-			}
+			replacements.insert(make_pair(searchString, replaceString));
 		}
 		for (iterDeclare = declareTable.begin(); iterDeclare!=declareTable.end();++iterDeclare){
 			name = iterDeclare->first;
@@ -1815,20 +1963,31 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 			//			cout << "searching for: " << tSearch.str() << endl;
 			string searchString (tSearch.str());
 
-			ostringstream tReplace;
-			tReplace << name;
-			string replaceString(tReplace.str());
+			replacements.insert(make_pair(searchString, name));
+		}
 
-			if ( searchString != replaceString ){
+		/* apply all the replacements in a single pass over the code,
+		   instead of searching the whole code once per use */
+		ostringstream result;
+		string::size_type pos = 0, start = 0;
+		while ( (pos = str.find("__", pos)) != string::npos ) {
+			string::size_type nameEnd, cycleEnd;
+			map<string, string>::iterator iterReplace = replacements.end();
 
-				string::size_type pos = 0;
-				while ( (pos = str.find(searchString, pos)) != string::npos ) {
-					str.replace( pos, searchString.size(), replaceString );
-					pos++;
-				}
-			}
+			if ( ((nameEnd = str.find("__", pos+2)) != string::npos)
+					&& ((cycleEnd = str.find("__", nameEnd+2)) != string::npos) )
+				iterReplace = replacements.find(str.substr(pos, cycleEnd+2-pos));
+
+			if (iterReplace != replacements.end()){
+				result << str.substr(start, pos-start) << iterReplace->second;
+				pos = cycleEnd+2;
+				start = pos;
+			}else
+				pos++;
 		}
-		vhdl.setSecondLevelCode(str);
+		result << str.substr(start);
+
+		vhdl.setSecondLevelCode(result.str());
 		REPORT(DEBUG, "   ... done second-level parsing for operator "<<srcFileName);
 	}
 
@@ -1927,6 +2086,18 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 		throw std::string("emulate() not implemented for ") + uniqueName_;
 	}
 
+	bool Operator::hasThreadSafeEmulate() {
+		return false;
+	}
+
+	bool Operator::hasBitAccurateModel() {
+		return false;
+	}
+
+	void Operator::simulateBitAccurate(TestCase * tc, map<string, mpz_class>& outputs) {
+		throw std::string("simulateBitAccurate() not implemented for ") + uniqueName_;
+	}
+
 #if 0
 	bool Operator::hasComponent(string s){
 		map<string, Operator*>::iterator theIterator;
@@ -2226,6 +2397,7 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 		numberOfOutputs_ = op->getNumberOfOutputs();
 		isSequential_    = op->isSequential();
 		pipelineDepth_   = op->getPipelineDepth();
+		initiationInterval_ = op->getInitiationInterval();
 		signalMap_ = op->getSignalMap();
 		constants_ = op->getConstants();
 		attributes_ = op->getAttributes();
@@ -2242,6 +2414,7 @@ Copyright © ENS-Lyon, INRIA, CNRS, UCBL,
 		needRecirculationSignal_    = op->getNeedRecirculationSignal();
 		indirectOperator_           = op->getIndirectOperator();
 		hasDelay1Feedbacks_         = op->hasDelay1Feedbacks();
+		instanceCount_              = op->instanceCount_;
 	}
 
 	/**
@@ -7,7 +7,9 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <memory>
+#include <atomic>
 #include <gmpxx.h>
 #include "Target.hpp"
 #include "Signal.hpp"
@@ -36,6 +38,23 @@ namespace flopoco {
 	static const map<string, double> emptyDelayMap;
 	const std::string tab = "   ";
 
+	/** The resources and the delay of a piece of hardware, as estimated from the cost functions of the Target */
+	struct ResourceEstimate {
+		double lut = 0;             /**< LUTs */
+		double ff = 0;              /**< flip-flops */
+		double dsp = 0;             /**< DSP blocks */
+		double bram = 0;            /**< RAM blocks */
+		double criticalPath = 0;    /**< the largest delay between two registers, in seconds */
+
+		/** adds the resources of r, and keeps the largest critical path */
+		ResourceEstimate& operator+=(const ResourceEstimate& r) {
+			lut += r.lut; ff += r.ff; dsp += r.dsp; bram += r.bram;
+			if(r.criticalPath > criticalPath)
+				criticalPath = r.criticalPath;
+			return *this;
+		}
+	};
+
 	// Reporting levels
 #define LIST 0       // information necessary to the user of FloPoCo
 #define INFO 1       // information useful to the user of FloPoCo
@@ -73,7 +92,7 @@ namespace flopoco {
 class Operator
 {
 
-	static int uid;                  /**< The counter holding a unique id */
+	static std::atomic<int> uid;     /**< The counter holding a unique id, atomic as sub-operators may be built by several threads */
 
 public:
 
@@ -283,7 +302,7 @@ public:
 	 */
 	string getName() const;
 
-	/** produces a new unique identifier */
+	/** produces a new unique identifier (thread-safe) */
 	static int getNewUId();
 
 
@@ -444,6 +463,29 @@ public:
 	string use(string name, int delay);
 #endif
 
+	/** Structured emission of a signal ID in the vhdl stream: the use is
+	 * recorded directly at the current cycle, without running the lexer.
+	 * To be used instead of vhdl << name in the code generated in bulk
+	 * @param name is the name of the signal
+	 */
+	void emitUse(string name);
+
+	/** Structured emission of code that contains no signal ID (operators,
+	 * literals, comments) in the vhdl stream, without running the lexer
+	 * @param code is the code
+	 */
+	void emitCode(string code);
+
+	/** Structured emission of a signal assignment lhs <= rhs; -- comment
+	 * The lhs should be declared beforehand. When rhs is a signal ID, possibly
+	 * followed by an index, a constant bit, or the concatenation of such
+	 * terms with "&", the lexer is bypassed; otherwise rhs is lexed as free-form code
+	 * @param lhs is the name of the assigned signal
+	 * @param rhs is the assigned expression
+	 * @param comment is an optional comment, added at the end of the line
+	 */
+	void emitAssignment(string lhs, string rhs, string comment="");
+
 	/** Declare an output mapping for an instance of a sub-component
 	 * Also declares the local signal implicitely, with width taken from the component
 	 * @param op is a pointer to the subcomponent
@@ -520,6 +562,28 @@ public:
 	 */
 	virtual void emulate(TestCase * tc);
 
+	/**
+	 * Tells whether emulate() and buildRandomTestCase() may be called from several threads at once,
+	 * i.e. whether they do not modify the operator. If so, the file-based TestBench generates its random
+	 * test cases on several threads. The default is false: overload it only after checking the two methods.
+	 */
+	virtual bool hasThreadSafeEmulate();
+
+	/**
+	 * Tells whether simulateBitAccurate() is implemented for this operator. The default is false.
+	 */
+	virtual bool hasBitAccurateModel();
+
+	/**
+	 * Computes in software the outputs that the generated architecture produces for the inputs of tc,
+	 * bit for bit, whereas emulate() computes the set of acceptable outputs.
+	 * Used by CoSimulation to check the architecture against emulate() without an HDL simulator,
+	 * so it must be callable from several threads at once.
+	 * @param tc the test case, filled with the input values
+	 * @param outputs filled with the value of each output, as the unsigned integer of its bits
+	 */
+	virtual void simulateBitAccurate(TestCase * tc, map<string, mpz_class>& outputs);
+
 	/**
 	 * Append standard test cases to a test case list. Standard test
 	 * cases are operator-dependent and should include any specific
@@ -786,6 +850,26 @@ public:
 	*/
 	virtual void outputFinalReport(ostream& s, int level);
 
+	/** Estimates the resources of the logic of this operator, excluding its sub-components, without synthesis.
+	 * By default, the flip-flops are the pipeline registers (the width of each signal times its life span),
+	 * the LUTs are one per bit of each internal signal, and the critical path is the largest delay of a signal.
+	 * Operators that know their architecture should overload it with the cost functions of the Target.
+	 */
+	virtual ResourceEstimate estimateOwnResources();
+
+	/** Hierarchical resource estimation: the resources of this operator, and of each instance of its sub-components.
+	 * @param s the stream where the report is written, one line per operator with its own and total resources
+	 * @param level the depth in the hierarchy, for the indentation of the report
+	 * @return the resources of the whole operator
+	 * The flip-flops are counted from the life spans of the signals: call it once the VHDL has been output.
+	 */
+	ResourceEstimate estimateResources(ostream& s, int level=0);
+
+	/** The resources used by the pipeline registers of this operator (the width of each signal times its life span),
+	 * to be used by the overloads of estimateOwnResources().
+	 * The life spans are only set by the second-level parsing of the VHDL, so call it once the VHDL has been output */
+	double estimatePipelineRegisters();
+
 
 	/** Gets the pipeline depth of this operator
 	 * @return the pipeline depth of the operator
@@ -795,6 +879,15 @@ public:
 	/** Should not be used for operators without memory */
 	void setPipelineDepth(int d);
 
+	/** Gets the initiation interval of this operator, i.e. the number of cycles
+	 * between two consecutive inputs. 1 for fully pipelined or combinatorial circuits
+	 * @return the initiation interval of the operator
+	*/
+	int getInitiationInterval();
+
+	/** Should only be used by operators that reuse their hardware over several cycles (folded architectures) */
+	void setInitiationInterval(int ii);
+
 	/**
 	* @return the output map containing the signal -> delay associations
 	*/
@@ -803,7 +896,7 @@ public:
 	/**
 	* @return the output map containing the signal -> declaration cycle
 	*/
-	map<string, int> getDeclareTable();
+	unordered_map<string, int>& getDeclareTable();
 
 	Target* getTarget(){
 		return target_;
@@ -850,7 +943,7 @@ public:
 		return numberOfOutputs_;
 	}
 
-	map<string, Signal*> getSignalMap(){
+	unordered_map<string, Signal*>& getSignalMap(){
 		return signalMap_;
 	}
 
@@ -1356,6 +1449,7 @@ public:
 	////////////BEWARE: don't add anything below without adding it to cloneOperator, too
 
 	vector<OperatorPtr> subComponents_;						/**< The list of sub-components */
+	map<OperatorPtr, int> instanceCount_;					/**< The number of instances of each sub-component, for the resource estimation */
 	vector<Signal*>     signalList_;      					/**< The list of internal signals of the operator */
 	vector<Signal*>     ioList_;          					/**< The list of I/O signals of the operator */
 
@@ -1390,7 +1484,7 @@ protected:
 	map<string, double> outDelayMap;      					/**< Slack delays on the outputs */
 	map<string, double> inputDelayMap;      				/**< Slack delays on the inputs */
 	string              srcFileName;      					/**< Used to debug and report.  */
-	map<string, int>    declareTable;     					/**< Table containing the name and declaration cycle of the signal */
+	unordered_map<string, int>    declareTable;     			/**< Table containing the name and declaration cycle of the signal (hashed: looked up for each use) */
 	int                 myuid;              				/**<unique id>*/
 	int                 cost;             					/**< the cost of the operator depending on different metrics */
 
@@ -1404,7 +1498,8 @@ private:
 	int                    numberOfOutputs_;            	/**< The number of outputs of the operator */
 	bool                   isSequential_;               	/**< True if the operator needs a clock signal*/
 	int                    pipelineDepth_;              	/**< The pipeline depth of the operator. 0 for combinatorial circuits */
-	map<string, Signal*>   signalMap_;                  	/**< A container of tuples for recovering the signal based on it's name */
+	int                    initiationInterval_;         	/**< The number of cycles between two consecutive inputs. 1 for fully pipelined circuits */
+	unordered_map<string, Signal*>   signalMap_;        	/**< A container of tuples for recovering the signal based on it's name (hashed: looked up in the inner loops of the generation) */
 	map<string, pair<string, string> > constants_;      	/**< The list of constants of the operator: name, <type, value> */
 	map<string, string>    attributes_;                  	/**< The list of attribute declarations (name, type) */
 	map<string, string>    types_;                      	/**< The list of type declarations (name, type) */
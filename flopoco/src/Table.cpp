@@ -318,4 +318,17 @@ namespace flopoco{
 		return wOut*int(intpow2(wIn-getTarget()->lutInputs()));
 	}
 
+	ResourceEstimate Table::estimateOwnResources() {
+		ResourceEstimate r = Operator::estimateOwnResources();
+		if(logicTable) {
+			// size_in_LUTs() rounds the small tables down to 0
+			r.lut = wOut * ceil(intpow2(wIn-getTarget()->lutInputs()));
+		}
+		else {
+			r.lut = 0;
+			r.bram = ceil((double)(maxIn-minIn+1) / getTarget()->wordsPerBlock(wOut));
+		}
+		return r;
+	}
+
 }
@@ -120,6 +120,9 @@ namespace flopoco{
 
 		/** A function that returns an estimation of the size of the table in LUTs. Your mileage may vary thanks to boolean optimization */
 		int size_in_LUTs();
+
+		/** The LUTs of a logic table (at least one per output bit), or the RAM blocks of a BRAM-based one */
+		ResourceEstimate estimateOwnResources();
 	private:
 		bool full; /**< true if there is no "don't care" inputs, i.e. minIn=0 and maxIn=2^wIn-1 */
 		bool logicTable; /**<  true: LUT-based table; false: BRAM-based */
@@ -0,0 +1,214 @@
+/*
+  A software co-simulation of the architecture of an operator against its emulate() method.
+
+  This file is part of the FloPoCo project
+
+  Initial software.
+  All rights reserved.
+
+ */
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <gmpxx.h>
+#include "utils.hpp"
+#include "Operator.hpp"
+#include "CoSimulation.hpp"
+#include "UserInterface.hpp"
+#include "profiler.h"
+
+using namespace std;
+
+namespace flopoco{
+
+	CoSimulation::CoSimulation(Operator* op, int n):
+		op_(op), n_(n)
+	{
+		srcFileName = "CoSimulation";
+		uniqueName_ = "CoSimulation_" + op_->getName();
+
+		if(!op_->hasBitAccurateModel())
+			THROWERROR("operator " << op_->getName() << " has no bit-accurate model (see Operator::simulateBitAccurate)");
+
+		// the same test cases as the TestBench
+		op_->numberOfTests = n;
+		FloPoCoRandomState::init(n);
+		op_->buildStandardTestCases(&tcl_);
+		op_->buildRandomTestCaseList(&tcl_, n);
+	}
+
+
+	CoSimulation::~CoSimulation() {
+		for (int i = 0; i < tcl_.getNumberOfTestCases(); i++)
+			delete tcl_.getTestCase(i);
+	}
+
+
+	int CoSimulation::run(int nbThreads) {
+		ProfileScope profile("co-simulation");
+		int nbTests = tcl_.getNumberOfTestCases();
+		// at most this number of mismatches are described
+		const int maxReported = 10;
+		if (nbThreads > nbTests)
+			nbThreads = nbTests;
+		if (nbThreads < 1)
+			nbThreads = 1;
+
+		atomic<int> nextTest(0);
+		int mismatches = 0;
+		vector<string> reports;
+		string error;
+		mutex m;
+
+		uncheckedOutputs_.clear();
+		set<string> checkedOutputs;
+
+		auto worker = [&]() {
+			set<string> produced, checked;
+			while (true) {
+				int i = nextTest++;
+				if (i >= nbTests)
+					break;
+				TestCase* tc = tcl_.getTestCase(i);
+				map<string, mpz_class> outputs;
+				bool mismatch = false;
+				string report;
+				try {
+					op_->simulateBitAccurate(tc, outputs);
+				} catch (std::string s) {
+					lock_guard<mutex> lock(m);
+					error = s;
+					nextTest = nbTests;
+					break;
+				} catch (std::exception& e) {
+					// rethrown by run(), as an exception escaping a thread would terminate the program
+					lock_guard<mutex> lock(m);
+					error = e.what();
+					nextTest = nbTests;
+					break;
+				}
+				// the outputs without expected values are not checked, as in the TestBench
+				for (auto& it: outputs) {
+					vector<mpz_class> expected = tc->getExpectedOutputValues(it.first);
+					produced.insert(it.first);
+					if (expected.empty())
+						continue;
+					checked.insert(it.first);
+					bool found = false;
+					for (auto& v: expected)
+						if (v == it.second)
+							found = true;
+					if (!found) {
+						mismatch = true;
+						report += describeMismatch(tc, it.first, it.second);
+					}
+				}
+				if (mismatch) {
+					lock_guard<mutex> lock(m);
+					mismatches++;
+					if ((int)reports.size() < maxReported)
+						reports.push_back(report);
+				}
+			}
+			lock_guard<mutex> lock(m);
+			uncheckedOutputs_.insert(produced.begin(), produced.end());
+			checkedOutputs.insert(checked.begin(), checked.end());
+		};
+
+		REPORT(INFO, "Co-simulating " << op_->getName() << " on " << nbTests << " test cases, with " << nbThreads << " thread(s)");
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		vector<thread> workers;
+		for (int t = 0; t < nbThreads; t++)
+			workers.push_back(thread(worker));
+		for (auto& w: workers)
+			w.join();
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		if (error != "")
+			THROWERROR("Error in the model of the architecture: " << error);
+		for (auto& o: checkedOutputs)
+			uncheckedOutputs_.erase(o);
+
+		for (auto& r: reports)
+			cerr << r;
+		if (mismatches > (int)reports.size())
+			cerr << "... and " << mismatches - reports.size() << " other mismatching test case(s)" << endl;
+		REPORT(INFO, "Co-simulation of " << op_->getName() << ": " << mismatches << " mismatching test case(s) out of " << nbTests
+					 << ", in " << seconds << " s");
+		if (!uncheckedOutputs_.empty())
+			REPORT(INFO, "The outputs " << getUncheckedOutputs() << " of the model have no expected value in any test case: they are not checked");
+		Profiler::instance().count("cosim_test_cases", nbTests);
+		Profiler::instance().count("cosim_mismatches", mismatches);
+		return mismatches;
+	}
+
+
+	int CoSimulation::getNumberOfTestCases() {
+		return tcl_.getNumberOfTestCases();
+	}
+
+
+	string CoSimulation::getUncheckedOutputs() {
+		string names;
+		for (auto& o: uncheckedOutputs_)
+			names += (names == "" ? "" : " ") + o;
+		return names;
+	}
+
+
+	string CoSimulation::describeMismatch(TestCase* tc, string output, mpz_class found) {
+		ostringstream o;
+		o << "Test case " << tc->getId();
+		if (tc->getComment() != "")
+			o << " (" << tc->getComment() << ")";
+		o << ", inputs:";
+		for (int i = 0; i < op_->getIOListSize(); i++) {
+			Signal* s = op_->getIOListSignal(i);
+			if (s->type() == Signal::in)
+				o << " " << s->getName() << "=" << tc->getInputValue(s->getName()).get_str(16);
+		}
+		o << endl << "  incorrect output for " << output << ": model " << found.get_str(16) << ", expected";
+		for (auto& v: tc->getExpectedOutputValues(output))
+			o << " " << v.get_str(16);
+		o << " (hexadecimal)" << endl;
+		return o.str();
+	}
+
+
+	OperatorPtr CoSimulation::parseArguments(Target *target, vector<string> &args) {
+		int n;
+		if(UserInterface::globalOpList.empty()){
+			throw("ERROR: CoSimulation has no operator to check (it should come after the operator it checks)");
+		}
+		UserInterface::parseInt(args, "n", &n);
+		Operator* toCheck = UserInterface::globalOpList.back();
+		CoSimulation cosim(toCheck, n);
+		int mismatches = cosim.run(UserInterface::getNumberOfThreads());
+		if(mismatches > 0) {
+			ostringstream e;
+			e << "CoSimulation: " << mismatches << " test case(s) of " << toCheck->getName() << " failed";
+			throw e.str();
+		}
+		// this factory only checks the preceding operator, it adds none
+		return NULL;
+	}
+
+	void CoSimulation::registerFactory(){
+		UserInterface::add("CoSimulation", // name
+											 "Checks the preceding operator in software, running its test cases through the bit-accurate model of its architecture (no HDL simulator needed). Fails if an output of the model is not accepted by the emulate() method.",
+											 "TestBenches",
+											 "", // categories
+											 "n(int)=1000: number of random tests, after the standard ones;",
+											 "The test cases are the ones of the TestBench. They are run on the threads given by the threads option. Only the operators implementing Operator::simulateBitAccurate() can be co-simulated.",
+											 CoSimulation::parseArguments
+											 ) ;
+
+	}
+
+}
@@ -0,0 +1,67 @@
+#ifndef __COSIMULATION_HPP
+#define __COSIMULATION_HPP
+
+#include <string>
+#include <vector>
+#include <set>
+
+#include "Operator.hpp"
+#include "TestBenches/TestCase.hpp"
+
+/**
+ * Checks an operator without an HDL simulator: the test cases of its TestBench are run through
+ * the software model of its architecture (Operator::simulateBitAccurate()), on several threads,
+ * and the outputs of the model are compared to the values accepted by emulate().
+ */
+
+namespace flopoco{
+
+	class CoSimulation
+	{
+	public:
+		/**
+		 * Builds the test cases: the standard ones, then n random ones, as for the TestBench.
+		 * @param op The operator under test, which must have a bit-accurate model
+		 * @param n Number of random tests
+		 */
+		CoSimulation(Operator *op, int n);
+
+		/** Destructor, frees the test cases */
+		~CoSimulation();
+
+		/**
+		 * Runs all the test cases through the model, and reports the mismatches.
+		 * @param nbThreads the number of threads running the model
+		 * @return the number of test cases for which an output of the model is not accepted by emulate()
+		 */
+		int run(int nbThreads);
+
+		/** @return the number of test cases, standard and random */
+		int getNumberOfTestCases();
+
+		/**
+		 * @return the space-separated names of the outputs of the model that had no expected value in any test case
+		 * of the last run(): they were not checked (e.g. outputs whose expected values emulate() cannot give)
+		 */
+		string getUncheckedOutputs();
+
+		/** Factory method that parses arguments, runs the co-simulation of the preceding operator, and fails on mismatches */
+		static OperatorPtr parseArguments(Target *target , vector<string> &args);
+
+		/** Factory register method */
+		static void registerFactory();
+
+	private:
+		/** The description of a failed test case: its inputs, and the output found by the model vs. the expected ones */
+		string describeMismatch(TestCase* tc, string output, mpz_class found);
+
+		Operator *op_;         /**< The unit under test UUT */
+		int n_;                /**< The number of random tests */
+		TestCaseList tcl_;     /**< Test case list */
+		set<string> uncheckedOutputs_; /**< The outputs of the model never compared during the last run() */
+		string srcFileName;    /**< useful only to enable same kind of reporting as for FloPoCo operators. */
+		string uniqueName_;    /**< useful only to enable same kind of reporting as for FloPoCo operators. */
+	};
+
+}
+#endif
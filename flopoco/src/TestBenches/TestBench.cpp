@@ -18,20 +18,26 @@
 #include <sstream>
 #include <vector>
 #include <set>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <gmp.h>
 #include <mpfr.h>
 #include <gmpxx.h>
 #include "utils.hpp"
 #include "Operator.hpp"
 #include "TestBench.hpp"
+#include "UserInterface.hpp"
+#include "profiler.h"
 
 using namespace std;
 
 namespace flopoco{
 
 
-	TestBench::TestBench(Target* target, Operator* op, int n, bool fromFile):
-		Operator(target), op_(op), n_(n)
+	TestBench::TestBench(Target* target, Operator* op, int n, bool fromFile, bool hexaFile):
+		Operator(target), op_(op), n_(n), hexaFile_(hexaFile)
 	{
 		// This allows the op under test to know how long it is beeing tested.
 		// useful only for testing the long acc, but who knows.
@@ -175,8 +181,9 @@ namespace flopoco{
 		// input reading and forwarding to the operator
 		for(unsigned int i=0; i < inputSignalVector.size(); i++){
 			Signal* s = inputSignalVector[i];
-			vhdl << tab << tab << tab << "read(inline ,V_"<< s->getName() << ");" << endl;
-			vhdl << tab << tab << tab << "read(inline,tmpChar);" << endl; // we consume the character between each inputs
+			vhdl << tab << tab << tab << readValueFromFile(s) << endl;
+			if (!hexaFile_)
+				vhdl << tab << tab << tab << "read(inline,tmpChar);" << endl; // we consume the character between each inputs
 			//support for fixed point
 			/*
 			if ((s->width() == 1) && (!s->isBus()))
@@ -208,7 +215,7 @@ namespace flopoco{
 			IOorderInput.push_back(s->getName());
 		}
 		vhdl << tab << tab << tab << "readline(inputsFile,inline);" << endl;  // it consume output line
-		vhdl << tab << tab << tab << "wait for 10 ns;" << endl; // let 10 ns between each input
+		vhdl << tab << tab << tab << "wait for " << 10*op_->getInitiationInterval() << " ns;" << endl; // let 10 ns between each input, times the initiation interval
 		vhdl << tab << tab << "end loop;" << endl;
 		vhdl << tab << tab << "wait for 10000 ns; -- wait for simulation to finish" << endl; // TODO : tune correctly with pipeline depth
 		vhdl << tab << "end process;" << endl;
@@ -277,7 +284,7 @@ namespace flopoco{
 			vhdl << tab << tab << tab << "if possibilityNumber = 0 then" << endl;
 			vhdl << tab << tab << tab << tab << "localErrorCounter := 0;" << endl;//read(inline,tmpChar);" << endl; // we consume the character between each outputs
 			vhdl << tab << tab << tab << "elsif possibilityNumber = 1 then " << endl;
-			vhdl << tab << tab << tab << tab << "read(inline ,V_"<< s->getName() << ");" << endl;
+			vhdl << tab << tab << tab << tab << readValueFromFile(s) << endl;
 			vhdl << tab << tab << tab << tab << "if ";
 			if (s->isFP()) {
  			vhdl << "not fp_equal(fp"<< s->width() << "'(" << s->getName() << ") ,to_stdlogicvector(V_" <<  s->getName() << "))";
@@ -322,8 +329,9 @@ namespace flopoco{
 
 			vhdl << tab << tab << tab << "else" << endl;
 			vhdl << tab << tab << tab << tab << "for i in possibilityNumber downto 1 loop " << endl;
-			vhdl << tab << tab << tab << tab << tab << "read(inline ,V_"<< s->getName() << ");" << endl;
-			vhdl << tab << tab << tab << tab << tab << "read(inline,tmpChar);" << endl; // we consume the character between each outputs
+			vhdl << tab << tab << tab << tab << tab << readValueFromFile(s) << endl;
+			if (!hexaFile_)
+				vhdl << tab << tab << tab << tab << tab << "read(inline,tmpChar);" << endl; // we consume the character between each outputs
 			if (s->isFP()) {
 				vhdl << tab << tab << tab << tab << tab << "if fp_equal(fp"<< s->width() << "'(" << s->getName() << ") ,to_stdlogicvector(V_" <<  s->getName() << ")) " << "  then localErrorCounter := 1; end if; " << endl;
 			} else if (s->isIEEE()) {
@@ -372,8 +380,8 @@ namespace flopoco{
 			/* adding the IO to the IOorder list */
 			IOorderOutput.push_back(s->getName());
 		};
-		vhdl << tab << tab << tab << " wait for 10 ns; -- wait for pipeline to flush" << endl;
-		currentOutputTime += 10 * (tcl_.getNumberOfTestCases()+n_); // time for simulation
+		vhdl << tab << tab << tab << " wait for " << 10*op_->getInitiationInterval() << " ns; -- wait for pipeline to flush" << endl;
+		currentOutputTime += 10 * op_->getInitiationInterval() * (tcl_.getNumberOfTestCases()+n_); // time for simulation
 		vhdl << tab << tab << tab << "counter := counter + 2;" << endl; // incrementing by 2 because a testcase takes two lines (one for input, one for output)
 		vhdl << tab << tab << "end loop;" << endl;
 		vhdl << tab << tab << "report (integer'image(errorCounter) & \" error(s) encoutered.\");" << endl;
@@ -393,28 +401,17 @@ namespace flopoco{
 			if (!fileOut) cerr << "FloPoCo was not abe to open " << inputFileName << " in order to write down inputs. " << endl;
 			for (int i = 0; i < tcl_.getNumberOfTestCases(); i++)	{
 				TestCase* tc = tcl_.getTestCase(i);
-				if (fileOut) fileOut << tc->generateInputString(IOorderInput,IOorderOutput);
+				if (fileOut) fileOut << tc->generateInputString(IOorderInput,IOorderOutput,hexaFile_);
 			}
 
-			//let's not reinvent the wheel
-			/*
-			// generation on the fly of random test case
-			for (int i = 0; i < n_; i++) {
-				TestCase* tc = op_->buildRandomTestCase(i);
-				if (fileOut) fileOut << tc->generateInputString(IOorderInput,IOorderOutput);
-				delete tc;
-			};
-			*/
-			TestCaseList *tcl = new TestCaseList();
-
-			op_->buildRandomTestCaseList(tcl, n_);
-			for (int i = 0; i < n_; i++) {
-				TestCase* tc = tcl->getTestCase(i);
-				if (fileOut) fileOut << tc->generateInputString(IOorderInput,IOorderOutput);
-				delete tc;
-			};
-			delete tcl;
+			// the random test cases are streamed to the file, chunk by chunk
+			if (fileOut) generateRandomTestsToFile(fileOut, IOorderInput, IOorderOutput);
 
+			// the size of the file is what the simulator has to parse before the first test
+			if (fileOut) {
+				REPORT(INFO, inputFileName << ": " << fileOut.tellp() << " bytes, " << (hexaFile_ ? "hexadecimal" : "binary") << " values");
+				Profiler::instance().count("test_vector_bytes", fileOut.tellp());
+			}
 			// closing input file
 			fileOut.close();
 		};
@@ -450,9 +447,9 @@ namespace flopoco{
 			currentOutputTime = 0;
 			// init
 			currentOutputTime += 10;
-			currentOutputTime += 5 * number;
+			currentOutputTime += 5 * number * op_->getInitiationInterval();
 			currentOutputTime += op_->getPipelineDepth()*10;
-			currentOutputTime += 5 * number;
+			currentOutputTime += 5 * number * op_->getInitiationInterval();
 			simulationTime=currentOutputTime;
 
 
@@ -471,16 +468,117 @@ namespace flopoco{
 					tc->addInput(IOname[i],counters[i]);
 				}
 				op_->emulate(tc);
-				if (fileOut) fileOut << tc->generateInputString(IOorderInput,IOorderOutput);
+				if (fileOut) fileOut << tc->generateInputString(IOorderInput,IOorderOutput,hexaFile_);
 				// incrementation
 				counters[0]++;
 				delete tc;
 			}
+			if (fileOut) {
+				REPORT(INFO, inputFileName << ": " << fileOut.tellp() << " bytes, " << (hexaFile_ ? "hexadecimal" : "binary") << " values");
+				Profiler::instance().count("test_vector_bytes", fileOut.tellp());
+			}
 			fileOut.close();
 		}
 	}
 
 
+	string TestBench::readValueFromFile(Signal* s) {
+		ostringstream o;
+		if (!hexaFile_)
+			o << "read(inline ,V_"<< s->getName() << ");";
+		else if ((s->type() == Signal::out) && (s->width() == 1) && (!s->isBus()))
+			o << "hread_bit(inline, V_"<< s->getName() << ");"; // the variable is a bit, see the declarations
+		else
+			o << "hread_bits(inline, V_"<< s->getName() << ");";
+		return o.str();
+	}
+
+
+	void TestBench::generateRandomTestsToFile(ofstream& fileOut, list<string>& IOorderInput, list<string>& IOorderOutput) {
+		const int chunkSize = 1024;
+		int nbChunks = (n_ + chunkSize - 1) / chunkSize;
+		int nbThreads = (op_->hasThreadSafeEmulate() ? UserInterface::getNumberOfThreads() : 1);
+		if (nbThreads > nbChunks)
+			nbThreads = nbChunks;
+		// at most this number of chunks are generated and not yet written, so that the memory stays bounded
+		int maxPendingChunks = 2 * nbThreads;
+		REPORT(DETAILED, "Generating " << n_ << " random test cases in " << nbChunks << " chunks, on " << nbThreads << " thread(s)");
+
+		map<int, string> pendingChunks;  // the text of the chunks generated but not written yet
+		int nextChunkToWrite = 0;
+		int nextChunkToGenerate = 0;
+		string error;
+		mutex m;
+		condition_variable chunkReady, chunkWritten;
+
+		// Each chunk of test cases is generated with its own random state, seeded from the chunk number:
+		// the file does not depend on the number of threads
+		auto worker = [&]() {
+			gmp_randstate_t chunkState;
+			gmp_randinit_mt(chunkState);
+			FloPoCoRandomState::setThreadState(chunkState);
+			while (true) {
+				int chunk;
+				{
+					unique_lock<mutex> lock(m);
+					chunkWritten.wait(lock, [&]() { return nextChunkToGenerate < nextChunkToWrite + maxPendingChunks || error != ""; });
+					if (nextChunkToGenerate >= nbChunks || error != "")
+						break;
+					chunk = nextChunkToGenerate++;
+				}
+				ostringstream text;
+				try {
+					gmp_randseed_ui(chunkState, FloPoCoRandomState::chunkSeed(chunk));
+					for (int i = chunk*chunkSize; i < n_ && i < (chunk+1)*chunkSize; i++) {
+						TestCase* tc = op_->buildRandomTestCase(i);
+						text << tc->generateInputString(IOorderInput,IOorderOutput,hexaFile_);
+						delete tc;
+					}
+				} catch (std::string s) {
+					lock_guard<mutex> lock(m);
+					error = s;
+					chunkReady.notify_all();
+					chunkWritten.notify_all();
+					break;
+				}
+				lock_guard<mutex> lock(m);
+				pendingChunks[chunk] = text.str();
+				chunkReady.notify_all();
+			}
+			FloPoCoRandomState::setThreadState(NULL);
+			gmp_randclear(chunkState);
+		};
+
+		vector<thread> workers;
+		for (int t = 0; t < nbThreads; t++)
+			workers.push_back(thread(worker));
+
+		// the writer, in the order of the chunks
+		while (nextChunkToWrite < nbChunks) {
+			string text;
+			{
+				unique_lock<mutex> lock(m);
+				chunkReady.wait(lock, [&]() { return pendingChunks.count(nextChunkToWrite) > 0 || error != ""; });
+				if (error != "")
+					break;
+				text.swap(pendingChunks[nextChunkToWrite]);
+				pendingChunks.erase(nextChunkToWrite);
+			}
+			fileOut << text;
+			{
+				lock_guard<mutex> lock(m);
+				nextChunkToWrite++;
+				chunkWritten.notify_all();
+			}
+		}
+
+		for (auto& w: workers)
+			w.join();
+		if (error != "")
+			THROWERROR("Error while generating the random test cases: " << error);
+	}
+
+
 	void TestBench::generateTestInVhdl() {
 		vhdl << tab << "-- Setting the inputs" <<endl;
 		vhdl << tab << "process" <<endl;
@@ -491,7 +589,7 @@ namespace flopoco{
 		vhdl << tab << tab << "rst <= '0';" << endl;
 		for (int i = 0; i < tcl_.getNumberOfTestCases(); i++){
 			vhdl << tcl_.getTestCase(i)->getInputVHDL(tab + tab);
-			vhdl << tab << tab << "wait for 10 ns;" <<endl;
+			vhdl << tab << tab << "wait for " << 10*op_->getInitiationInterval() << " ns;" <<endl;
 		}
 		/* COULD NOT BE USED BECAUSE IT HAS TO BE THE SAME TESTCASE FOR INPUT AND OUTPUT GENERATION
 		// generation on the fly of random test case (VALID only for FPFMA)
@@ -526,8 +624,8 @@ namespace flopoco{
 				vhdl << tab <<  "-- " << tc->getComment() << endl;
 			vhdl << tc->getInputVHDL(tab + tab + "-- input: ");
 			vhdl << tc->getExpectedOutputVHDL(tab + tab);
-			vhdl << tab << tab << "wait for 10 ns;" <<endl;
-			currentOutputTime += 10;
+			vhdl << tab << tab << "wait for " << 10*op_->getInitiationInterval() << " ns;" <<endl;
+			currentOutputTime += 10*op_->getInitiationInterval();
 		}
 		/* SEE REMARK FOR ON THE FLY INPUT GENERATION
                 // generation on the fly of random test case (VALID only for FPFMA)
@@ -681,6 +779,52 @@ namespace flopoco{
 			tab << "end;\n";
 
 
+		if (hexaFile_) {
+			/* Standard textio has no hread for bit_vector before VHDL-2008, and std_logic_textio is not
+			 * standard: the hexadecimal values of test.input are parsed here, one character per 4 bits
+			 */
+			o << endl <<
+				tab << "-- reads from l a value in hexadecimal, after the spaces, and returns its v'length low bits in v\n" <<
+				tab << "procedure hread_bits(l : inout line; v : out bit_vector) is\n" <<
+				tab << tab << "variable c : character;\n" <<
+				tab << tab << "variable nibble : bit_vector(3 downto 0);\n" <<
+				tab << tab << "variable r : bit_vector(4*((v'length+3)/4)-1 downto 0);\n" <<
+				tab << "begin\n" <<
+				tab << tab << "c := ' ';\n" <<
+				tab << tab << "while c = ' ' loop\n" <<
+				tab << tab << tab << "read(l, c);\n" <<
+				tab << tab << "end loop;\n" <<
+				tab << tab << "for i in (v'length+3)/4-1 downto 0 loop\n" <<
+				tab << tab << tab << "if i /= (v'length+3)/4-1 then\n" <<
+				tab << tab << tab << tab << "read(l, c);\n" <<
+				tab << tab << tab << "end if;\n" <<
+				tab << tab << tab << "case c is\n";
+			const char* hexDigits = "0123456789abcdef";
+			for (int d = 0; d < 16; d++) {
+				o << tab << tab << tab << tab << "when '" << hexDigits[d] << "'";
+				if (d >= 10)
+					o << " | '" << (char)toupper(hexDigits[d]) << "'";
+				o << " => nibble := \"";
+				for (int b = 3; b >= 0; b--)
+					o << ((d >> b) & 1);
+				o << "\";\n";
+			}
+			o <<
+				tab << tab << tab << tab << "when others => nibble := \"0000\"; report \"bad hexadecimal digit in test.input\" severity error;\n" <<
+				tab << tab << tab << "end case;\n" <<
+				tab << tab << tab << "r(4*i+3 downto 4*i) := nibble;\n" <<
+				tab << tab << "end loop;\n" <<
+				tab << tab << "v := r(v'length-1 downto 0);\n" <<
+				tab << "end;\n\n" <<
+				tab << "-- reads from l a single bit written as an hexadecimal digit, after the spaces\n" <<
+				tab << "procedure hread_bit(l : inout line; b : out bit) is\n" <<
+				tab << tab << "variable v : bit_vector(0 downto 0);\n" <<
+				tab << "begin\n" <<
+				tab << tab << "hread_bits(l, v);\n" <<
+				tab << tab << "b := v(0);\n" <<
+				tab << "end;\n";
+		}
+
 		/* In VHDL, literals may be incorrectly converted to „std_logic_vector(... to ...)” instead
 		 * of „downto”. So, for each FP output width, create a subtype used for casting.
 		 */
@@ -724,13 +868,15 @@ namespace flopoco{
 	OperatorPtr TestBench::parseArguments(Target *target, vector<string> &args) {
 		int n;
 		bool file;
+		bool hexa;
 		if(UserInterface::globalOpList.empty()){
 			throw("ERROR: TestBench has no operator to wrap (it should come after the operator it wraps)");
 		}
 		UserInterface::parseInt(args, "n", &n);
 		UserInterface::parseBoolean(args, "file", &file);
+		UserInterface::parseBoolean(args, "hexa", &hexa);
 		Operator* toWrap = UserInterface::globalOpList.back();
-		return new TestBench(target, toWrap, n, file);
+		return new TestBench(target, toWrap, n, file, hexa);
 	}
 
 	void TestBench::registerFactory(){
@@ -739,7 +885,8 @@ namespace flopoco{
 											 "TestBenches",
 											 "fixed-point function evaluator; fixed-point", // categories
 											 "n(int)=-2: number of random tests. If n=-2, an exhaustive test is generated (use only for small operators);\
-                        file(bool)=true:Inputs and outputs are stored in file test.input (lower VHDL compilation time). If false, they are stored in the VHDL;",
+                        file(bool)=true:Inputs and outputs are stored in file test.input (lower VHDL compilation time). If false, they are stored in the VHDL;\
+                        hexa(bool)=false:With file=true, the values in test.input are written in hexadecimal rather than binary (about 4 times smaller, faster to load in the simulator);",
 											 "",
 											 TestBench::parseArguments
 											 ) ;
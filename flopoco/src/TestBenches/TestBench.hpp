@@ -16,8 +16,10 @@ namespace flopoco{
 		 * @param target The target architecture
 		 * @param op The operator which is the UUT
 		 * @param n Number of tests
+		 * @param fromFile If true, the test cases are stored in the file test.input instead of the VHDL
+		 * @param hexaFile If true, the values in test.input are written in hexadecimal instead of binary
 		 */
-		TestBench(Target *target, Operator *op, int n, bool fromFile = false);
+		TestBench(Target *target, Operator *op, int n, bool fromFile = false, bool hexaFile = false);
 
 		/** Destructor */
 		~TestBench();
@@ -32,6 +34,16 @@ namespace flopoco{
 		 * increasing the VHDL compilation time
 		 */
 		void generateTestFromFile();
+		/* Writes the n_ random test cases to the file, without building the whole list in memory:
+		 * chunks of test cases are generated on several threads (if the UUT allows it, see
+		 * Operator::hasThreadSafeEmulate()), and written in order as soon as they are ready
+		 */
+		void generateRandomTestsToFile(ofstream& fileOut, list<string>& IOorderInput, list<string>& IOorderOutput);
+
+		/* The VHDL statement that reads the next value of signal s from the line inline of test.input
+		 * into the variable V_s, in the format of the file
+		 */
+		string readValueFromFile(Signal* s);
 
 
 		/* Generating the tests using a the vhdl code to store the IO,
@@ -55,6 +67,7 @@ namespace flopoco{
 		int       n_;   /**< The parameter from the constructor */
 		TestCaseList tcl_; /**< Test case list */
 		int simulationTime; /**< Total simulation time */
+		bool hexaFile_; /**< If true, the values in test.input are in hexadecimal */
 	};
 
 }
@@ -174,6 +174,14 @@ namespace flopoco{
 		outputs[name].push_back(v);
 	}
 
+	vector<mpz_class> TestCase::getExpectedOutputValues(string name)
+	{
+		map<string, vector<mpz_class> >::iterator it = outputs.find(name);
+		if (it == outputs.end())
+			return vector<mpz_class>();
+		return it->second;
+	}
+
 
 	string TestCase::getInputVHDL(string prepend)
 	{
@@ -266,13 +274,13 @@ namespace flopoco{
 		return o.str();
 	}
 
-        std::string TestCase::generateInputString(list<string> IOorderInput, list<string> IOorderOutput) {
+        std::string TestCase::generateInputString(list<string> IOorderInput, list<string> IOorderOutput, bool hexa) {
                 ostringstream o;
                 /* iterate trough input signals */
                 for (list<string>::iterator it = IOorderInput.begin(); it != IOorderInput.end(); it++) {
 			  Signal* s = op_->getSignalByName(*it);
 			  mpz_class v = inputs[*it];
-			  o << s->valueToVHDL(v,false) << " ";
+			  o << (hexa ? s->valueToVHDLHex(v,false) : s->valueToVHDL(v,false)) << " ";
                 }
 		o << "\n";
                 for (list<string>::iterator it = IOorderOutput.begin();it != IOorderOutput.end(); it++) {
@@ -284,7 +292,7 @@ namespace flopoco{
 			for (vector<mpz_class>::iterator it = vs.begin(); it != vs.end(); it++)
 			{
 				mpz_class v = *it;
-				o << s->valueToVHDL(v,false) << " ";
+				o << (hexa ? s->valueToVHDLHex(v,false) : s->valueToVHDL(v,false)) << " ";
 			}
                 }
                 o << endl;
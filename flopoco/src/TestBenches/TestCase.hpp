@@ -102,6 +102,13 @@ namespace flopoco{
 		 */
 		void addExpectedOutput(string s, mpz_class v);
 
+		/**
+		 * The possible values of an output, as added by addExpectedOutput (negative values made positive)
+		 * @param s The name of the output
+		 * @return An empty vector if no value was added
+		 */
+		vector<mpz_class> getExpectedOutputValues(string s);
+
 		/**
 		 * Adds a comment to the output VHDL. "--" are automatically prepended.
 		 * @param c Comment to add.
@@ -141,8 +148,10 @@ namespace flopoco{
 		 * generate a string with each inputs, one by line, and each
 		 * expected outputs, one by line too.
 		 * and the order for outputing these IO is given by IOorder
+		 * If hexa is true, the values are written in hexadecimal (the width of the signal rounded up to
+		 * a multiple of 4 bits) instead of binary
 		 */
-		std::string generateInputString(list<string> IOorderInput, list<string> IOorderOutput);
+		std::string generateInputString(list<string> IOorderInput, list<string> IOorderOutput, bool hexa = false);
 
 		/**
 		 *    Define the test case integer identifiant
@@ -1,9 +1,13 @@
 #include "UserInterface.hpp"
 #include "AutoTest/AutoTest.hpp"
 #include "FloPoCo.hpp"
+#include "profiler.h"
 #include <algorithm>
+#include <thread>
+#include <atomic>
 #include <iostream>
 #include <iomanip>
+#include <sys/resource.h>
 
 
 namespace flopoco
@@ -32,6 +36,8 @@ namespace flopoco
 	bool   UserInterface::plainVHDL;
 	bool   UserInterface::generateFigures;
 	double UserInterface::unusedHardMultThreshold;
+	int    UserInterface::threads;
+	bool   UserInterface::streamVHDL;
 	int    UserInterface::resourceEstimation;
 	bool   UserInterface::floorplanning;
 	bool   UserInterface::reDebug;
@@ -98,6 +104,8 @@ namespace flopoco
 		v.push_back(option_t("clockEnable", values));
 		v.push_back(option_t("plainVHDL", values));
 		v.push_back(option_t("generateFigures", values));
+		v.push_back(option_t("streamVHDL", values));
+		v.push_back(option_t("resourceEstimation", values));
 		v.push_back(option_t("", values));
 
 				//free options, using an empty vector of values 
@@ -106,6 +114,7 @@ namespace flopoco
 		v.push_back(option_t("outputFile", values));
 		v.push_back(option_t("hardMultThreshold", values));
 		v.push_back(option_t("frequency", values));
+		v.push_back(option_t("threads", values));
 		
 				//verbosity level
 		values.clear();
@@ -152,6 +161,9 @@ namespace flopoco
 		parseBoolean(args, "useHardMult", &useHardMult, true);
 		parseFloat(args, "hardMultThreshold", &unusedHardMultThreshold, true); // sticky option
 		parseBoolean(args, "generateFigures", &generateFigures, true);
+		parsePositiveInt(args, "threads", &threads, true); // sticky option
+		parseBoolean(args, "streamVHDL", &streamVHDL, true);
+		parsePositiveInt(args, "resourceEstimation", &resourceEstimation, true);
 		parseBoolean(args, "floorplanning", &floorplanning, true);
 		parseBoolean(args, "reDebug", &reDebug, true ); // resource estimation debug -- hidden and undocumented for now 
 		//	parseBoolean(args, "", &  );
@@ -163,6 +175,11 @@ namespace flopoco
 	vector<pair<string,OperatorFactoryPtr>> UserInterface::factoryList;
 
 	vector<OperatorPtr>  UserInterface::globalOpList;  /**< Level-0 operators. Each of these can have sub-operators */
+	map<string, OperatorPtr>  UserInterface::operatorCache;
+	set<OperatorPtr>  UserInterface::vhdlOutputOps;
+	map<OperatorPtr, string>  UserInterface::vhdlPreparedOps;
+	ofstream  UserInterface::vhdlStream;
+	recursive_mutex  UserInterface::globalStateMutex;
 
 
 	// This should be obsoleted soon. It is there only because random_main needs it
@@ -173,6 +190,7 @@ namespace flopoco
 
 
 	void UserInterface::addToGlobalOpList(OperatorPtr op) {
+		lock_guard<recursive_mutex> lock(globalStateMutex);
 		bool alreadyPresent=false;
 		// We assume all the operators added to GlobalOpList are unpipelined.
 		for (auto i: globalOpList){
@@ -186,8 +204,108 @@ namespace flopoco
 	}
 
 
+	string UserInterface::operatorCacheKey(Target* target, string className, string parameters){
+		ostringstream key;
+		key << className << "(" << parameters << ")_" << target->getID() << "_";
+		if(target->isPipelined())
+			key << "F" << target->frequencyMHz();
+		else
+			key << "comb";
+		return key.str();
+	}
+
+
+	OperatorPtr UserInterface::getCachedOperator(string key){
+		lock_guard<recursive_mutex> lock(globalStateMutex);
+		map<string, OperatorPtr>::iterator it = operatorCache.find(key);
+		if(it == operatorCache.end())
+			return NULL;
+		return it->second;
+	}
+
+
+	void UserInterface::addToOperatorCache(string key, OperatorPtr op){
+		lock_guard<recursive_mutex> lock(globalStateMutex);
+		operatorCache[key] = op;
+	}
+
+
 	void UserInterface::outputVHDLToFile(ofstream& file){
+		ProfileScope profile("vhdl output");
+		streampos start = file.tellp();
+		vhdlPreparedOps.clear();
+		prepareVHDL(globalOpList, getNumberOfThreads());
+		// in streaming mode, the operators already streamed are in the file and their code is gone
+		if(!vhdlStream.is_open())
+			vhdlOutputOps.clear();
 		outputVHDLToFile(globalOpList, file);
+		Profiler::instance().count("vhdl_bytes", file.tellp() - start);
+	}
+
+
+	int UserInterface::getNumberOfThreads(){
+		int nbThreads = threads;
+		if(nbThreads <= 0)
+			nbThreads = thread::hardware_concurrency();
+		if(nbThreads <= 0)
+			nbThreads = 1;
+		return nbThreads;
+	}
+
+
+	void UserInterface::prepareVHDL(vector<OperatorPtr> oplist, int nbThreads){
+		string srcFileName = "Operator.cpp"; // for REPORT
+		// the operators, sub-components first, each one once
+		vector<OperatorPtr> ops;
+		set<OperatorPtr> seen;
+		vector<pair<OperatorPtr, size_t> > stack;
+		for(auto i = oplist.rbegin(); i != oplist.rend(); ++i)
+			stack.push_back(make_pair(*i, 0));
+		while(!stack.empty()) {
+			OperatorPtr op = stack.back().first;
+			size_t next = stack.back().second;
+			if(next == 0 && (seen.count(op) || vhdlOutputOps.count(op))) {
+				stack.pop_back();
+				continue;
+			}
+			seen.insert(op);
+			vector<OperatorPtr> subComponents = op->getSubComponents();
+			if(next < subComponents.size()) {
+				stack.back().second++;
+				stack.push_back(make_pair(subComponents[next], 0));
+			}
+			else {
+				ops.push_back(op);
+				stack.pop_back();
+			}
+		}
+
+		// the second-level parsing of an operator only touches the operator itself
+		vector<string> errors(ops.size());
+		atomic<size_t> nextOp(0);
+		auto worker = [&]() {
+			size_t k;
+			while((k = nextOp++) < ops.size()) {
+				try {
+					ops[k]->getFlopocoVHDLStream()->flush();
+					if (ops[k]->isSequential())
+						ops[k]->parse2();
+				} catch (std::string s) {
+					errors[k] = s;
+				}
+			}
+		};
+
+		REPORT(DETAILED, "prepareVHDL: second-level parsing of " << ops.size() << " operators on " << nbThreads << " threads");
+		vector<thread> workers;
+		for(int t=1; t<nbThreads && t<(int)ops.size(); t++)
+			workers.push_back(thread(worker));
+		worker();
+		for(auto& w: workers)
+			w.join();
+
+		for(size_t k=0; k<ops.size(); k++)
+			vhdlPreparedOps[ops[k]] = errors[k];
 	}
 
 
@@ -195,9 +313,13 @@ namespace flopoco
 	void UserInterface::outputVHDLToFile(vector<OperatorPtr> oplist, ofstream& file){
 		string srcFileName = "Operator.cpp"; // for REPORT
 		for(auto i: oplist) {
+			// a shared operator is a sub-component of several parents
+			if(vhdlOutputOps.count(i))
+				continue;
+			vhdlOutputOps.insert(i);
 			try {
 				REPORT(DETAILED, "outputVHDLToFile for  " << i->getName());
-				REPORT(FULL, "  DECLARE LIST" << printMapContent(i->getDeclareTable()));
+				REPORT(FULL, "  DECLARE LIST" << printMapContent(map<string, int>(i->getDeclareTable().begin(), i->getDeclareTable().end())));
 				REPORT(FULL, "  USE LIST" << printVectorContent(  (i->getFlopocoVHDLStream())->getUseTable()) );
 
 				// check for subcomponents
@@ -205,13 +327,18 @@ namespace flopoco
 					//recursively call to print subcomponent
 					outputVHDLToFile(i->getSubComponents(), file);
 				}
-				i->getFlopocoVHDLStream()->flush();
-
-				/* second parse is only for sequential operators */
-				if (i->isSequential()){
-					REPORT (FULL, "  2nd PASS");
-					i->parse2();
+				map<OperatorPtr, string>::iterator prepared = vhdlPreparedOps.find(i);
+				if (prepared == vhdlPreparedOps.end()){
+					i->getFlopocoVHDLStream()->flush();
+
+					/* second parse is only for sequential operators */
+					if (i->isSequential()){
+						REPORT (FULL, "  2nd PASS");
+						i->parse2();
+					}
 				}
+				else if (!prepared->second.empty())
+					throw prepared->second;
 				i->outputVHDL(file);
 
 			} catch (std::string s) {
@@ -223,6 +350,36 @@ namespace flopoco
 	}
 
 
+	void UserInterface::outputFinishedOperator(OperatorPtr op){
+		if(!streamVHDL)
+			return;
+		string srcFileName = "Operator.cpp"; // for REPORT
+		lock_guard<recursive_mutex> lock(globalStateMutex);
+		if(vhdlOutputOps.count(op))
+			return;
+		// normally already streamed when they were added to op
+		for(auto sub: op->getSubComponents())
+			outputFinishedOperator(sub);
+		if(!vhdlStream.is_open())
+			vhdlStream.open(outputFileName.c_str(), ios::out);
+		vhdlOutputOps.insert(op);
+		ProfileScope profile("vhdl output");
+		streampos start = vhdlStream.tellp();
+		try {
+			REPORT(DETAILED, "outputFinishedOperator: streaming " << op->getName());
+			op->getFlopocoVHDLStream()->flush();
+			if (op->isSequential())
+				op->parse2();
+			op->outputVHDL(vhdlStream);
+		} catch (std::string s) {
+			cerr << "Exception while generating '" << op->getName() << "': " << s <<endl;
+		}
+		Profiler::instance().count("vhdl_bytes", vhdlStream.tellp() - start);
+		// the parent only needs the interface of op from now on
+		op->getFlopocoVHDLStream()->release();
+	}
+
+
 	void UserInterface::setOutputFileName(string _outputFileName){
 		outputFileName = _outputFileName;
 	}
@@ -234,7 +391,23 @@ namespace flopoco
 		for(auto i: globalOpList) {
 			i->outputFinalReport(s, 0);
 		}
+		if(resourceEstimation) {
+			s << endl << "Resource estimation (from the cost functions of the target, without synthesis):" << endl;
+			for(auto i: globalOpList) {
+				if(i->getSrcFileName() != "TestBench")
+					i->estimateResources(s, 0);
+			}
+		}
 		cerr << "Output file: " << outputFileName <<endl;
+		struct rusage usage;
+		if(getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+			long peakKB = usage.ru_maxrss / 1024; // bytes on Mac OS
+#else
+			long peakKB = usage.ru_maxrss; // kilobytes on Linux
+#endif
+			cerr << "Peak memory (RSS): " << peakKB/1024 << " MB" << (streamVHDL ? " (streamed VHDL output)" : "") << endl;
+		}
 		
 		// Messages for testbenches. Only works if you have only one TestBench
 		Operator* op = globalOpList.back();
@@ -296,6 +469,9 @@ namespace flopoco
 		pipeline=true;
 		useHardMult=true;
 		unusedHardMultThreshold=0.7;
+		threads=0;
+		streamVHDL=false;
+		resourceEstimation=0;
 		
 	}
 
@@ -400,7 +576,11 @@ namespace flopoco
 					throw( "Can't find the operator factory for " + opName) ;
 				}
 
-				OperatorPtr op = fp->parseArguments(target, opParams);
+				OperatorPtr op;
+				{
+					ProfileScope profile("operator construction");
+					op = fp->parseArguments(target, opParams);
+				}
 				if(op!=NULL)	{// Some factories don't actually create an operator
 					if(entityName!="") {
 						op->changeName(entityName);
@@ -424,6 +604,12 @@ namespace flopoco
 
 
 	void UserInterface::outputVHDL() {
+		if(vhdlStream.is_open()) {
+			// streaming mode: complete the file with what has not been streamed yet
+			outputVHDLToFile(vhdlStream);
+			vhdlStream.close();
+			return;
+		}
 		ofstream file; 
 		file.open(outputFileName.c_str(), ios::out);
 		outputVHDLToFile(file);
@@ -635,6 +821,9 @@ namespace flopoco
 		s << "  " << COLOR_BOLD << "useHardMult" << COLOR_NORMAL << "=<0|1>:    use hardware multipliers " << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
 		s << "  " << COLOR_BOLD << "hardMultThreshold" << COLOR_NORMAL << "=<float>: unused hard mult threshold (O..1, default 0.7) " << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
 		s << "  " << COLOR_BOLD << "generateFigures" << COLOR_NORMAL << "=<0|1>:generate SVG graphics (default off) " << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL << endl;
+		s << "  " << COLOR_BOLD << "threads" << COLOR_NORMAL << "=<int>:        number of threads used for the generation (default 0: one per core) " << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL << endl;
+		s << "  " << COLOR_BOLD << "streamVHDL" << COLOR_NORMAL << "=<0|1>:     write each sub-operator as soon as it is built, to save memory on large designs (default off) " << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL << endl;
+		s << "  " << COLOR_BOLD << "resourceEstimation" << COLOR_NORMAL << "=<0|1>: report the LUTs, FFs, DSPs, RAM blocks and critical path of each sub-component, estimated without synthesis (default off) " << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL << endl;
 		s << "Sticky options apply to the rest of the command line, unless changed again" <<endl;
 		s <<endl;
 		s <<  COLOR_BOLD << "List of operators with command-line interface"<< COLOR_NORMAL << " (a few more are hidden inside FloPoCo)" <<endl;
@@ -17,6 +17,8 @@ Copyright © INSA-Lyon, ENS-Lyon, INRIA, CNRS, UCBL,
 
 #include "Operator.hpp"
 #include <memory>
+#include <set>
+#include <mutex>
 
 // Operator Factory, based on the one by David Thomas, with a bit of clean up.
 // For typical use, see src/ShiftersEtc/Shifter  or   src/ExpLog/FPExp
@@ -107,12 +109,39 @@ Copyright © INSA-Lyon, ENS-Lyon, INRIA, CNRS, UCBL,
 
 				static void addToGlobalOpList(OperatorPtr op);
 
-		/** generates the code for operators in oplist, and all their subcomponents */
+		/** builds the key under which an operator is cached: the class name and the parameters,
+				completed with the target and its frequency */
+				static string operatorCacheKey(Target* target, string className, string parameters);
+
+		/** returns the operator already built for this key (see operatorCacheKey), or NULL if there is none.
+				Only operators whose architecture depends on their parameters alone (not on the context/timing) should be cached */
+				static OperatorPtr getCachedOperator(string key);
+
+		/** records an operator under a key, so that the later identical requests reuse it */
+				static void addToOperatorCache(string key, OperatorPtr op);
+
+		/** generates the code for operators in oplist, and all their subcomponents.
+				An operator used by several parents is only generated once */
 				static void outputVHDLToFile(vector<OperatorPtr> oplist, ofstream& file);
 
-		/** generates the code for operators in globalOpList, and all their subcomponents */
+		/** generates the code for operators in globalOpList, and all their subcomponents.
+				The second-level parsing of the operators, which is independent from one operator
+				to the other, is performed on several threads (see prepareVHDL); the VHDL is then
+				written in the usual order, so that the output does not depend on the number of threads */
 				static void outputVHDLToFile(ofstream& file);
 
+		/** the number of threads to use for the generation: the threads option, or the number of cores */
+				static int getNumberOfThreads();
+
+		/** flushes the vhdl streams and performs the second-level parsing of the operators in oplist
+				and all their subcomponents, using the given number of threads */
+				static void prepareVHDL(vector<OperatorPtr> oplist, int nbThreads);
+
+		/** in streaming mode (streamVHDL=1), writes the VHDL of a complete operator, and of its sub-components,
+				to the output file at once, then frees its code. Called when the operator is added as a sub-component
+				of its parent, i.e. when its constructor is done. Does nothing in the default mode */
+				static void outputFinishedOperator(OperatorPtr op);
+
 		/** set the name of the output VHDL file */
 		static void setOutputFileName(string outputFileName);
 				
@@ -135,6 +164,11 @@ Copyright © INSA-Lyon, ENS-Lyon, INRIA, CNRS, UCBL,
 
 			public:
 		static vector<OperatorPtr>  globalOpList;  /**< Level-0 operators. Each of these can have sub-operators */
+		static map<string, OperatorPtr>  operatorCache;  /**< The operators shared by the whole design, by key (see operatorCacheKey) */
+		static set<OperatorPtr>  vhdlOutputOps;  /**< The operators whose VHDL is already in the output file */
+		static map<OperatorPtr, string>  vhdlPreparedOps;  /**< The operators already prepared by prepareVHDL, with the error raised, if any */
+		static ofstream  vhdlStream;  /**< The output file in streaming mode, opened by the first operator that is streamed */
+		static recursive_mutex  globalStateMutex;  /**< Protects the global operator list and the operator cache, for operators built concurrently */
 				static int    verbose;
 			private:
 				static string outputFileName;
@@ -147,7 +181,9 @@ Copyright © INSA-Lyon, ENS-Lyon, INRIA, CNRS, UCBL,
 				static bool   plainVHDL;
 				static bool   generateFigures;
 				static double unusedHardMultThreshold;
-				static int    resourceEstimation;
+				static int    threads;  /**< Number of threads used for the generation, 0 for the number of cores */
+				static bool   streamVHDL;  /**< Write the VHDL of each sub-operator as soon as it is complete, and free its code */
+				static int    resourceEstimation;  /**< Report the estimated resources of each sub-component (see Operator::estimateResources) */
 				static bool   floorplanning;
 				static bool   reDebug;
 				static bool   flpDebug;
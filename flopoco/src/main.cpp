@@ -55,9 +55,11 @@ int main(int argc, char* argv[] )
 		GenericSimpleSelectionFunction::registerFactory();
 		GenericComputationUnit::registerFactory();
 		FixEMethodEvaluator::registerFactory();
+		FixEMethodExplorer::registerFactory();
 
 		FixRealKCM::registerFactory();
 		TestBench::registerFactory();
+		CoSimulation::registerFactory();
 		Wrapper::registerFactory();
 
 		TargetModel::registerFactory();
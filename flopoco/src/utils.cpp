@@ -32,15 +32,37 @@ namespace flopoco{
         gmp_randstate_t FloPoCoRandomState::m_state;
 
 		bool FloPoCoRandomState::isInit_ = false;
+		int FloPoCoRandomState::seed_ = 0;
+		thread_local __gmp_randstate_struct* FloPoCoRandomState::threadState_ = NULL;
 
         void FloPoCoRandomState::init(int n, bool force) {
 			// if isInit_ is set, we do not initialize the random state again
 			if (isInit_ && !force) return;
 			gmp_randinit_mt(m_state);
 			gmp_randseed_ui(m_state,n);
+			seed_ = n;
 			isInit_ = true;
         };
 
+        __gmp_randstate_struct* FloPoCoRandomState::getState() {
+			if (threadState_ != NULL)
+				return threadState_;
+			return m_state;
+		}
+
+        void FloPoCoRandomState::setThreadState(__gmp_randstate_struct* state) {
+			threadState_ = state;
+		}
+
+        unsigned long FloPoCoRandomState::chunkSeed(int chunk) {
+			// mix the two values, so that neighbouring chunks get unrelated seeds
+			unsigned long s = (unsigned long)seed_ * 2654435761ul + (unsigned long)chunk;
+			s ^= s >> 16;
+			s *= 2246822519ul;
+			s ^= s >> 13;
+			return s;
+		}
+
         //gmp_randstate_t* FloPoCoRandomState::getState() { return m_state;};
 
 	/** return a string representation of an mpz_class on a given number of bits */
@@ -635,7 +657,7 @@ namespace flopoco{
 	mpz_class getLargeRandom(int n)
 	{
 		mpz_class o;
-		mpz_urandomb(o.get_mpz_t(), FloPoCoRandomState::m_state, n);
+		mpz_urandomb(o.get_mpz_t(), FloPoCoRandomState::getState(), n);
 		return o;
 	}
 
@@ -32,6 +32,10 @@ namespace flopoco{
 				 * 	without a new complete initialization of the random state
 				**/
 				static bool isInit_;
+				/** the seed given to init, from which the seeds of the chunks are derived */
+				static int seed_;
+				/** the state used by the current thread instead of m_state, if not NULL */
+				static thread_local __gmp_randstate_struct* threadState_;
           public:
             /**
              * public value to store currend gmp random state
@@ -46,6 +50,26 @@ namespace flopoco{
 			 * @param force  if set will not consider the isInit_ flag
              */
             static void init(int n, bool force = true);
+
+            /**
+             * the random state to use in the current thread: the one set by
+             * setThreadState(), if any, otherwise the shared state m_state
+             */
+            static __gmp_randstate_struct* getState();
+
+            /**
+             * makes the current thread draw its random numbers from its own state,
+             * so that several threads can generate random test cases reproducibly
+             * @param state the state of the thread, or NULL to go back to the shared state
+             */
+            static void setThreadState(__gmp_randstate_struct* state);
+
+            /**
+             * the seed of the chunk-th chunk of random test cases. It only depends
+             * on the seed given to init and on chunk, not on the thread that
+             * generates the chunk
+             */
+            static unsigned long chunkSeed(int chunk);
         };
 
 	/** Returns under the form of a string of given size, the unsigned binary representation of an integer.
@@ -0,0 +1,41 @@
+#!/bin/bash
+# Times the generation of a large pipelined FixEMethodEvaluator, and counts the lines of the VHDL.
+# Usage: benchEMethodGeneration.sh flopoco_binary [other_flopoco_binary]
+#   with two binaries (e.g. before and after a change), both are timed on the same design,
+#   and the VHDL they produce is compared.
+
+if [ $# -lt 1 ]; then
+	echo "Usage: $0 flopoco_binary [other_flopoco_binary]"
+	exit 1
+fi
+
+degree=${DEGREE:-16}
+lsb=${LSB:--32}
+coeffsP="0.125"
+coeffsQ="1"
+for i in $(seq 1 $degree); do
+	coeffsP=$coeffsP":0.0625"
+	coeffsQ=$coeffsQ":0.03125"
+done
+
+args="target=Virtex6 frequency=400 FixEMethodEvaluator radix=2 maxDigit=1 msbIn=-1 lsbIn=$lsb coeffsP=$coeffsP coeffsQ=$coeffsQ"
+
+run=0
+for flopoco in "$@"; do
+	out=bench_emethod_$run.vhdl
+	echo "== $flopoco $args"
+	start=$(date +%s.%N)
+	$flopoco outputFile=$out $args > /dev/null 2>&1 || { echo "generation failed"; exit 1; }
+	end=$(date +%s.%N)
+	echo "generation time: $(echo "$end - $start" | bc) s"
+	echo "VHDL lines: $(wc -l < $out)"
+	run=$((run+1))
+done
+
+if [ $# -ge 2 ]; then
+	if cmp -s bench_emethod_0.vhdl bench_emethod_1.vhdl; then
+		echo "the two binaries generate identical VHDL"
+	else
+		echo "the two binaries generate different VHDL"
+	fi
+fi
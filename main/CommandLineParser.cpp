@@ -23,6 +23,7 @@ namespace emethod {
 				("help,h", "produce a help message")
 				("help-all", "produce a detailed help message, including hidden options")
 				("configFile,c", value<string>(&configFileName)->default_value("emethodHW.cfg"), "name of the file containing the configuration.")
+				("profile", value<string>(&profileFileName)->default_value(""), "profile the generation; the timers and counters are written to <name>.json, and a Chrome trace to <name>.trace.json")
 				;
 
 			// declare a group of options that will be allowed both on command line and in config file
@@ -64,6 +65,19 @@ namespace emethod {
 				("frequency", value<int>(&frequency)->default_value(400), "set the target frequency of the circuit in MHz")
 				//testbench set by default to 1000
 				("testbench", value<int>(&nbTests)->default_value(1000), "set the number of tests to be generated; set to 0 to disable test generation")
+				//testbenchHexa set by default to false (the test vectors are written in binary)
+				("testbenchHexa", value<bool>(&testbenchHexa)->default_value(false), "write the test vectors of test.input in hexadecimal rather than in binary (smaller file, faster to load in the simulator)")
+				//resourceReport set by default to false
+				("resourceReport", value<bool>(&resourceReport)->default_value(false), "report the LUTs, FFs, DSPs, RAM blocks and critical path of each sub-component, estimated without synthesis")
+				//foldingFactor set by default to 1 (fully unrolled circuit)
+				("foldingFactor", value<int>(&foldingFactor)->default_value(1), "set the number of cycles for which a row of computation units is reused; 1 generates a fully unrolled circuit")
+				//the domain of the approximation set by default to [0, 1/32]
+				("domainLow", value<string>(&domainLowStr)->default_value("0"), "lower bound of the domain of the approximation")
+				("domainHigh", value<string>(&domainHighStr)->default_value("0.03125"), "upper bound of the domain of the approximation")
+				//segmentBits set by default to 0 (a single approximation on the whole domain)
+				("segmentBits", value<int>(&segmentBits)->default_value(0), "split the domain into 2^segmentBits segments, each with its own approximation, with the coefficients stored in a table")
+				//degree set by default to 4, for both the numerator and the denominator
+				("degree", value<int>(&degree)->default_value(4), "degree of the numerator and of the denominator of the rational approximation")
 				;
 
 			//create positional options
@@ -147,6 +161,14 @@ namespace emethod {
 
 				exit(0);
 			}
+
+			// check the options
+			//	the folding factor is passed to the generator as an unsigned number of cycles
+			if(foldingFactor < 1)
+			{
+				cout << "Error: the folding factor must be at least 1, got " << foldingFactor << "!" << endl;
+				exit(1);
+			}
 		}
 		catch(exception& e)
 		{
@@ -174,7 +196,15 @@ namespace emethod {
 				verbosity,
 				isPipelined,
 				frequency,
-				nbTests
+				nbTests,
+				testbenchHexa,
+				resourceReport,
+				foldingFactor,
+				domainLowStr,
+				domainHighStr,
+				segmentBits,
+				degree,
+				profileFileName
 				);
 	}
 
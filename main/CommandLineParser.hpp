@@ -49,6 +49,16 @@ using mpfr::mpreal;
 			bool isPipelined;
 			int frequency;
 			int nbTests;
+			bool testbenchHexa;
+			bool resourceReport;
+			int foldingFactor;
+
+			string domainLowStr;
+			string domainHighStr;
+			int segmentBits;
+			int degree;
+
+			string profileFileName;
 
 			string configFileName;
 			ifstream configFile;
@@ -18,10 +18,20 @@ namespace emethod {
 			int verbosity_,
 			bool isPipelined_,
 			int frequency_,
-			int nbTests_):
+			int nbTests_,
+			bool testbenchHexa_,
+			bool resourceReport_,
+			int foldingFactor_,
+			string domainLowStr_,
+			string domainHighStr_,
+			int segmentBits_,
+			int degree_,
+			string profileFileName_):
 		r(r_), lsbInOut(lsbInOut_), msbInOut(msbInOut_),
 		scaleInput(scaleInput_),
-		verbosity(verbosity_), isPipelined(isPipelined_), frequency(frequency_), nbTests(nbTests_)
+		verbosity(verbosity_), isPipelined(isPipelined_), frequency(frequency_), nbTests(nbTests_),
+		testbenchHexa(testbenchHexa_), resourceReport(resourceReport_), foldingFactor(foldingFactor_), segmentBits(segmentBits_),
+		profileFileName(profileFileName_)
 	{
 		ftokens.clear();
 		ftokens = tokenizer(fStr_).getTokens();
@@ -43,8 +53,8 @@ namespace emethod {
 		xi = mpreal(xiStr_);
 		alpha = mpreal(alphaStr_);
 
-		type = make_pair(4, 4);
-		dom = make_pair(mpreal(0), mpreal(1.0 / 32));
+		type = make_pair(degree_, degree_);
+		dom = make_pair(mpreal(domainLowStr_), mpreal(domainHighStr_));
 		d2 = alpha - max(abs(dom.first), abs(dom.second));
 		d1 = -d2;
 
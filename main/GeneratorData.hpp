@@ -35,7 +35,15 @@ using mpfr::mpreal;
 					int verbosity,
 					bool isPipelined,
 					int frequency,
-					int nbTests);
+					int nbTests,
+					bool testbenchHexa,
+					bool resourceReport,
+					int foldingFactor,
+					string domainLowStr,
+					string domainHighStr,
+					int segmentBits,
+					int degree,
+					string profileFileName);
 			virtual ~GeneratorData();
 
 		public:
@@ -62,6 +70,12 @@ using mpfr::mpreal;
 			bool isPipelined;
 			int frequency;
 			int nbTests;
+			bool testbenchHexa;
+			bool resourceReport;
+			int foldingFactor;
+			int segmentBits;
+
+			string profileFileName;
 
 			vector<string> ftokens;
 			vector<string> wtokens;
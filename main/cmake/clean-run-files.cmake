@@ -2,6 +2,7 @@
 set(run_generated   ${CMAKE_BINARY_DIR}/discCoeffsExample.txt
                     ${CMAKE_BINARY_DIR}/EMethod.vhdl
                     ${CMAKE_BINARY_DIR}/test.input
+                    ${CMAKE_BINARY_DIR}/benchmarks
 )
 
 foreach(file ${run_generated})
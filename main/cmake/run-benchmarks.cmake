@@ -0,0 +1,92 @@
+# Runs emethodHW on a curated set of approximations, and collects the profiles
+# (time of each stage, LP/LLL/eigen-solver counts, approximation error, area estimate)
+# into ${BENCHMARK_DIR}/results.json
+# Usage: cmake -DEMETHODHW=<path to emethodHW> -DBENCHMARK_DIR=<output directory> -P run-benchmarks.cmake
+#   -DBENCHMARK_FILTER=<regex> only runs the cases whose name matches
+
+if(NOT EMETHODHW)
+  message(FATAL_ERROR "run-benchmarks: EMETHODHW is not set")
+endif()
+if(NOT BENCHMARK_DIR)
+  set(BENCHMARK_DIR ${CMAKE_CURRENT_BINARY_DIR}/benchmarks)
+endif()
+
+# name | function (empty for the default one) | other options of emethodHW
+# The inputs are in [0,1], scaled by inputScalingFactor to the domain of the approximation,
+#   which must remain small enough for the E-method to converge (alpha=7/32 by default)
+set(benchmark_cases
+  "exp_r2_d4_w32|exp(x)|--radix=2 --degree=4 --lsbInOut=-32"
+  "exp_r4_d4_w32|exp(x)|--radix=4 --degree=4 --lsbInOut=-32"
+  "exp_r2_d6_w48|exp(x)|--radix=2 --degree=6 --lsbInOut=-48"
+  "exp_r2_d3_w16_small|exp(x)|--radix=2 --degree=3 --lsbInOut=-16 --domainHigh=0.015625 --inputScalingFactor=0.015625"
+  "log1p_r2_d4_w32|log(1 + x)|--radix=2 --degree=4 --lsbInOut=-32"
+  "log1p_r4_d5_w32|log(1 + x)|--radix=4 --degree=5 --lsbInOut=-32"
+  "sqrt_r2_d4_w32|sqrt(1 + x)|--radix=2 --degree=4 --lsbInOut=-32"
+  "sqrt_r8_d4_w24|sqrt(1 + x)|--radix=8 --degree=4 --lsbInOut=-24"
+  "atan_r2_d4_w32|atan(x)|--radix=2 --degree=4 --lsbInOut=-32"
+  "atan_r2_d4_w32_large|atan(x)|--radix=2 --degree=4 --lsbInOut=-32 --domainHigh=0.0625 --inputScalingFactor=0.0625"
+  "recip_r2_d4_w32|1 / (1 + x)|--radix=2 --degree=4 --lsbInOut=-32"
+  "recip_r4_d4_w32|1 / (2 + x)|--radix=4 --degree=4 --lsbInOut=-32"
+  "default_r2_d4_w32||--radix=2 --degree=4 --lsbInOut=-32"
+  "default_r2_d4_w32_seg2||--radix=2 --degree=4 --lsbInOut=-32 --segmentBits=2"
+)
+
+file(MAKE_DIRECTORY ${BENCHMARK_DIR})
+set(results "{\n\"emethodHW\": \"${EMETHODHW}\",\n\"cases\": [")
+set(separator "\n")
+set(failures 0)
+
+foreach(case ${benchmark_cases})
+  string(REGEX MATCH "^([^|]*)\\|([^|]*)\\|(.*)$" fields "${case}")
+  set(name "${CMAKE_MATCH_1}")
+  set(function "${CMAKE_MATCH_2}")
+  set(options "${CMAKE_MATCH_3}")
+
+  if(BENCHMARK_FILTER AND NOT name MATCHES "${BENCHMARK_FILTER}")
+    continue()
+  endif()
+
+  # each case runs in its own directory, since emethodHW writes its files in the current one
+  set(case_dir ${BENCHMARK_DIR}/${name})
+  file(REMOVE_RECURSE ${case_dir})
+  file(MAKE_DIRECTORY ${case_dir})
+
+  # the function may contain spaces: it is a single argument
+  set(args "")
+  if(NOT function STREQUAL "")
+    list(APPEND args "--function=${function}")
+  endif()
+  separate_arguments(other_args UNIX_COMMAND "${options}")
+  list(APPEND args ${other_args} --testbench=100 --profile=profile)
+
+  message(STATUS "benchmark ${name}")
+  string(TIMESTAMP start "%s")
+  execute_process(COMMAND ${EMETHODHW} ${args}
+    WORKING_DIRECTORY ${case_dir}
+    RESULT_VARIABLE status
+    OUTPUT_FILE ${case_dir}/stdout.txt
+    ERROR_FILE ${case_dir}/stderr.txt)
+  string(TIMESTAMP stop "%s")
+  math(EXPR seconds "${stop} - ${start}")
+
+  if(status EQUAL 0 AND EXISTS ${case_dir}/profile.json)
+    file(READ ${case_dir}/profile.json profile)
+    string(STRIP "${profile}" profile)
+  else()
+    message(WARNING "benchmark ${name} failed (${status}), see ${case_dir}")
+    set(profile "null")
+    math(EXPR failures "${failures} + 1")
+  endif()
+
+  string(REPLACE "\"" "\\\"" quoted_options "${case}")
+  set(results "${results}${separator}{\"name\": \"${name}\", \"case\": \"${quoted_options}\", \"status\": \"${status}\", \"wall_s\": ${seconds},\n \"profile\": ${profile}}")
+  set(separator ",\n")
+endforeach()
+
+set(results "${results}\n]\n}\n")
+file(WRITE ${BENCHMARK_DIR}/results.json "${results}")
+message(STATUS "benchmark results written to ${BENCHMARK_DIR}/results.json")
+
+if(failures GREATER 0)
+  message(FATAL_ERROR "${failures} benchmark(s) failed")
+endif()
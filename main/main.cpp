@@ -3,30 +3,11 @@
 using namespace emethod;
 using std::getline;
 
-int main(int argc, char* argv[])
+/**
+ * Read the coefficients of P and Q written by efrac
+ */
+static void readCoefficients(vector<string> &P, vector<string> &Q)
 {
-
-    mpreal::set_default_prec(500);
-    parser = new CommandLineParser();
-    parser->parseCmdLine(argc, argv);
-    genData = parser->populateData();
-
-    QSexactStart();
-    QSexact_set_precision(500);
-    {
-    	vector<mpreal> num;
-    	vector<mpreal> den;
-    	mpreal numScalingFactor;
-
-    	mpreal errorEstimation;
-    	efrac(errorEstimation, num, den, numScalingFactor,
-          genData->f, genData->w, genData->delta, genData->xi,
-          genData->d1, genData->d2, genData->type, genData->dom,
-          genData->scalingFactor);
-
-    }
-    QSexactClear();
-
     ifstream coeffsFile;
     coeffsFile.open("discCoeffsExample.txt", ios::in);
     if(!coeffsFile.is_open())
@@ -48,15 +29,129 @@ int main(int argc, char* argv[])
     for(int i=0; i <= n; i++)
     {
     	std::getline(coeffsFile, line);
-    	coeffsP.push_back(line);
+    	P.push_back(line);
     }
     for(int i=0; i <= m; i++)
     {
     	getline(coeffsFile, line);
-    	coeffsQ.push_back(line);
+    	Q.push_back(line);
     }
 
     coeffsFile.close();
+}
+
+/**
+ * A coarse area estimate of an operator and of its sub-components (each one counted once):
+ * the total width of the signals, and the number of register bits of the pipeline
+ */
+static void estimateArea(Operator* op, set<Operator*> &visited, long &signalBits, long &registerBits)
+{
+    if(!visited.insert(op).second)
+    	return;
+    for(auto s: op->getSignalList())
+    {
+    	signalBits += s->width();
+    	registerBits += (long)s->width() * s->getLifeSpan();
+    }
+    for(auto sub: op->getSubComponents())
+    	estimateArea(sub, visited, signalBits, registerBits);
+}
+
+int main(int argc, char* argv[])
+{
+
+    mpreal::set_default_prec(500);
+    parser = new CommandLineParser();
+    parser->parseCmdLine(argc, argv);
+    genData = parser->populateData();
+    if(!genData->profileFileName.empty())
+    	Profiler::instance().enable();
+
+    int nbSegments = 1 << genData->segmentBits;
+    mpreal segmentWidth = (genData->dom.second - genData->dom.first) / nbSegments;
+    vector<mpreal> numScalingFactors;
+    //the points where the approximation error is the largest, with their segment
+    vector<pair<int, mpreal>> errorArgMaxs;
+
+    QSexactStart();
+    QSexact_set_precision(500);
+    if(genData->segmentBits == 0)
+    {
+    	vector<mpreal> num;
+    	vector<mpreal> den;
+    	mpreal numScalingFactor;
+
+    	mpreal errorEstimation, errorArgMax;
+    	efrac(errorEstimation, num, den, numScalingFactor,
+          genData->f, genData->w, genData->delta, genData->xi,
+          genData->d1, genData->d2, genData->type, genData->dom,
+          genData->scalingFactor, &errorArgMax);
+    	errorArgMaxs.push_back(make_pair(0, errorArgMax));
+    	Profiler::instance().setValue("approximation_error", errorEstimation.toDouble());
+
+    	readCoefficients(coeffsP, coeffsQ);
+    }
+    else
+    {
+    	//each segment is approximated on [0, segmentWidth],
+    	//	the hardware receiving the offset of the input inside the segment
+    	pair<mpreal, mpreal> segmentDom = make_pair(mpreal(0), segmentWidth);
+    	mpreal maxError = 0;
+    	mpreal d2 = genData->alpha - segmentWidth;
+    	mpreal d1 = -d2;
+
+    	for(int j=0; j < nbSegments; j++)
+    	{
+    		vector<mpreal> num;
+    		vector<mpreal> den;
+    		vector<string> P, Q;
+    		mpreal numScalingFactor;
+    		mpreal segmentStart = genData->dom.first + segmentWidth * j;
+
+    		function<mpreal(mpreal)> fSegment = [segmentStart](mpreal t) -> mpreal
+    		{
+    			return genData->f(segmentStart + t);
+    		};
+    		function<mpreal(mpreal)> wSegment = [segmentStart](mpreal t) -> mpreal
+    		{
+    			return genData->w(segmentStart + t);
+    		};
+
+    		mpreal errorEstimation, errorArgMax;
+    		if(!efrac(errorEstimation, num, den, numScalingFactor,
+    				fSegment, wSegment, genData->delta, genData->xi,
+    				d1, d2, genData->type, segmentDom,
+    				genData->scalingFactor, &errorArgMax))
+    			cout << "Warning: the approximation of segment " << j << " does not satisfy the constraints" << endl;
+    		errorArgMaxs.push_back(make_pair(j, errorArgMax));
+    		if(abs(errorEstimation) > maxError)
+    			maxError = abs(errorEstimation);
+
+    		readCoefficients(P, Q);
+    		segmentsCoeffsP.push_back(P);
+    		segmentsCoeffsQ.push_back(Q);
+    		numScalingFactors.push_back(numScalingFactor);
+    	}
+
+    	//all the segments must produce their result with the same scaling
+    	//	so rescale the numerators to the smallest scaling factor
+    	Profiler::instance().setValue("approximation_error", maxError.toDouble());
+    	mpreal minScalingFactor = numScalingFactors[0];
+    	for(int j=1; j < nbSegments; j++)
+    		if(numScalingFactors[j] < minScalingFactor)
+    			minScalingFactor = numScalingFactors[j];
+    	for(int j=0; j < nbSegments; j++)
+    	{
+    		if(numScalingFactors[j] == minScalingFactor)
+    			continue;
+    		for(size_t i=0; i < segmentsCoeffsP[j].size(); i++)
+    		{
+    			mpreal coeff = mpreal(segmentsCoeffsP[j][i]) * minScalingFactor / numScalingFactors[j];
+    			segmentsCoeffsP[j][i] = coeff.toString("%.80RNf");
+    		}
+    	}
+    }
+    QSexactClear();
 
     outputFileName = "EMethod.vhdl";
 
@@ -75,7 +170,29 @@ int main(int argc, char* argv[])
 
     try
     {
-    	op = new FixEMethodEvaluator(target,            //target
+    	ProfileScope profile("operator construction");
+    	if(genData->segmentBits > 0)
+    	{
+    		//the offset inside a segment, as an integer on the input format, is scaled back to [0, segmentWidth]
+    		mpreal segmentScaleFactor = segmentWidth / (mpreal(1) << (genData->msbInOut + 1 - genData->segmentBits));
+
+    		op = new FixEMethodEvaluator(target,            //target
+    							(int)genData->r,                    //radix
+									(int)genData->r-1,                  //maximum digit
+									genData->msbInOut,                  //msbInOut
+									genData->lsbInOut,                  //lsbInOut
+									segmentsCoeffsP,                    //coeffsP, for each segment
+									segmentsCoeffsQ,                    //coeffsQ, for each segment
+									(double)genData->delta,             //delta
+									true,                               //scaleInput
+									(double)segmentScaleFactor,         //inputScaleFactor
+									genData->foldingFactor,             //foldingFactor
+									genData->segmentBits                //segmentBits
+    		);
+    	}
+    	else
+    	{
+    		op = new FixEMethodEvaluator(target,            //target
     							(int)genData->r,                    //radix
 									(int)genData->r-1,                  //maximum digit
 									genData->msbInOut,                  //msbInOut
@@ -84,8 +201,10 @@ int main(int argc, char* argv[])
 									coeffsQ,                            //coeffsQ
 									(double)genData->delta,             //delta
 									genData->scaleInput,                //scaleInput
-									(double)genData->inputScalingFactor //inputScaleFactor
-    	);
+									(double)genData->inputScalingFactor, //inputScaleFactor
+									genData->foldingFactor              //foldingFactor
+    		);
+    	}
     }
     catch(string& e)
     {
@@ -93,11 +212,17 @@ int main(int argc, char* argv[])
     	exit(1);
     }
 
+    //the extrema of the approximation error are among the corner cases of the testbench
+    for(auto& p : errorArgMaxs)
+    	((FixEMethodEvaluator*)op)->addTestPoint(p.second.toDouble(), p.first,
+    			"largest approximation error" + (genData->segmentBits > 0 ? " of segment " + to_string(p.first) : string("")));
+
     if(genData->nbTests > 0)
     {
 		try
 		{
-			tb = new TestBench(target, op, genData->nbTests, true);
+			ProfileScope profile("testbench construction");
+			tb = new TestBench(target, op, genData->nbTests, true, genData->testbenchHexa);
 		}
 		catch(string& e)
 		{
@@ -116,7 +241,36 @@ int main(int argc, char* argv[])
 
     file.close();
 
+    //the life spans of the signals, hence the register bits and the FFs, are only known once the VHDL has been parsed
+    if(Profiler::instance().isEnabled())
+    {
+    	set<Operator*> visited;
+    	long signalBits = 0, registerBits = 0;
+    	estimateArea(op, visited, signalBits, registerBits);
+    	Profiler::instance().setValue("area_signal_bits", signalBits);
+    	Profiler::instance().setValue("area_register_bits", registerBits);
+    	Profiler::instance().setValue("area_operators", visited.size());
+    	Profiler::instance().setValue("pipeline_depth", op->getPipelineDepth());
+
+    	//the estimate from the cost functions of the target, counting each instance of the sub-components
+    	ostringstream resources;
+    	ResourceEstimate estimate = op->estimateResources(resources);
+    	Profiler::instance().setValue("area_lut", estimate.lut);
+    	Profiler::instance().setValue("area_ff", estimate.ff);
+    	Profiler::instance().setValue("area_dsp", estimate.dsp);
+    	Profiler::instance().setValue("area_bram", estimate.bram);
+    	Profiler::instance().setValue("critical_path_ns", estimate.criticalPath*1e9);
+    }
+
+    UserInterface::resourceEstimation = genData->resourceReport;
     UserInterface::finalReport(cerr);
+
+    if(!genData->profileFileName.empty())
+    {
+    	Profiler::instance().writeJSONReport(genData->profileFileName + ".json");
+    	Profiler::instance().writeChromeTrace(genData->profileFileName + ".trace.json");
+    	cerr << "Profile: " << genData->profileFileName << ".json, trace: " << genData->profileFileName << ".trace.json" << endl;
+    }
 }
 
 
@@ -6,9 +6,11 @@
 #include "../efrac/efrac.h"
 #include "../efrac/tokenizer.h"
 #include "../efrac/shuntingyard.h"
+#include "../efrac/profiler.h"
 
 #include <vector>
 #include <string>
+#include <set>
 #include <stdio.h>
 #include "../flopoco/src/FloPoCo.hpp"
 
@@ -28,6 +30,7 @@ using namespace flopoco;
 		CommandLineParser *parser;
 
 		vector<string> coeffsP, coeffsQ;
+		vector<vector<string>> segmentsCoeffsP, segmentsCoeffsQ;
 
 		string outputFileName;
 